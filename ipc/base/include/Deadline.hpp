@@ -0,0 +1,128 @@
+#ifndef IPC_DEADLINE_HPP
+#define IPC_DEADLINE_HPP
+
+#include "IIPCTransport.hpp" // For IPCStatus
+#include <cerrno>            // For errno
+#include <chrono>            // For steady_clock and durations
+#include <poll.h>            // For ppoll
+#include <time.h>            // For timespec and clock_gettime
+
+namespace ipc {
+
+/*!
+ * @brief A point in time after which a timed operation gives up.
+ *
+ * Measured on the monotonic clock. `Deadline::never()` makes the timed code
+ * paths behave like the blocking ones without reading the clock, so blocking
+ * calls can share them at no cost.
+ */
+class Deadline {
+public:
+  /*! @brief The clock deadlines are measured on (CLOCK_MONOTONIC). */
+  using Clock = std::chrono::steady_clock;
+
+  /*!
+   * @brief Creates a deadline `timeout` from now. A zero or negative timeout
+   * is already expired, which turns waits into single attempts. A timeout
+   * too large to add to the current time saturates to `never()`.
+   */
+  explicit Deadline(std::chrono::nanoseconds timeout) : when(Clock::now()) {
+    if (timeout >= Clock::time_point::max() - when)
+      when = Clock::time_point::max();
+    else
+      when += timeout;
+  }
+
+  /*! @brief Returns a deadline that never expires. */
+  static Deadline never() { return Deadline(Clock::time_point::max()); }
+
+  /*! @brief Returns true if this deadline never expires. */
+  bool is_never() const { return when == Clock::time_point::max(); }
+
+  /*! @brief Returns true once the deadline has passed. */
+  bool expired() const { return !is_never() && Clock::now() >= when; }
+
+  /*! @brief Returns the time left, never negative. */
+  std::chrono::nanoseconds remaining() const {
+    if (is_never())
+      return std::chrono::nanoseconds::max();
+    const auto left = when - Clock::now();
+    return left.count() > 0 ? left : std::chrono::nanoseconds::zero();
+  }
+
+  /*!
+   * @brief Returns the time left as a relative timespec, for futex, ppoll
+   * and sigtimedwait. Must not be called on `never()`.
+   */
+  timespec remaining_timespec() const { return to_timespec(remaining()); }
+
+  /*!
+   * @brief Returns the deadline as an absolute CLOCK_MONOTONIC time, for
+   * condition variables using that clock. Must not be called on `never()`.
+   */
+  timespec monotonic_timespec() const {
+    return to_timespec(when.time_since_epoch());
+  }
+
+  /*!
+   * @brief Returns the deadline as an absolute CLOCK_REALTIME time, for
+   * APIs such as `mq_timedreceive()` and default condition variables. Must
+   * not be called on `never()`.
+   */
+  timespec realtime_timespec() const {
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    const auto left = remaining();
+    now.tv_sec += static_cast<time_t>(left.count() / 1000000000);
+    now.tv_nsec += static_cast<long>(left.count() % 1000000000);
+    if (now.tv_nsec >= 1000000000) {
+      now.tv_nsec -= 1000000000;
+      ++now.tv_sec;
+    }
+    return now;
+  }
+
+private:
+  explicit Deadline(Clock::time_point when) : when(when) {}
+
+  static timespec to_timespec(std::chrono::nanoseconds duration) {
+    timespec ts{};
+    ts.tv_sec = static_cast<time_t>(duration.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(duration.count() % 1000000000);
+    return ts;
+  }
+
+  /*! @brief The expiry time. */
+  Clock::time_point when;
+};
+
+/*!
+ * @brief Waits until `fd` reports one of `events` or the deadline passes.
+ *
+ * With `Deadline::never()` it returns immediately, leaving the wait to the
+ * blocking call that follows. Hang-up and error conditions count as ready
+ * so that the following call reports them.
+ *
+ * @return IPCStatus::Ok if ready, IPCStatus::Timeout if the deadline passed,
+ * IPCStatus::Error if polling failed.
+ */
+inline IPCStatus wait_fd(int fd, short events, const Deadline &deadline) {
+  if (deadline.is_never())
+    return IPCStatus::Ok;
+
+  for (;;) {
+    pollfd pfd{fd, events, 0};
+    const timespec timeout = deadline.remaining_timespec();
+    const int ready = ppoll(&pfd, 1, &timeout, nullptr);
+    if (ready > 0)
+      return IPCStatus::Ok;
+    if (ready == 0)
+      return IPCStatus::Timeout;
+    if (errno != EINTR)
+      return IPCStatus::Error;
+  }
+}
+
+} // namespace ipc
+
+#endif // IPC_DEADLINE_HPP
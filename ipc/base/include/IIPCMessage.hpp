@@ -29,6 +29,9 @@ struct IPCMessage {
    */
   char data[256] = {0};
 
+  /*! @brief The Multiplexer channel the message travels on, 0 otherwise. */
+  uint32_t channel = 0;
+
   /*! @brief Default constructor for the IPCMessage structure. */
   IPCMessage() = default;
 };
@@ -2,10 +2,22 @@
 #define IPS_TRANSPORT_HPP
 
 #include "IIPCMessage.hpp"
+#include <chrono>
+#include <cstddef>
 #include <string>
 
 namespace ipc {
 
+/*!
+ * @brief Outcome of a non-blocking or timed transport operation.
+ */
+enum class IPCStatus {
+  Ok,         /*!< The message was sent or received. */
+  WouldBlock, /*!< A `try_*` call could not complete without waiting. */
+  Timeout,    /*!< A `*_for` call could not complete before its timeout. */
+  Error       /*!< The transport failed or is not initialized. */
+};
+
 /*!
  * @brief An abstract interface for inter-process communication (IPC) transport mechanisms.
  *
@@ -54,6 +66,116 @@ public:
    */
   virtual bool receive_message(IPCMessage &msg) = 0;
 
+  /*!
+   * @brief Sends an IPC message, waiting at most `timeout` for room.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok if sent, IPCStatus::Timeout if the transport stayed
+   * full, IPCStatus::Error on failure.
+   */
+  virtual IPCStatus send_for(const IPCMessage &msg,
+                             std::chrono::nanoseconds timeout) = 0;
+
+  /*!
+   * @brief Receives an IPC message, waiting at most `timeout` for one.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok if received, IPCStatus::Timeout if nothing arrived,
+   * IPCStatus::Error on failure.
+   */
+  virtual IPCStatus receive_for(IPCMessage &msg,
+                                std::chrono::nanoseconds timeout) = 0;
+
+  /*!
+   * @brief Sends an IPC message only if that is possible without waiting.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return IPCStatus::Ok if sent, IPCStatus::WouldBlock if the transport is
+   * full, IPCStatus::Error on failure.
+   */
+  virtual IPCStatus try_send(const IPCMessage &msg) {
+    const IPCStatus status = send_for(msg, std::chrono::nanoseconds::zero());
+    return status == IPCStatus::Timeout ? IPCStatus::WouldBlock : status;
+  }
+
+  /*!
+   * @brief Receives an IPC message only if one is available now.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will be stored.
+   * @return IPCStatus::Ok if received, IPCStatus::WouldBlock if nothing is
+   * pending, IPCStatus::Error on failure.
+   */
+  virtual IPCStatus try_receive(IPCMessage &msg) {
+    const IPCStatus status = receive_for(msg, std::chrono::nanoseconds::zero());
+    return status == IPCStatus::Timeout ? IPCStatus::WouldBlock : status;
+  }
+
+  /*!
+   * @brief Sends several IPC messages, in order, with as few system calls as the
+   * transport allows.
+   *
+   * The default implementation calls send_message() for each message.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  virtual size_t send_batch(const IPCMessage *msgs, size_t count) {
+    size_t sent = 0;
+    while (sent < count && send_message(msgs[sent]))
+      ++sent;
+    return sent;
+  }
+
+  /*!
+   * @brief Receives up to `max` IPC messages.
+   *
+   * Waits like receive_message() for the first message, then adds those that
+   * are already available without waiting again. The default implementation
+   * follows receive_message() with try_receive() calls.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  virtual size_t receive_batch(IPCMessage *msgs, size_t max) {
+    if (max == 0 || !receive_message(msgs[0]))
+      return 0;
+    size_t received = 1;
+    while (received < max && try_receive(msgs[received]) == IPCStatus::Ok)
+      ++received;
+    return received;
+  }
+
+  /*!
+   * @brief Writes out any messages the transport is still holding back.
+   *
+   * Only transports that coalesce sends buffer messages; for the others this
+   * does nothing.
+   *
+   * @return True if nothing is left pending, false on failure.
+   */
+  virtual bool flush() { return true; }
+
+  /*!
+   * @brief Returns a descriptor that polls readable when messages arrive, so
+   * the transport can join a poll, select or epoll loop.
+   *
+   * The descriptor is level-triggered only for transports whose messages
+   * live in the kernel (pipes, sockets, message queues). Consumers should
+   * therefore drain with try_receive() until it returns
+   * IPCStatus::WouldBlock and only then poll: a WouldBlock result guarantees
+   * that the descriptor becomes readable when the next message arrives.
+   * Messages already buffered by the transport do not make it readable.
+   * Reading from the descriptor directly is not supported.
+   *
+   * @return The descriptor, owned by the transport, or -1 if the transport
+   * is not initialized or cannot provide one.
+   */
+  virtual int readiness_fd() { return -1; }
+
   /*!
    * @brief Cleans up any resources allocated by the IPC transport.
    *
@@ -0,0 +1,215 @@
+#ifndef IPC_SEND_COALESCER_HPP
+#define IPC_SEND_COALESCER_HPP
+
+#include "IIPCMessage.hpp"
+#include "WireFormat.hpp"     // For the encoded frame sizes
+#include <chrono>             // For the delay budget
+#include <condition_variable> // For waking the flush timer
+#include <cstddef>            // For size_t
+#include <functional>         // For std::function
+#include <mutex>              // For std::mutex
+#include <thread>             // For the flush timer
+#include <utility>            // For std::move
+#include <vector>             // For the pending messages
+
+namespace ipc {
+
+/*!
+ * @brief How long a stream transport may hold back small messages to send
+ * them together.
+ */
+struct CoalescingPolicy {
+  /*!
+   * @brief Pending frame bytes that trigger a flush. Zero disables
+   * coalescing, so every send is written at once.
+   */
+  size_t max_bytes = 0;
+
+  /*!
+   * @brief Longest a message may be held back. Pending messages are written
+   * once the oldest has waited this long, even if no further send comes.
+   * Zero never delays a message, so every send is written at once.
+   */
+  std::chrono::microseconds max_delay{0};
+
+  /*! @brief Returns true if messages are held back at all. */
+  bool enabled() const {
+    return max_bytes > 0 && max_delay > std::chrono::microseconds::zero();
+  }
+};
+
+/*!
+ * @brief Collects outgoing messages until a CoalescingPolicy says they
+ * should go out together.
+ *
+ * Pending messages are handed to the owner's writer, which writes them with
+ * its batch path, i.e. one `writev()` or io_uring submission instead of one
+ * system call per message. A message that reaches the byte threshold is
+ * written by the sending thread. Otherwise a timer thread, started with the
+ * first held back message, writes the pending messages when the oldest has
+ * used up its delay budget, so a producer that goes quiet is not left with
+ * buffered messages. Transports also flush before they receive, so
+ * request/response exchanges never wait on their own buffered request.
+ *
+ * The writer runs with the coalescer's lock held, on either thread. The
+ * owner must therefore `flush()` before writing directly, and must not use
+ * the coalescer from more than one thread of its own.
+ */
+class SendCoalescer {
+public:
+  /*!
+   * @brief Writes `count` messages and returns how many were written.
+   */
+  using Writer = std::function<size_t(const IPCMessage *msgs, size_t count)>;
+
+  /*! @brief Constructs a coalescer that writes through `writer`. */
+  explicit SendCoalescer(Writer writer) : writer(std::move(writer)) {}
+
+  /*! @brief Stops the timer. Pending messages are dropped. */
+  ~SendCoalescer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    due.notify_one();
+    if (timer.joinable())
+      timer.join();
+  }
+
+  SendCoalescer(const SendCoalescer &) = delete;
+  SendCoalescer &operator=(const SendCoalescer &) = delete;
+
+  /*! @brief Replaces the policy. Pending messages stay pending. */
+  void set_policy(const CoalescingPolicy &policy) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      current = policy;
+    }
+    due.notify_one();
+  }
+
+  /*! @brief Returns the current policy. */
+  CoalescingPolicy policy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+  }
+
+  /*! @brief Returns true if the policy holds messages back. */
+  bool enabled() const { return policy().enabled(); }
+
+  /*!
+   * @brief Queues a copy of `msg` and writes the pending messages if they
+   * reached the byte threshold.
+   *
+   * @return False if this or an earlier timed write failed.
+   */
+  bool add(const IPCMessage &msg) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (pending.empty())
+      oldest = Clock::now();
+    pending.push_back(msg);
+    const FrameHeader header = message_frame_header(msg);
+    bytes += frame_header_size(header) + header.length;
+    if (bytes >= current.max_bytes || !current.enabled())
+      return write_pending();
+
+    if (!timer.joinable())
+      timer = std::thread([this] { run_timer(); });
+    else if (pending.size() == 1)
+      due.notify_one();
+    return !timer_failed;
+  }
+
+  /*!
+   * @brief Writes the pending messages now.
+   *
+   * @return False if the write, or an earlier timed write, failed.
+   */
+  bool flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return write_pending();
+  }
+
+  /*! @brief Returns true if no messages are pending. */
+  bool empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.empty();
+  }
+
+  /*! @brief Drops the pending messages and any recorded failure. */
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+    bytes = 0;
+    timer_failed = false;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /*! @brief Writes and drops the pending messages; `mutex` must be held. */
+  bool write_pending() {
+    const bool failed = timer_failed;
+    timer_failed = false;
+    if (pending.empty())
+      return !failed;
+    const size_t count = pending.size();
+    const bool written = writer(pending.data(), count) == count;
+    pending.clear();
+    bytes = 0;
+    return written && !failed;
+  }
+
+  /*! @brief Body of the timer thread. */
+  void run_timer() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+      if (pending.empty()) {
+        due.wait(lock);
+        continue;
+      }
+      const Clock::time_point deadline = oldest + current.max_delay;
+      if (Clock::now() < deadline) {
+        due.wait_until(lock, deadline);
+        continue;
+      }
+      // Reported by the owner's next add() or flush().
+      if (!write_pending())
+        timer_failed = true;
+    }
+  }
+
+  /*! @brief Writes pending messages for the owner. */
+  Writer writer;
+
+  /*! @brief Guards everything below. */
+  mutable std::mutex mutex;
+
+  /*! @brief Wakes the timer when messages become pending or on shutdown. */
+  std::condition_variable due;
+
+  /*! @brief Flushes messages whose delay budget ran out. */
+  std::thread timer;
+
+  /*! @brief The policy in force. */
+  CoalescingPolicy current;
+
+  /*! @brief Messages not written yet. */
+  std::vector<IPCMessage> pending;
+
+  /*! @brief Encoded size of the pending messages. */
+  size_t bytes = 0;
+
+  /*! @brief When the oldest pending message was added. */
+  Clock::time_point oldest;
+
+  /*! @brief Set if a write by the timer failed. */
+  bool timer_failed = false;
+
+  /*! @brief Set by the destructor to stop the timer. */
+  bool stopping = false;
+};
+
+} // namespace ipc
+
+#endif // IPC_SEND_COALESCER_HPP
@@ -0,0 +1,482 @@
+#ifndef IPC_WIRE_FORMAT_HPP
+#define IPC_WIRE_FORMAT_HPP
+
+#include "IIPCMessage.hpp"
+#include <cerrno>      // For errno
+#include <cstddef>     // For size_t
+#include <cstdint>     // For fixed-width integer types
+#include <cstring>     // For memcpy, memset, memmove
+#include <sys/types.h> // For ssize_t
+#include <sys/uio.h>   // For writev
+
+namespace ipc {
+
+/*!
+ * @brief Kinds of frames carried on the wire.
+ */
+enum class FrameType : uint8_t {
+  Message = 1, /*!< An IPCMessage. */
+  Payload = 2, /*!< A byte payload of any size, see PAYLOAD_PREFIX_SIZE. */
+  Reference = 3, /*!< A payload left in shared memory, see
+                    REFERENCE_FRAME_SIZE. */
+};
+
+/*! @brief FrameHeader::flags bit mirroring IPCMessage::ready. */
+constexpr uint8_t FRAME_FLAG_READY = 0x01;
+
+/*! @brief FrameHeader::flags bit mirroring IPCMessage::finished. */
+constexpr uint8_t FRAME_FLAG_FINISHED = 0x02;
+
+/*!
+ * @brief FrameHeader::flags bit set when the header is followed by
+ * FRAME_CHANNEL_SIZE bytes holding IPCMessage::channel.
+ */
+constexpr uint8_t FRAME_FLAG_CHANNEL = 0x04;
+
+/*!
+ * @brief Fixed header preceding every frame on stream and datagram
+ * transports.
+ *
+ * Encoded as 8 little-endian bytes: the payload length (16 bits), the frame
+ * type and flags (8 bits each) and the sequence number (32 bits), which
+ * carries IPCMessage::counter. A non-zero IPCMessage::channel follows as 4
+ * more little-endian bytes, flagged by FRAME_FLAG_CHANNEL, so messages
+ * outside a Multiplexer do not pay for it.
+ */
+struct FrameHeader {
+  /*! @brief Number of payload bytes following the header. */
+  uint16_t length = 0;
+
+  /*! @brief A FrameType value. */
+  uint8_t type = 0;
+
+  /*! @brief FRAME_FLAG_* bits. */
+  uint8_t flags = 0;
+
+  /*! @brief Sequence number, the message counter. */
+  uint32_t sequence = 0;
+
+  /*! @brief Logical channel, only encoded with FRAME_FLAG_CHANNEL. */
+  uint32_t channel = 0;
+};
+
+/*! @brief Encoded size of the fixed part of a FrameHeader in bytes. */
+constexpr size_t FRAME_HEADER_SIZE = 8;
+
+/*! @brief Encoded size of the channel that FRAME_FLAG_CHANNEL adds. */
+constexpr size_t FRAME_CHANNEL_SIZE = 4;
+
+/*! @brief Largest encoded FrameHeader in bytes. */
+constexpr size_t MAX_FRAME_HEADER_SIZE = FRAME_HEADER_SIZE + FRAME_CHANNEL_SIZE;
+
+/*! @brief Largest payload of a message frame. */
+constexpr size_t MAX_FRAME_PAYLOAD = sizeof(IPCMessage::data);
+
+/*! @brief Largest encoded message frame in bytes. */
+constexpr size_t MAX_FRAME_SIZE = MAX_FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD;
+
+/*! @brief Returns the encoded size of `header`, channel included. */
+inline size_t frame_header_size(const FrameHeader &header) {
+  return header.flags & FRAME_FLAG_CHANNEL
+             ? FRAME_HEADER_SIZE + FRAME_CHANNEL_SIZE
+             : FRAME_HEADER_SIZE;
+}
+
+/*!
+ * @brief Encoded size of the prefix of a payload frame: a header with zero
+ * length, followed by the payload size as 8 little-endian bytes. The
+ * payload bytes follow the prefix.
+ */
+constexpr size_t PAYLOAD_PREFIX_SIZE = FRAME_HEADER_SIZE + 8;
+
+/*!
+ * @brief Encoded size of a reference frame: a header with zero length whose
+ * sequence number holds the segment, followed by the payload offset and
+ * size in that segment as 8 little-endian bytes each.
+ */
+constexpr size_t REFERENCE_FRAME_SIZE = FRAME_HEADER_SIZE + 16;
+
+/*!
+ * @brief Returns the number of data bytes worth sending for `msg`: the data
+ * up to and including its last non-zero byte.
+ *
+ * The receiver zero-fills the rest, so trailing zeros need not be sent.
+ */
+inline size_t frame_payload_length(const IPCMessage &msg) {
+  size_t length = sizeof(msg.data);
+  while (length > 0 && msg.data[length - 1] == 0)
+    --length;
+  return length;
+}
+
+/*!
+ * @brief Writes `header` into `out` in wire byte order.
+ *
+ * @param out At least `frame_header_size(header)` bytes.
+ */
+inline void encode_frame_header(const FrameHeader &header, char *out) {
+  unsigned char *bytes = reinterpret_cast<unsigned char *>(out);
+  bytes[0] = static_cast<unsigned char>(header.length);
+  bytes[1] = static_cast<unsigned char>(header.length >> 8);
+  bytes[2] = header.type;
+  bytes[3] = header.flags;
+  for (int i = 0; i < 4; ++i)
+    bytes[4 + i] = static_cast<unsigned char>(header.sequence >> (8 * i));
+  if (header.flags & FRAME_FLAG_CHANNEL)
+    for (int i = 0; i < 4; ++i)
+      bytes[FRAME_HEADER_SIZE + i] =
+          static_cast<unsigned char>(header.channel >> (8 * i));
+}
+
+/*!
+ * @brief Reads the fixed part of a header encoded by
+ * `encode_frame_header()`. The channel, if flagged, is read with the
+ * payload by `decode_frame()`.
+ *
+ * @param in At least FRAME_HEADER_SIZE bytes.
+ */
+inline FrameHeader decode_frame_header(const char *in) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+  FrameHeader header;
+  header.length = static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+  header.type = bytes[2];
+  header.flags = bytes[3];
+  for (int i = 0; i < 4; ++i)
+    header.sequence |= static_cast<uint32_t>(bytes[4 + i]) << (8 * i);
+  return header;
+}
+
+/*! @brief Returns the header of the message frame carrying `msg`. */
+inline FrameHeader message_frame_header(const IPCMessage &msg) {
+  FrameHeader header;
+  header.length = static_cast<uint16_t>(frame_payload_length(msg));
+  header.type = static_cast<uint8_t>(FrameType::Message);
+  header.flags = (msg.ready ? FRAME_FLAG_READY : 0) |
+                 (msg.finished ? FRAME_FLAG_FINISHED : 0);
+  header.sequence = msg.counter;
+  if (msg.channel != 0) {
+    header.flags |= FRAME_FLAG_CHANNEL;
+    header.channel = msg.channel;
+  }
+  return header;
+}
+
+/*!
+ * @brief Encodes `msg` as a message frame.
+ *
+ * @param out At least MAX_FRAME_SIZE bytes.
+ * @return The number of bytes written, which follows the payload size.
+ */
+inline size_t encode_frame(const IPCMessage &msg, char *out) {
+  const FrameHeader header = message_frame_header(msg);
+  encode_frame_header(header, out);
+  const size_t header_size = frame_header_size(header);
+  memcpy(out + header_size, msg.data, header.length);
+  return header_size + header.length;
+}
+
+/*!
+ * @brief Rebuilds a message from a decoded header and the bytes after its
+ * fixed part: the channel, if flagged, then the payload.
+ *
+ * @return False if the frame is not a well-formed message frame.
+ */
+inline bool decode_frame(const FrameHeader &header, const char *body,
+                         IPCMessage &msg) {
+  if (header.type != static_cast<uint8_t>(FrameType::Message) ||
+      header.length > MAX_FRAME_PAYLOAD)
+    return false;
+
+  msg.counter = header.sequence;
+  msg.ready = header.flags & FRAME_FLAG_READY;
+  msg.finished = header.flags & FRAME_FLAG_FINISHED;
+  msg.channel = 0;
+  const char *payload = body;
+  if (header.flags & FRAME_FLAG_CHANNEL) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(body);
+    for (int i = 0; i < 4; ++i)
+      msg.channel |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    payload += FRAME_CHANNEL_SIZE;
+  }
+  memcpy(msg.data, payload, header.length);
+  memset(msg.data + header.length, 0, sizeof(msg.data) - header.length);
+  return true;
+}
+
+/*!
+ * @brief Decodes a whole frame held in one buffer, e.g. a datagram.
+ *
+ * @return False if `size` does not match the frame or it is malformed.
+ */
+inline bool decode_frame(const char *frame, size_t size, IPCMessage &msg) {
+  if (size < FRAME_HEADER_SIZE)
+    return false;
+  const FrameHeader header = decode_frame_header(frame);
+  return size == frame_header_size(header) + header.length &&
+         decode_frame(header, frame + FRAME_HEADER_SIZE, msg);
+}
+
+/*!
+ * @brief Writes the prefix of a payload frame carrying `size` bytes.
+ *
+ * @param out At least PAYLOAD_PREFIX_SIZE bytes.
+ */
+inline void encode_payload_prefix(uint64_t size, char *out) {
+  FrameHeader header;
+  header.type = static_cast<uint8_t>(FrameType::Payload);
+  encode_frame_header(header, out);
+  unsigned char *bytes = reinterpret_cast<unsigned char *>(out);
+  for (int i = 0; i < 8; ++i)
+    bytes[FRAME_HEADER_SIZE + i] = static_cast<unsigned char>(size >> (8 * i));
+}
+
+/*!
+ * @brief Reads a prefix encoded by `encode_payload_prefix()`.
+ *
+ * @param in At least PAYLOAD_PREFIX_SIZE bytes.
+ * @param size Receives the payload size.
+ * @return False if `in` does not start a payload frame.
+ */
+inline bool decode_payload_prefix(const char *in, uint64_t &size) {
+  const FrameHeader header = decode_frame_header(in);
+  if (header.type != static_cast<uint8_t>(FrameType::Payload) ||
+      header.length != 0)
+    return false;
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+  size = 0;
+  for (int i = 0; i < 8; ++i)
+    size |= static_cast<uint64_t>(bytes[FRAME_HEADER_SIZE + i]) << (8 * i);
+  return true;
+}
+
+/*!
+ * @brief Encodes a reference to `size` bytes at `offset` in `segment`.
+ *
+ * @param out At least REFERENCE_FRAME_SIZE bytes.
+ */
+inline void encode_reference_frame(uint32_t segment, uint64_t offset,
+                                   uint64_t size, char *out) {
+  FrameHeader header;
+  header.type = static_cast<uint8_t>(FrameType::Reference);
+  header.sequence = segment;
+  encode_frame_header(header, out);
+  unsigned char *bytes = reinterpret_cast<unsigned char *>(out);
+  unsigned char *fields = bytes + FRAME_HEADER_SIZE;
+  for (int i = 0; i < 8; ++i) {
+    fields[i] = static_cast<unsigned char>(offset >> (8 * i));
+    fields[8 + i] = static_cast<unsigned char>(size >> (8 * i));
+  }
+}
+
+/*!
+ * @brief Reads a frame encoded by `encode_reference_frame()`.
+ *
+ * @param in At least REFERENCE_FRAME_SIZE bytes.
+ * @return False if `in` is not a reference frame.
+ */
+inline bool decode_reference_frame(const char *in, uint32_t &segment,
+                                   uint64_t &offset, uint64_t &size) {
+  const FrameHeader header = decode_frame_header(in);
+  if (header.type != static_cast<uint8_t>(FrameType::Reference) ||
+      header.length != 0)
+    return false;
+  const unsigned char *fields =
+      reinterpret_cast<const unsigned char *>(in) + FRAME_HEADER_SIZE;
+  segment = header.sequence;
+  offset = 0;
+  size = 0;
+  for (int i = 0; i < 8; ++i) {
+    offset |= static_cast<uint64_t>(fields[i]) << (8 * i);
+    size |= static_cast<uint64_t>(fields[8 + i]) << (8 * i);
+  }
+  return true;
+}
+
+/*!
+ * @brief Splits a byte stream back into frames.
+ *
+ * Reads as much as is available into an internal buffer, so a stream of
+ * small frames costs one read per buffer rather than two per frame.
+ */
+class FrameReader {
+public:
+  /*! @brief Size of the receive buffer in bytes. */
+  static constexpr size_t BUFFER_SIZE = 16 * MAX_FRAME_SIZE;
+
+  /*!
+   * @brief Returns the next message from the stream.
+   *
+   * @param msg Receives the decoded message.
+   * @param read_some A callable `ssize_t(char *buffer, size_t length)` that
+   * reads at least one byte, like `read()`, and returns 0 at end of stream
+   * or a negative value on error.
+   * A frame that is not a message frame, such as a payload prefix, or
+   * whose length is out of range leaves the position of the next frame
+   * unknown. It marks the stream broken, and every later call fails until
+   * `reset()`.
+   *
+   * @return True if a message was decoded, false on end of stream, error or
+   * a broken stream.
+   */
+  template <typename ReadSome> bool next(IPCMessage &msg, ReadSome &&read_some) {
+    if (broken || !fill(FRAME_HEADER_SIZE, read_some))
+      return false;
+    const FrameHeader header = decode_frame_header(buffer + begin);
+    if (header.type != static_cast<uint8_t>(FrameType::Message) ||
+        header.length > MAX_FRAME_PAYLOAD) {
+      broken = true;
+      return false;
+    }
+    const size_t size = frame_header_size(header) + header.length;
+    if (!fill(size, read_some))
+      return false;
+
+    decode_frame(header, buffer + begin + FRAME_HEADER_SIZE, msg);
+    begin += size;
+    return true;
+  }
+
+  /*!
+   * @brief Reads exactly `length` raw bytes from the stream, e.g. a payload
+   * following its prefix.
+   *
+   * Buffered bytes are used first; the rest is read straight into `out`, so
+   * large payloads are not staged in the buffer.
+   *
+   * @param read_some As for `next()`.
+   * @return True if all bytes were read, false on end of stream or error.
+   */
+  template <typename ReadSome>
+  bool read(char *out, size_t length, ReadSome &&read_some) {
+    const size_t buffered_bytes =
+        end - begin < length ? end - begin : length;
+    memcpy(out, buffer + begin, buffered_bytes);
+    begin += buffered_bytes;
+    for (size_t done = buffered_bytes; done < length;) {
+      const ssize_t got = read_some(out + done, length - done);
+      if (got <= 0)
+        return false;
+      done += static_cast<size_t>(got);
+    }
+    return true;
+  }
+
+  /*! @brief Returns the number of buffered bytes not yet decoded. */
+  size_t buffered() const { return end - begin; }
+
+  /*! @brief Returns true once `next()` met a frame it cannot skip. */
+  bool is_broken() const { return broken; }
+
+  /*! @brief Discards any buffered bytes and clears the broken state. */
+  void reset() {
+    begin = end = 0;
+    broken = false;
+  }
+
+private:
+  /*! @brief Reads until at least `needed` bytes are buffered. */
+  template <typename ReadSome> bool fill(size_t needed, ReadSome &read_some) {
+    if (end - begin >= needed)
+      return true;
+    if (BUFFER_SIZE - begin < needed) {
+      memmove(buffer, buffer + begin, end - begin);
+      end -= begin;
+      begin = 0;
+    }
+    while (end - begin < needed) {
+      const ssize_t got = read_some(buffer + end, BUFFER_SIZE - end);
+      if (got <= 0)
+        return false;
+      end += static_cast<size_t>(got);
+    }
+    return true;
+  }
+
+  /*! @brief Received bytes; [begin, end) is not decoded yet. */
+  char buffer[BUFFER_SIZE];
+
+  /*! @brief Offset of the first undecoded byte. */
+  size_t begin = 0;
+
+  /*! @brief Offset one past the last received byte. */
+  size_t end = 0;
+
+  /*! @brief Set once the stream cannot be split into frames any more. */
+  bool broken = false;
+};
+
+/*!
+ * @brief Gathers a batch of message frames for a single `writev()`.
+ *
+ * Only the headers are encoded; each payload is referenced straight from
+ * its IPCMessage, so batching copies no message data.
+ */
+class FrameBatch {
+public:
+  /*! @brief Most messages gathered per batch (two iovecs each). */
+  static constexpr size_t MAX_MESSAGES = 512;
+
+  /*!
+   * @brief Adds the messages from `msgs` until the batch is full.
+   *
+   * The messages must stay alive until `write_all()` returns.
+   *
+   * @return The number of messages added.
+   */
+  size_t add(const IPCMessage *msgs, size_t count) {
+    size_t added = 0;
+    for (; added < count && messages < MAX_MESSAGES; ++added, ++messages) {
+      const IPCMessage &msg = msgs[added];
+      const FrameHeader header = message_frame_header(msg);
+      encode_frame_header(header, headers[messages]);
+      iov[2 * messages] = {headers[messages], frame_header_size(header)};
+      iov[2 * messages + 1] = {const_cast<char *>(msg.data), header.length};
+    }
+    return added;
+  }
+
+  /*!
+   * @brief Writes every gathered frame to `fd` and empties the batch.
+   *
+   * @param fd A pipe or stream socket.
+   * @return True if all bytes were written, false otherwise.
+   */
+  bool write_all(int fd) {
+    iovec *next = iov;
+    int remaining = static_cast<int>(2 * messages);
+    messages = 0;
+    while (remaining > 0) {
+      ssize_t written = writev(fd, next, remaining);
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+      // Skip what was written, resuming inside a partially written iovec.
+      while (remaining > 0 && static_cast<size_t>(written) >= next->iov_len) {
+        written -= static_cast<ssize_t>(next->iov_len);
+        ++next;
+        --remaining;
+      }
+      if (remaining > 0) {
+        next->iov_base = static_cast<char *>(next->iov_base) + written;
+        next->iov_len -= static_cast<size_t>(written);
+      }
+    }
+    return true;
+  }
+
+private:
+  /*! @brief Encoded headers, one per gathered message. */
+  char headers[MAX_MESSAGES][MAX_FRAME_HEADER_SIZE];
+
+  /*! @brief Header and payload iovecs, two per gathered message. */
+  iovec iov[2 * MAX_MESSAGES];
+
+  /*! @brief Number of messages gathered. */
+  size_t messages = 0;
+};
+
+} // namespace ipc
+
+#endif // IPC_WIRE_FORMAT_HPP
@@ -0,0 +1,238 @@
+#ifndef BROADCAST_TRANSPORT_HPP
+#define BROADCAST_TRANSPORT_HPP
+
+#include <AtomicWords.hpp>   // For race-free slot payloads
+#include <DoorbellTable.hpp> // For the readers' readiness descriptors
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SPSCRing.hpp>      // For CACHE_LINE_SIZE
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For the reader wait policies
+#include <atomic>            // For std::atomic
+#include <cstdint>           // For fixed-width integer types
+
+namespace ipc {
+
+/*!
+ * @brief One entry of the broadcast ring.
+ *
+ * `sequence` is 2 * (n + 1) once message number n is published in the slot,
+ * and odd while the writer is overwriting it. Readers compare it with the
+ * value they expect before and after copying the payload.
+ */
+struct alignas(CACHE_LINE_SIZE) BroadcastSlot {
+  /*! @brief Publication marker for the message held in the slot. */
+  std::atomic<uint64_t> sequence;
+
+  /*! @brief The message, stored as atomic words. */
+  AtomicWords<IPCMessage> message;
+};
+
+/*!
+ * @brief Header placed at the start of a broadcast segment, followed by
+ * `capacity` BroadcastSlot entries.
+ */
+struct BroadcastHeader {
+  /*! @brief Set to `BROADCAST_MAGIC` once the segment is initialized. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Number of slots. Always a power of two. */
+  uint32_t capacity;
+
+  /*! @brief Number of messages published so far. Written by the writer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_sequence;
+
+  /*! @brief Notified after each publication, for sleeping readers. */
+  WaitPoint readable;
+
+  /*! @brief Doorbells of readers that poll `readiness_fd()`. */
+  DoorbellTable doorbells;
+};
+
+/*!
+ * @brief Implements the IIPCTransport interface as a one-writer/many-reader
+ * broadcast channel in POSIX shared memory.
+ *
+ * The creating process is the writer. It writes each message once into a
+ * ring and never waits for readers. Any number of processes attach as
+ * readers with `create = false`, and each follows the ring with its own
+ * private cursor. A reader that falls more than a ring's length behind
+ * notices through the slot sequence numbers that it was overrun, skips
+ * ahead to the oldest message still available, and counts the messages it
+ * lost in `dropped()`.
+ */
+class BroadcastTransport : public IIPCTransport {
+public:
+  /*! @brief Default number of slots in the ring. */
+  static constexpr uint32_t DEFAULT_CAPACITY = 4096;
+
+  /*! @brief Value stored in BroadcastHeader::magic once ready. */
+  static constexpr uint32_t BROADCAST_MAGIC = 0x42435354; // "BCST"
+
+  /*!
+   * @brief Constructs a new BroadcastTransport object.
+   *
+   * @param capacity Number of slots, rounded up to a power of two. Only used
+   * by the writer, whose `initialize()` fails above MAX_QUEUE_CAPACITY.
+   * @param wait How a reader waits for the next message. CondVar is
+   * replaced by Futex: waking condvar sleepers takes a process-shared mutex,
+   * so a stalled or crashed reader holding it would block the writer.
+   * @param replay If true, a reader starts at the oldest message still in
+   * the ring; otherwise it only sees messages published after it attached.
+   */
+  explicit BroadcastTransport(uint32_t capacity = DEFAULT_CAPACITY,
+                              WaitStrategy wait = WaitStrategy::Futex,
+                              bool replay = false);
+
+  /*!
+   * @brief Destroys the BroadcastTransport object.
+   *
+   * Calls the cleanup method, which unmaps the segment and unlinks it if this
+   * instance is the writer.
+   */
+  ~BroadcastTransport() override;
+
+  /*!
+   * @brief Creates the channel as its writer or attaches as a reader.
+   *
+   * @param name A unique name for the shared memory object.
+   * @param create True for the single writer, false for readers.
+   * @return True if initialization is successful, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Publishes `msg` to every reader. Never blocks.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if published, false if this instance is not the writer.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next message at this reader's cursor.
+   *
+   * Waits while the reader is caught up. If the reader was overrun, the
+   * lost messages are added to `dropped()` and the oldest available one is
+   * returned.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message was received, false if this instance is not a
+   * reader.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends an IPCMessage, which never waits.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for one.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Publishes several messages, advancing the shared write sequence
+   * and waking readers once for the whole batch.
+   *
+   * @param msgs Pointer to the first message to publish.
+   * @param count The number of messages to publish.
+   * @return `count`, or 0 if this instance is not the writer.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Waits for the next message, then also takes those already
+   * published, up to `max`.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received, or 0 if this instance is not a
+   * reader.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*!
+   * @brief Returns this reader's doorbell, claiming a slot in the channel's
+   * DoorbellTable on first use, or -1 for the writer.
+   *
+   * Once this has been called, a receive that finds nothing new arms the
+   * doorbell, and the writer rings every armed reader when it publishes.
+   * The writer still never waits: it only writes to FIFOs that are open
+   * non-blocking.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Unmaps the segment and unlinks it if this instance is the writer.
+   */
+  void cleanup() override;
+
+  /*! @brief Returns the number of messages this reader lost to overruns. */
+  uint64_t dropped() const;
+
+  /*! @brief Returns the sequence number of the next message to be read. */
+  uint64_t cursor() const;
+
+private:
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Writes `msg` into its slot without announcing it. */
+  void publish(const IPCMessage &msg);
+
+  /*!
+   * @brief Attempts to read the message at `read_cursor` without waiting.
+   *
+   * @return True if a message was copied into `msg`.
+   */
+  bool try_read(IPCMessage &msg);
+
+  /*! @brief Requested number of slots for a new channel. */
+  uint32_t capacity;
+
+  /*! @brief How this reader waits. */
+  WaitStrategy wait_strategy;
+
+  /*! @brief Whether a new reader starts at the oldest retained message. */
+  bool replay;
+
+  /*! @brief True if this instance is the writer. */
+  bool is_writer = false;
+
+  /*! @brief The mapped shared memory segment. */
+  ShmSegment segment;
+
+  /*! @brief The segment header, or nullptr before initialize. */
+  BroadcastHeader *header = nullptr;
+
+  /*! @brief The first slot, located after the header. */
+  BroadcastSlot *slots = nullptr;
+
+  /*! @brief Next sequence to write (writer) or read (reader). */
+  uint64_t read_cursor = 0;
+
+  /*! @brief Messages this reader lost to overruns. */
+  uint64_t dropped_count = 0;
+
+  /*! @brief This instance's handle on the channel's doorbells. */
+  ReaderDoorbells doorbells;
+
+  /*! @brief True once `readiness_fd()` was called, so empty reads arm. */
+  bool doorbell_in_use = false;
+};
+} // namespace ipc
+
+#endif // BROADCAST_TRANSPORT_HPP
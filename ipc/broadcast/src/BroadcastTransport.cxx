@@ -0,0 +1,184 @@
+#include <BroadcastTransport.hpp>
+#include <cstdio>
+#include <new>
+
+ipc::BroadcastTransport::BroadcastTransport(uint32_t capacity,
+                                            WaitStrategy wait, bool replay)
+    : capacity(round_up_pow2(capacity)),
+      wait_strategy(wait == WaitStrategy::CondVar ? WaitStrategy::Futex : wait),
+      replay(replay) {}
+
+ipc::BroadcastTransport::~BroadcastTransport() { cleanup(); }
+
+bool ipc::BroadcastTransport::initialize(const std::string &name,
+                                         bool create) {
+  is_writer = create;
+  dropped_count = 0;
+
+  if (create) {
+    if (capacity == 0) {
+      fprintf(stderr, "broadcast capacity is too large\n");
+      return false;
+    }
+    if (!segment.create(name, sizeof(BroadcastHeader) +
+                                  capacity * sizeof(BroadcastSlot)))
+      return false;
+
+    header = new (segment.data()) BroadcastHeader;
+    header->capacity = capacity;
+    header->write_sequence.store(0, std::memory_order_relaxed);
+    header->readable.init();
+    header->doorbells.init();
+    slots = reinterpret_cast<BroadcastSlot *>(header + 1);
+    for (uint32_t i = 0; i < capacity; ++i)
+      new (&slots[i]) BroadcastSlot{};
+    read_cursor = 0;
+    header->magic.store(BROADCAST_MAGIC, std::memory_order_release);
+    doorbells.bind(&header->doorbells, name);
+    return true;
+  }
+
+  if (!segment.open(name))
+    return false;
+
+  header = static_cast<BroadcastHeader *>(segment.data());
+  if (segment.size() < sizeof(BroadcastHeader) ||
+      header->magic.load(std::memory_order_acquire) != BROADCAST_MAGIC) {
+    fprintf(stderr, "broadcast segment is not initialized\n");
+    cleanup();
+    return false;
+  }
+
+  capacity = header->capacity;
+  if (segment.size() <
+      sizeof(BroadcastHeader) + capacity * sizeof(BroadcastSlot)) {
+    fprintf(stderr, "broadcast segment is truncated\n");
+    cleanup();
+    return false;
+  }
+  slots = reinterpret_cast<BroadcastSlot *>(header + 1);
+
+  const uint64_t head = header->write_sequence.load(std::memory_order_acquire);
+  read_cursor = replay && head > capacity ? head - capacity : replay ? 0 : head;
+  doorbells.bind(&header->doorbells, name);
+  return true;
+}
+
+bool ipc::BroadcastTransport::send_message(const IPCMessage &msg) {
+  return send_batch(&msg, 1) == 1;
+}
+
+size_t ipc::BroadcastTransport::send_batch(const IPCMessage *msgs,
+                                           size_t count) {
+  if (!is_writer || !header)
+    return 0;
+
+  for (size_t i = 0; i < count; ++i)
+    publish(msgs[i]);
+
+  header->write_sequence.store(read_cursor, std::memory_order_release);
+  header->readable.notify();
+  doorbells.ring();
+  return count;
+}
+
+void ipc::BroadcastTransport::publish(const IPCMessage &msg) {
+  const uint64_t n = read_cursor++;
+  BroadcastSlot &slot = slots[n & (capacity - 1)];
+
+  // Seqlock write: mark the slot odd, store the payload, publish even.
+  slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.message.store(msg);
+  slot.sequence.store(2 * (n + 1), std::memory_order_release);
+}
+
+bool ipc::BroadcastTransport::try_read(IPCMessage &msg) {
+  BroadcastSlot &slot = slots[read_cursor & (capacity - 1)];
+  const uint64_t expected = 2 * (read_cursor + 1);
+
+  const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+  if (before < expected)
+    return false; // not written yet, or being written right now
+
+  if (before == expected) {
+    slot.message.load(msg);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+      ++read_cursor;
+      return true;
+    }
+  }
+
+  // The writer lapped this reader: skip to the oldest retained message.
+  const uint64_t head = header->write_sequence.load(std::memory_order_acquire);
+  const uint64_t oldest = head > capacity ? head - capacity : 0;
+  if (oldest > read_cursor) {
+    dropped_count += oldest - read_cursor;
+    read_cursor = oldest;
+  }
+  return false;
+}
+
+bool ipc::BroadcastTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::BroadcastTransport::send_for(const IPCMessage &msg,
+                                  std::chrono::nanoseconds) {
+  return send_message(msg) ? IPCStatus::Ok : IPCStatus::Error;
+}
+
+ipc::IPCStatus
+ipc::BroadcastTransport::receive_for(IPCMessage &msg,
+                                     std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::BroadcastTransport::receive_until(IPCMessage &msg,
+                                                      const Deadline &deadline) {
+  if (is_writer || !header)
+    return IPCStatus::Error;
+
+  bool received = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->readable, [&] { return try_read(msg); }, deadline);
+  });
+  if (!received && doorbell_in_use) {
+    // Anything published before the arm is found by this second read.
+    doorbells.arm();
+    received = try_read(msg);
+  }
+  return received ? IPCStatus::Ok : IPCStatus::Timeout;
+}
+
+size_t ipc::BroadcastTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+
+  size_t received = 1;
+  while (received < max && try_read(msgs[received]))
+    ++received;
+  return received;
+}
+
+int ipc::BroadcastTransport::readiness_fd() {
+  if (is_writer || !header)
+    return -1;
+  doorbell_in_use = true;
+  return doorbells.listen();
+}
+
+void ipc::BroadcastTransport::cleanup() {
+  // Releases the doorbell slot, so before the segment is unmapped.
+  doorbells.close();
+  doorbell_in_use = false;
+  header = nullptr;
+  slots = nullptr;
+  segment.close();
+}
+
+uint64_t ipc::BroadcastTransport::dropped() const { return dropped_count; }
+
+uint64_t ipc::BroadcastTransport::cursor() const { return read_cursor; }
@@ -0,0 +1,118 @@
+#ifndef IPC_ASYNC_TRANSPORT_HPP
+#define IPC_ASYNC_TRANSPORT_HPP
+
+#include <IIPCTransport.hpp> // For IIPCTransport and IPCStatus
+#include <Scheduler.hpp>     // For Scheduler and its Waiter
+
+namespace ipc {
+
+/*!
+ * @brief Coroutine interface to any IIPCTransport.
+ *
+ * `co_await async_receive(msg)` completes at once if a message is pending;
+ * otherwise the coroutine is suspended on the scheduler until the
+ * transport's `readiness_fd()` reports data and a retry succeeds. Sends are
+ * retried every scheduler round while the transport is full. No thread
+ * blocks, and the awaitables allocate nothing.
+ *
+ * One coroutine at a time should receive from (and one send to) a given
+ * transport, as with the blocking calls.
+ */
+class AsyncTransport {
+public:
+  /*!
+   * @brief Wraps an initialized transport.
+   *
+   * Asks the transport for its readiness descriptor up front, since some
+   * transports only announce messages on it once it has been requested.
+   *
+   * @param scheduler The scheduler the awaiting coroutines run on.
+   * @param transport The transport; must outlive this object.
+   */
+  AsyncTransport(Scheduler &scheduler, IIPCTransport &transport)
+      : scheduler(scheduler), transport(transport),
+        readiness_fd(transport.readiness_fd()) {}
+
+  /*! @brief Awaitable completing with the result of a receive. */
+  class ReceiveAwaiter : public Scheduler::Waiter {
+  public:
+    ReceiveAwaiter(AsyncTransport &owner, IPCMessage &msg)
+        : owner(owner), msg(msg) {}
+
+    bool await_ready() { return try_complete(); }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+      handle = awaiting;
+      owner.scheduler.wait(owner.readiness_fd, *this);
+    }
+
+    /*! @brief Returns IPCStatus::Ok or IPCStatus::Error. */
+    IPCStatus await_resume() const noexcept { return status; }
+
+    bool try_complete() override {
+      status = owner.transport.try_receive(msg);
+      return status != IPCStatus::WouldBlock;
+    }
+
+  private:
+    AsyncTransport &owner;
+    IPCMessage &msg;
+    IPCStatus status = IPCStatus::WouldBlock;
+  };
+
+  /*! @brief Awaitable completing with the result of a send. */
+  class SendAwaiter : public Scheduler::Waiter {
+  public:
+    SendAwaiter(AsyncTransport &owner, const IPCMessage &msg)
+        : owner(owner), msg(msg) {}
+
+    bool await_ready() { return try_complete(); }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+      handle = awaiting;
+      owner.scheduler.wait(-1, *this);
+    }
+
+    /*! @brief Returns IPCStatus::Ok or IPCStatus::Error. */
+    IPCStatus await_resume() const noexcept { return status; }
+
+    bool try_complete() override {
+      status = owner.transport.try_send(msg);
+      return status != IPCStatus::WouldBlock;
+    }
+
+  private:
+    AsyncTransport &owner;
+    const IPCMessage &msg;
+    IPCStatus status = IPCStatus::WouldBlock;
+  };
+
+  /*!
+   * @brief Receives into `msg`, suspending the awaiting coroutine while
+   * nothing is pending. `msg` must stay valid until the await completes.
+   */
+  ReceiveAwaiter async_receive(IPCMessage &msg) { return {*this, msg}; }
+
+  /*!
+   * @brief Sends `msg`, suspending the awaiting coroutine while the
+   * transport is full. `msg` must stay valid until the await completes.
+   */
+  SendAwaiter async_send(const IPCMessage &msg) { return {*this, msg}; }
+
+  /*! @brief Returns the wrapped transport. */
+  IIPCTransport &get_transport() const { return transport; }
+
+private:
+  /*! @brief The scheduler suspended coroutines wait on. */
+  Scheduler &scheduler;
+
+  /*! @brief The wrapped transport. */
+  IIPCTransport &transport;
+
+  /*! @brief The transport's readiness descriptor, or -1 to poll. */
+  int readiness_fd;
+};
+
+} // namespace ipc
+
+#endif // IPC_ASYNC_TRANSPORT_HPP
@@ -0,0 +1,144 @@
+#ifndef IPC_SCHEDULER_HPP
+#define IPC_SCHEDULER_HPP
+
+#include <Task.hpp>        // For Task
+#include <coroutine>       // For std::coroutine_handle
+#include <cstddef>         // For size_t
+#include <deque>           // For the run queue
+#include <unordered_map>   // For waiters by descriptor
+#include <unordered_set>   // For the spawned tasks
+#include <vector>          // For waiter lists
+
+namespace ipc {
+
+/*!
+ * @brief Runs coroutines on one thread, suspending them on descriptor
+ * readiness instead of blocking.
+ *
+ * A suspended operation is a Waiter: the scheduler retries it when its
+ * descriptor polls readable (one `epoll_wait()` covers every waiter) and
+ * resumes the coroutine only once the operation completes, so a spurious
+ * wake-up costs a retry rather than a resume. Waiters without a descriptor
+ * are retried every round; while any exist the scheduler waits at most
+ * POLL_INTERVAL_MS per round.
+ */
+class Scheduler {
+public:
+  /*! @brief Longest wait per round while descriptor-less waiters exist. */
+  static constexpr int POLL_INTERVAL_MS = 1;
+
+  /*!
+   * @brief A suspended operation, living in the awaiting coroutine's frame.
+   */
+  struct Waiter {
+    /*!
+     * @brief Attempts the operation without blocking.
+     *
+     * @return True once it completed (successfully or not), false to keep
+     * waiting.
+     */
+    virtual bool try_complete() = 0;
+
+    /*! @brief The coroutine to resume on completion. */
+    std::coroutine_handle<> handle;
+
+  protected:
+    ~Waiter() = default;
+  };
+
+  /*! @brief Constructs a scheduler with no epoll instance yet. */
+  Scheduler() = default;
+
+  /*! @brief Calls `cleanup()`. */
+  ~Scheduler();
+
+  Scheduler(const Scheduler &) = delete;
+  Scheduler &operator=(const Scheduler &) = delete;
+
+  /*!
+   * @brief Creates the epoll instance.
+   *
+   * @return True on success, false otherwise.
+   */
+  bool initialize();
+
+  /*!
+   * @brief Takes ownership of `task` and starts it on the next round. Its
+   * frame is freed when it finishes.
+   */
+  void spawn(Task<void> task);
+
+  /*! @brief Returns the number of spawned tasks not yet finished. */
+  size_t size() const;
+
+  /*!
+   * @brief Retries waiters whose descriptors are ready and resumes every
+   * runnable coroutine once.
+   *
+   * @param timeout_ms How long to wait if nothing is runnable, or -1 to
+   * wait indefinitely.
+   * @return The number of coroutines resumed, or -1 on failure.
+   */
+  long run_once(int timeout_ms = -1);
+
+  /*!
+   * @brief Runs rounds until every spawned task has finished.
+   *
+   * @return True once all finished, false on failure.
+   */
+  bool run();
+
+  /*!
+   * @brief Suspends `waiter.handle` until `waiter.try_complete()` succeeds,
+   * retrying it whenever `fd` polls readable, or every round if `fd` is -1.
+   */
+  void wait(int fd, Waiter &waiter);
+
+  /*! @brief Awaitable that lets the other runnable coroutines go first. */
+  auto yield() {
+    struct YieldAwaiter : Waiter {
+      Scheduler &scheduler;
+      explicit YieldAwaiter(Scheduler &scheduler) : scheduler(scheduler) {}
+      bool try_complete() override { return true; }
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> awaiting) {
+        handle = awaiting;
+        scheduler.wait(-1, *this);
+      }
+      void await_resume() const noexcept {}
+    };
+    return YieldAwaiter(*this);
+  }
+
+  /*!
+   * @brief Destroys unfinished tasks and closes the epoll instance. Must not
+   * be called from a coroutine.
+   */
+  void cleanup();
+
+private:
+  /*! @brief Frees a spawned task that reached its final suspend point. */
+  static void finish(void *scheduler, std::coroutine_handle<> handle);
+
+  /*! @brief (Re-)arms the one-shot epoll registration of `fd`. */
+  bool watch(int fd);
+
+  /*! @brief The epoll instance. */
+  int epoll_fd = -1;
+
+  /*! @brief Coroutines to resume, in order. */
+  std::deque<std::coroutine_handle<>> runnable;
+
+  /*! @brief Waiters by descriptor. */
+  std::unordered_map<int, std::vector<Waiter *>> waiters;
+
+  /*! @brief Waiters without a descriptor. */
+  std::vector<Waiter *> polled;
+
+  /*! @brief Frames of spawned tasks that have not finished. */
+  std::unordered_set<void *> tasks;
+};
+
+} // namespace ipc
+
+#endif // IPC_SCHEDULER_HPP
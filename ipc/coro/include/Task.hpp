@@ -0,0 +1,161 @@
+#ifndef IPC_TASK_HPP
+#define IPC_TASK_HPP
+
+#include <coroutine> // For coroutine handles and suspension points
+#include <exception> // For std::exception_ptr
+#include <optional>  // For the stored result
+#include <utility>   // For std::exchange, std::forward
+
+namespace ipc {
+
+template <typename T = void> class Task;
+
+namespace detail {
+
+/*! @brief Promise state shared by every Task. */
+struct TaskPromiseBase {
+  /*! @brief Resumes the awaiting coroutine, if any, when the task ends. */
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      TaskPromiseBase &promise = handle.promise();
+      if (promise.continuation)
+        return promise.continuation;
+      if (promise.on_detached_finish) {
+        // Like a std::thread, a spawned task may not end with an exception.
+        if (promise.exception)
+          std::terminate();
+        promise.on_detached_finish(promise.owner, handle);
+      }
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  /*! @brief Tasks are lazy: they start when awaited or spawned. */
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+
+  void unhandled_exception() { exception = std::current_exception(); }
+
+  /*! @brief The coroutine awaiting this task. */
+  std::coroutine_handle<> continuation;
+
+  /*! @brief Exception that ended the task, rethrown to the awaiter. */
+  std::exception_ptr exception;
+
+  /*! @brief Called when a spawned task ends; it destroys the frame. */
+  void (*on_detached_finish)(void *owner, std::coroutine_handle<>) = nullptr;
+
+  /*! @brief First argument to `on_detached_finish`. */
+  void *owner = nullptr;
+};
+
+/*! @brief Stores the result of a Task<T>. */
+template <typename T> struct TaskPromise : TaskPromiseBase {
+  Task<T> get_return_object();
+
+  template <typename U> void return_value(U &&value) {
+    result.emplace(std::forward<U>(value));
+  }
+
+  T take() {
+    if (exception)
+      std::rethrow_exception(exception);
+    return std::move(*result);
+  }
+
+  std::optional<T> result;
+};
+
+/*! @brief Promise of a Task<void>. */
+template <> struct TaskPromise<void> : TaskPromiseBase {
+  Task<void> get_return_object();
+
+  void return_void() const noexcept {}
+
+  void take() {
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+};
+
+} // namespace detail
+
+/*!
+ * @brief A lazily started coroutine producing a `T`.
+ *
+ * `co_await` starts the task and resumes the awaiter, by symmetric transfer,
+ * once it finishes, rethrowing any exception it ended with. Top-level tasks
+ * are handed to a Scheduler with `spawn()`.
+ *
+ * @tparam T The result type, or void.
+ */
+template <typename T> class Task {
+public:
+  using promise_type = detail::TaskPromise<T>;
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+  Task &operator=(Task &&other) noexcept {
+    if (this != &other) {
+      if (handle)
+        handle.destroy();
+      handle = std::exchange(other.handle, {});
+    }
+    return *this;
+  }
+
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+
+  /*! @brief Destroys the coroutine frame if still owned. */
+  ~Task() {
+    if (handle)
+      handle.destroy();
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle.promise().continuation = awaiting;
+    return handle;
+  }
+
+  T await_resume() { return handle.promise().take(); }
+
+  /*! @brief Gives up ownership of the coroutine frame. */
+  handle_type release() { return std::exchange(handle, {}); }
+
+private:
+  friend promise_type;
+
+  explicit Task(handle_type handle) : handle(handle) {}
+
+  /*! @brief The owned coroutine, or null once moved or released. */
+  handle_type handle;
+};
+
+namespace detail {
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object() {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace ipc
+
+#endif // IPC_TASK_HPP
@@ -0,0 +1,138 @@
+#include <Scheduler.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+ipc::Scheduler::~Scheduler() { cleanup(); }
+
+bool ipc::Scheduler::initialize() {
+  cleanup();
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    perror("epoll_create1");
+    return false;
+  }
+  return true;
+}
+
+void ipc::Scheduler::spawn(Task<void> task) {
+  auto handle = task.release();
+  handle.promise().on_detached_finish = &Scheduler::finish;
+  handle.promise().owner = this;
+  tasks.insert(handle.address());
+  runnable.push_back(handle);
+}
+
+size_t ipc::Scheduler::size() const { return tasks.size(); }
+
+long ipc::Scheduler::run_once(int timeout_ms) {
+  if (epoll_fd == -1)
+    return -1;
+
+  int wait_ms = timeout_ms;
+  if (!runnable.empty())
+    wait_ms = 0;
+  else if (!polled.empty() && (wait_ms < 0 || wait_ms > POLL_INTERVAL_MS))
+    wait_ms = POLL_INTERVAL_MS;
+
+  constexpr int MAX_EVENTS = 64;
+  epoll_event events[MAX_EVENTS];
+  int count;
+  while ((count = epoll_wait(epoll_fd, events, MAX_EVENTS, wait_ms)) == -1 &&
+         errno == EINTR) {
+  }
+  if (count == -1) {
+    perror("epoll_wait");
+    return -1;
+  }
+
+  // Retry the operations; only completed ones resume their coroutine.
+  auto retry = [this](std::vector<Waiter *> &list) {
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [this](Waiter *waiter) {
+                                if (!waiter->try_complete())
+                                  return false;
+                                runnable.push_back(waiter->handle);
+                                return true;
+                              }),
+               list.end());
+  };
+  for (int i = 0; i < count; ++i) {
+    const int fd = events[i].data.fd;
+    auto it = waiters.find(fd);
+    if (it == waiters.end())
+      continue;
+    retry(it->second);
+    if (it->second.empty())
+      waiters.erase(it);
+    else
+      watch(fd);
+  }
+  retry(polled);
+
+  // Coroutines made runnable while resuming wait for the next round.
+  long resumed = 0;
+  for (size_t n = runnable.size(); n > 0; --n, ++resumed) {
+    auto handle = runnable.front();
+    runnable.pop_front();
+    handle.resume();
+  }
+  return resumed;
+}
+
+bool ipc::Scheduler::run() {
+  while (!tasks.empty()) {
+    if (run_once(-1) < 0)
+      return false;
+  }
+  return true;
+}
+
+void ipc::Scheduler::wait(int fd, Waiter &waiter) {
+  if (fd == -1) {
+    polled.push_back(&waiter);
+    return;
+  }
+  auto &list = waiters[fd];
+  list.push_back(&waiter);
+  if (list.size() == 1 && !watch(fd)) {
+    // Fall back to retrying every round.
+    list.clear();
+    waiters.erase(fd);
+    polled.push_back(&waiter);
+  }
+}
+
+void ipc::Scheduler::cleanup() {
+  runnable.clear();
+  waiters.clear();
+  polled.clear();
+  // Destroying a suspended task destroys the tasks it awaits with it.
+  for (void *address : tasks)
+    std::coroutine_handle<>::from_address(address).destroy();
+  tasks.clear();
+  if (epoll_fd != -1) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+}
+
+void ipc::Scheduler::finish(void *scheduler, std::coroutine_handle<> handle) {
+  static_cast<Scheduler *>(scheduler)->tasks.erase(handle.address());
+  handle.destroy();
+}
+
+bool ipc::Scheduler::watch(int fd) {
+  epoll_event event{};
+  event.events = EPOLLIN | EPOLLONESHOT;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0)
+    return true;
+  // Not registered yet, or its file was closed and removed from epoll.
+  if (errno == ENOENT && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0)
+    return true;
+  perror("epoll_ctl");
+  return false;
+}
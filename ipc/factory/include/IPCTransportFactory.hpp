@@ -23,8 +23,21 @@ enum class IPCType {
   Signal,       /*!< Represents a signal based IPC transport (e.g., for simple
                    notifications). */
   MessageQueue, /*!< Represents a message queue based IPC transport. */
-  Socket        /*!< Represents a socket based IPC transport (e.g., Unix domain
-                   sockets). */
+  Socket,       /*!< Represents a TCP socket based IPC transport. */
+  SharedMemoryQueue, /*!< Represents a multi-producer/multi-consumer queue in
+                       shared memory. */
+  SharedMemoryArena, /*!< Represents a variable-size message transport backed
+                        by a shared memory arena. */
+  Hybrid,            /*!< Represents a Unix domain socket that passes large
+                        payloads by reference to a shared memory pool. */
+  Broadcast,         /*!< Represents a one-writer/many-reader broadcast ring in
+                        shared memory. */
+  Snapshot,          /*!< Represents a seqlock-protected latest-value channel
+                        in shared memory. */
+  UnixSocket,        /*!< Represents a Unix domain (SOCK_SEQPACKET) socket
+                        based IPC transport. */
+  Datagram           /*!< Represents a one-way UDP datagram channel, unicast
+                        or multicast. */
 };
 
 /*!
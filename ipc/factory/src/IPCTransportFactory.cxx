@@ -1,7 +1,14 @@
+#include <BroadcastTransport.hpp>
+#include <HybridTransport.hpp>
 #include <MsgQueueTransport.hpp>
 #include <SharedMemoryTransport.hpp>
+#include <ShmArenaTransport.hpp>
+#include <ShmQueueTransport.hpp>
 #include <SignalTransport.hpp>
+#include <SnapshotTransport.hpp>
 #include <TCPSocketTransport.hpp>
+#include <UDPSocketTransport.hpp>
+#include <UnixSocketTransport.hpp>
 #include <IPCTransportFactory.hpp>
 #include <PipeTransport.hpp>
 
@@ -14,10 +21,24 @@ IPCTransportFactory::create_transport(IPCType type) {
     return std::make_unique<ipc::SharedMemoryTransport>();
   case IPCType::Socket:
     return std::make_unique<ipc::TCPSocketTransport>();
+  case IPCType::UnixSocket:
+    return std::make_unique<ipc::UnixSocketTransport>();
+  case IPCType::Datagram:
+    return std::make_unique<ipc::UDPSocketTransport>();
   case IPCType::MessageQueue:
     return std::make_unique<ipc::MsgQueueTransport>();
   case IPCType::Signal:
     return std::make_unique<ipc::SignalTransport>();
+  case IPCType::SharedMemoryQueue:
+    return std::make_unique<ipc::ShmQueueTransport>();
+  case IPCType::SharedMemoryArena:
+    return std::make_unique<ipc::ShmArenaTransport>();
+  case IPCType::Hybrid:
+    return std::make_unique<ipc::HybridTransport>();
+  case IPCType::Broadcast:
+    return std::make_unique<ipc::BroadcastTransport>();
+  case IPCType::Snapshot:
+    return std::make_unique<ipc::SnapshotTransport>();
   }
   return std::unique_ptr<ipc::IIPCTransport>();
 }
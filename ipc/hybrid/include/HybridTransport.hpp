@@ -0,0 +1,333 @@
+#ifndef HYBRID_TRANSPORT_HPP
+#define HYBRID_TRANSPORT_HPP
+
+#include <Deadline.hpp>      // For timed send and receive
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <ShmArena.hpp>      // For the shared payload pool
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For waiting on pool space
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <atomic>            // For std::atomic
+#include <cstdint>           // For fixed-width integer types
+#include <string>            // For std::string
+#include <vector>            // For std::vector
+
+namespace ipc {
+
+/*!
+ * @brief Header placed at the start of a hybrid transport's pool segment,
+ * followed by the ShmArena both directions allocate from.
+ */
+struct HybridPoolHeader {
+  /*! @brief Set to `HYBRID_POOL_MAGIC` once the segment is initialized. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Size of the arena pool in bytes. */
+  uint64_t pool_size;
+
+  /*! @brief Notified whenever a payload block is returned to the pool. */
+  WaitPoint freed;
+};
+
+/*!
+ * @brief Counts how HybridTransport payloads were sent.
+ */
+struct HybridStats {
+  /*! @brief Payloads copied into the socket. */
+  uint64_t inline_payloads = 0;
+
+  /*! @brief Payloads left in the pool and sent by reference. */
+  uint64_t shared_payloads = 0;
+};
+
+/*!
+ * @brief Implements the IIPCTransport interface with a Unix domain stream
+ * socket for control and a shared memory pool for large payloads.
+ *
+ * Messages and small payloads travel inline on the socket in the frames of
+ * WireFormat.hpp, as with UnixSocketTransport. A payload of at least the
+ * inline threshold is written once into a ShmArena shared by both
+ * directions, and only a reference frame (segment, offset, size) crosses
+ * the socket; the receiver returns the block when it releases the payload.
+ * The cost of a large send is thus one copy plus a constant-size frame,
+ * while the stream keeps its ordering and blocking semantics.
+ *
+ * The creator makes the pool segment `name` and serves the abstract socket
+ * address `name`; the opener connects, then maps the pool. Payloads and
+ * messages share one stream, so the receiver must call `receive()` or
+ * `receive_buffer()` where the sender called `send()` and the message calls
+ * where it sent messages.
+ */
+class HybridTransport : public IIPCTransport {
+public:
+  /*! @brief Default pool size. */
+  static constexpr size_t DEFAULT_POOL_SIZE = 64u << 20;
+
+  /*! @brief Default size from which payloads go through the pool. */
+  static constexpr size_t DEFAULT_INLINE_THRESHOLD = 8u << 10;
+
+  /*! @brief Value stored in HybridPoolHeader::magic once ready. */
+  static constexpr uint32_t HYBRID_POOL_MAGIC = 0x48594252; // "HYBR"
+
+  /*!
+   * @brief How long an opener keeps retrying while the creator is not
+   * listening yet, in milliseconds.
+   */
+  static constexpr int CONNECT_TIMEOUT_MS = 5000;
+
+  /*!
+   * @brief Constructs a new HybridTransport object.
+   *
+   * @param pool_size Bytes available for payloads in flight, shared by both
+   * directions. Only used by the creator.
+   * @param inline_threshold Payloads of this many bytes or more go through
+   * the pool; smaller ones are copied into the socket.
+   * @param wait How this instance waits while the pool is exhausted.
+   */
+  explicit HybridTransport(size_t pool_size = DEFAULT_POOL_SIZE,
+                           size_t inline_threshold = DEFAULT_INLINE_THRESHOLD,
+                           WaitStrategy wait = WaitStrategy::Yield);
+
+  /*!
+   * @brief Destroys the HybridTransport object, closing the connection and
+   * unmapping the pool.
+   */
+  ~HybridTransport() override;
+
+  /*!
+   * @brief Creates or opens the pool and connects the control socket.
+   *
+   * @param name The pool segment name, also used as the abstract socket
+   * address.
+   * @param create True to create the pool and wait for the peer, false to
+   * connect to a creator.
+   * @return True if both channels are ready, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends a message inline on the socket.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if the message was sent, false otherwise.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next message from the socket.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message was received, false on failure.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends `msg`, waiting at most `timeout` for socket buffer space.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives the next message, waiting at most `timeout`.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with a single `writev()` per batch.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Waits for the first message, then adds those already buffered or
+   * queued on the socket.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*! @brief Returns the control socket, or -1 before initialization. */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Sends `size` bytes from `data`: inline below the threshold,
+   * otherwise copied into the pool and sent by reference.
+   *
+   * @param timeout How long to wait for pool space, as for `allocate()`.
+   * @return True if the payload was sent, false on failure, if it exceeds
+   * `max_payload_size()` or if the pool stayed exhausted until the timeout.
+   */
+  bool send(const void *data, size_t size,
+            std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+  /*!
+   * @brief Allocates a pool buffer the caller can fill in place, so a large
+   * payload is written exactly once.
+   *
+   * Waits up to `timeout` while the pool is exhausted. The buffer must be
+   * passed to `send_buffer()` exactly once.
+   *
+   * @param size The number of payload bytes needed.
+   * @param timeout How long to wait for space; the default waits until the
+   * peer releases enough. Zero makes a single attempt.
+   * @return A writable pointer into shared memory, or nullptr if not
+   * initialized, `size` exceeds `max_payload_size()` or the timeout
+   * expired.
+   */
+  void *allocate(size_t size, std::chrono::nanoseconds timeout =
+                                  std::chrono::nanoseconds::max());
+
+  /*!
+   * @brief Sends a buffer obtained from `allocate()` by reference,
+   * whatever its size.
+   *
+   * @param buffer A pointer returned by `allocate()`.
+   * @param size The number of valid payload bytes in `buffer`.
+   * @return True if the reference was sent. On failure the buffer is
+   * returned to the pool.
+   */
+  bool send_buffer(void *buffer, size_t size);
+
+  /*!
+   * @brief Receives the next payload, inline or by reference.
+   *
+   * Referenced payloads are read in place; inline ones are copied into a
+   * buffer owned by the transport. Either way the result stays valid until
+   * it is passed to `release_buffer()`, which must happen before the next
+   * receive.
+   *
+   * @param size Receives the payload length in bytes.
+   * @return A read-only pointer to the payload, or nullptr on failure.
+   */
+  const void *receive_buffer(size_t &size);
+
+  /*!
+   * @brief Releases a payload from `receive_buffer()`, returning pool
+   * blocks to the sender.
+   */
+  void release_buffer(const void *buffer);
+
+  /*!
+   * @brief Receives the next payload and copies it into `out`.
+   *
+   * @return True if a payload was received, false otherwise.
+   */
+  bool receive(std::vector<char> &out);
+
+  /*!
+   * @brief Changes the size from which payloads go through the pool.
+   *
+   * Only affects this side's sends; receivers accept both forms.
+   */
+  void set_inline_threshold(size_t bytes);
+
+  /*! @brief Returns the size from which payloads go through the pool. */
+  size_t get_inline_threshold() const;
+
+  /*! @brief Returns the largest payload the pool can hold, in bytes. */
+  size_t max_payload_size() const;
+
+  /*! @brief Returns the payload counters since `initialize()`. */
+  const HybridStats &stats() const;
+
+  /*!
+   * @brief Selects huge page backing, prefaulting, locking or memfd mode
+   * for the pool.
+   *
+   * Must be called before `initialize()` to take effect.
+   */
+  void set_segment_options(const ShmSegmentOptions &options);
+
+  /*! @brief Reports which segment options took effect after initialize. */
+  const ShmSegmentReport &segment_report() const;
+
+  /*!
+   * @brief Closes the connection and unmaps the pool, unlinking it if this
+   * instance created it.
+   */
+  void cleanup() override;
+
+private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Reads the start of the next payload frame.
+   *
+   * For an inline payload `shared` is set to false and the `size` payload
+   * bytes are left in the stream; otherwise `offset` locates them in the
+   * pool.
+   *
+   * @return False on end of stream, error or a malformed frame.
+   */
+  bool receive_header(bool &shared, uint64_t &offset, uint64_t &size);
+
+  /*! @brief Reads `length` bytes of the stream into `out`. */
+  bool read_stream(char *out, size_t length);
+
+  /*!
+   * @brief Sends all `length` bytes of `buffer`, retrying partial sends.
+   *
+   * @param flags Extra `send()` flags, e.g. MSG_MORE.
+   * @return True if everything was sent, false otherwise.
+   */
+  bool send_all(const char *buffer, size_t length, int flags = 0);
+
+  /*! @brief Creates and maps the pool segment `name`. */
+  bool create_pool(const std::string &name);
+
+  /*! @brief Maps the pool segment `name` made by the creator. */
+  bool open_pool(const std::string &name);
+
+  /*! @brief Requested pool size for a newly created segment. */
+  size_t pool_size;
+
+  /*! @brief Payloads of this many bytes or more go through the pool. */
+  size_t inline_threshold;
+
+  /*! @brief How this instance waits for pool space. */
+  WaitStrategy wait_strategy;
+
+  /*! @brief The mapped pool segment. */
+  ShmSegment segment;
+
+  /*! @brief The pool header, or nullptr before initialize. */
+  HybridPoolHeader *header = nullptr;
+
+  /*! @brief The shared payload allocator, or nullptr before initialize. */
+  ShmArena *arena = nullptr;
+
+  /*! @brief The connected control socket, or -1. */
+  int socket_fd = -1;
+
+  /*! @brief Reassembles frames from the control socket. */
+  FrameReader reader;
+
+  /*! @brief Holds the last inline payload returned by `receive_buffer()`. */
+  std::vector<char> inline_buffer;
+
+  /*! @brief Payload counters. */
+  HybridStats counters;
+};
+} // namespace ipc
+
+#endif // HYBRID_TRANSPORT_HPP
@@ -0,0 +1,452 @@
+#include <FdPassing.hpp>
+#include <HybridTransport.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+/*! @brief Rounds `value` up to a multiple of the cache line size. */
+size_t round_up_line(size_t value) {
+  return (value + ipc::CACHE_LINE_SIZE - 1) & ~(ipc::CACHE_LINE_SIZE - 1);
+}
+
+} // namespace
+
+ipc::HybridTransport::HybridTransport(size_t pool_size,
+                                      size_t inline_threshold,
+                                      WaitStrategy wait)
+    : pool_size(round_up_line(pool_size)), inline_threshold(inline_threshold),
+      wait_strategy(wait) {}
+
+ipc::HybridTransport::~HybridTransport() { cleanup(); }
+
+bool ipc::HybridTransport::initialize(const std::string &name, bool create) {
+  cleanup();
+  reader.reset();
+  counters = HybridStats{};
+
+  sockaddr_un address{};
+  socklen_t length = 0;
+  if (!make_abstract_address(name, address, length))
+    return false;
+
+  if (create) {
+    if (!create_pool(name))
+      return false;
+
+    const int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+      perror("socket");
+      cleanup();
+      return false;
+    }
+    // Listen before publishing: an opener connects first and only then
+    // maps the pool, which in memfd mode completes publish().
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), length) < 0 ||
+        listen(listen_fd, 1) < 0) {
+      perror("bind/listen");
+      close(listen_fd);
+      cleanup();
+      return false;
+    }
+    if (!segment.publish()) {
+      close(listen_fd);
+      cleanup();
+      return false;
+    }
+
+    while ((socket_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)) <
+               0 &&
+           errno == EINTR) {
+    }
+    const int error = errno;
+    // Only one peer is served; closing the listener frees the name.
+    close(listen_fd);
+    if (socket_fd < 0) {
+      errno = error;
+      perror("accept");
+      cleanup();
+      return false;
+    }
+    return true;
+  }
+
+  for (int waited = 0;; waited += 10) {
+    socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0) {
+      perror("socket");
+      return false;
+    }
+    if (connect(socket_fd, reinterpret_cast<sockaddr *>(&address), length) ==
+        0)
+      break;
+
+    // The creator may not be listening yet; retry on a fresh socket.
+    const int error = errno;
+    close(socket_fd);
+    socket_fd = -1;
+    if ((error != ECONNREFUSED && error != EAGAIN) ||
+        waited >= CONNECT_TIMEOUT_MS) {
+      errno = error;
+      perror("connect");
+      return false;
+    }
+    usleep(10 * 1000);
+  }
+
+  // The creator listens only once the pool exists.
+  if (!open_pool(name)) {
+    cleanup();
+    return false;
+  }
+  return true;
+}
+
+bool ipc::HybridTransport::create_pool(const std::string &name) {
+  if (!segment.create(name, sizeof(HybridPoolHeader) +
+                                ShmArena::bytes_for(pool_size)))
+    return false;
+
+  header = new (segment.data()) HybridPoolHeader;
+  header->pool_size = pool_size;
+  header->freed.init();
+  arena = new (header + 1) ShmArena;
+  arena->init(pool_size);
+  header->magic.store(HYBRID_POOL_MAGIC, std::memory_order_release);
+  return true;
+}
+
+bool ipc::HybridTransport::open_pool(const std::string &name) {
+  if (!segment.open(name))
+    return false;
+  if (segment.size() < sizeof(HybridPoolHeader)) {
+    fprintf(stderr, "hybrid transport pool is truncated\n");
+    return false;
+  }
+  header = static_cast<HybridPoolHeader *>(segment.data());
+  if (header->magic.load(std::memory_order_acquire) != HYBRID_POOL_MAGIC) {
+    fprintf(stderr, "hybrid transport pool is not initialized\n");
+    return false;
+  }
+  pool_size = header->pool_size;
+  if (segment.size() <
+      sizeof(HybridPoolHeader) + ShmArena::bytes_for(pool_size)) {
+    fprintf(stderr, "hybrid transport pool is truncated\n");
+    return false;
+  }
+  arena = reinterpret_cast<ShmArena *>(header + 1);
+  return true;
+}
+
+bool ipc::HybridTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::HybridTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::HybridTransport::send_for(const IPCMessage &msg,
+                               std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::HybridTransport::receive_for(IPCMessage &msg,
+                                  std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::HybridTransport::send_until(const IPCMessage &msg,
+                                                const Deadline &deadline) {
+  if (socket_fd == -1)
+    return IPCStatus::Error;
+
+  // The deadline is not applied to the remainder of a frame that was
+  // partially accepted.
+  const IPCStatus status = wait_fd(socket_fd, POLLOUT, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char frame[MAX_FRAME_SIZE];
+  return send_all(frame, encode_frame(msg, frame)) ? IPCStatus::Ok
+                                                   : IPCStatus::Error;
+}
+
+ipc::IPCStatus ipc::HybridTransport::receive_until(IPCMessage &msg,
+                                                   const Deadline &deadline) {
+  if (socket_fd == -1)
+    return IPCStatus::Error;
+
+  IPCStatus status = IPCStatus::Ok;
+  const bool received =
+      reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+        status = wait_fd(socket_fd, POLLIN, deadline);
+        if (status != IPCStatus::Ok)
+          return -1;
+        ssize_t recvd;
+        while ((recvd = recv(socket_fd, buffer, length, 0)) < 0 &&
+               errno == EINTR) {
+        }
+        if (recvd < 0)
+          perror("recv");
+        if (recvd <= 0)
+          status = IPCStatus::Error;
+        return recvd;
+      });
+  if (received)
+    return IPCStatus::Ok;
+  return status == IPCStatus::Ok ? IPCStatus::Error : status;
+}
+
+size_t ipc::HybridTransport::send_batch(const IPCMessage *msgs, size_t count) {
+  size_t sent = 0;
+  if (socket_fd == -1)
+    return sent;
+
+  FrameBatch batch;
+  while (sent < count) {
+    const size_t added = batch.add(msgs + sent, count - sent);
+    if (!batch.write_all(socket_fd)) {
+      perror("writev");
+      break;
+    }
+    sent += added;
+  }
+  return sent;
+}
+
+size_t ipc::HybridTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+
+  // Top up the buffer only with data that is already queued.
+  size_t received = 1;
+  const int fd = socket_fd;
+  while (received < max &&
+         reader.next(msgs[received], [fd](char *buffer, size_t length) {
+           return recv(fd, buffer, length, MSG_DONTWAIT);
+         }))
+    ++received;
+  return received;
+}
+
+int ipc::HybridTransport::readiness_fd() { return socket_fd; }
+
+bool ipc::HybridTransport::send(const void *data, size_t size,
+                               std::chrono::nanoseconds timeout) {
+  if (socket_fd == -1 || size > max_payload_size())
+    return false;
+
+  if (size >= inline_threshold) {
+    void *buffer = allocate(size, timeout);
+    if (!buffer)
+      return false;
+    std::memcpy(buffer, data, size);
+    return send_buffer(buffer, size);
+  }
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  encode_payload_prefix(size, prefix);
+  if (!send_all(prefix, sizeof(prefix), MSG_MORE) ||
+      !send_all(static_cast<const char *>(data), size))
+    return false;
+  ++counters.inline_payloads;
+  return true;
+}
+
+void *ipc::HybridTransport::allocate(size_t size,
+                                    std::chrono::nanoseconds timeout) {
+  if (!arena || size > max_payload_size())
+    return nullptr;
+
+  uint64_t offset = ShmArena::NPOS;
+  with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->freed,
+        [&] {
+          offset = arena->allocate(size);
+          return offset != ShmArena::NPOS;
+        },
+        Deadline(timeout));
+  });
+  return offset == ShmArena::NPOS ? nullptr : arena->at(offset);
+}
+
+bool ipc::HybridTransport::send_buffer(void *buffer, size_t size) {
+  if (!arena || !buffer)
+    return false;
+
+  const uint64_t offset = arena->offset_of(buffer);
+  char frame[REFERENCE_FRAME_SIZE];
+  encode_reference_frame(0, offset, size, frame);
+  if (socket_fd == -1 || size > arena->capacity_of(offset) ||
+      !send_all(frame, sizeof(frame))) {
+    release_buffer(buffer);
+    return false;
+  }
+  ++counters.shared_payloads;
+  return true;
+}
+
+const void *ipc::HybridTransport::receive_buffer(size_t &size) {
+  bool shared = false;
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  if (!receive_header(shared, offset, length))
+    return nullptr;
+
+  size = length;
+  if (shared)
+    return arena->at(offset);
+
+  inline_buffer.resize(length);
+  if (!read_stream(inline_buffer.data(), length))
+    return nullptr;
+  // An empty payload still needs a pointer that is not null.
+  return inline_buffer.empty() ? static_cast<const void *>(this)
+                               : inline_buffer.data();
+}
+
+void ipc::HybridTransport::release_buffer(const void *buffer) {
+  if (!arena || !buffer)
+    return;
+  // Inline payloads live in `inline_buffer` and need no release.
+  const char *bytes = static_cast<const char *>(buffer);
+  if (bytes < arena->pool() || bytes >= arena->pool() + pool_size)
+    return;
+  arena->deallocate(arena->offset_of(buffer));
+  header->freed.notify();
+}
+
+bool ipc::HybridTransport::receive(std::vector<char> &out) {
+  bool shared = false;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  if (!receive_header(shared, offset, size))
+    return false;
+
+  if (!shared) {
+    out.resize(size);
+    return read_stream(out.data(), size);
+  }
+  const char *buffer = static_cast<const char *>(arena->at(offset));
+  out.assign(buffer, buffer + size);
+  release_buffer(buffer);
+  return true;
+}
+
+bool ipc::HybridTransport::receive_header(bool &shared, uint64_t &offset,
+                                          uint64_t &size) {
+  if (socket_fd == -1 || !arena)
+    return false;
+
+  char frame[REFERENCE_FRAME_SIZE];
+  if (!read_stream(frame, FRAME_HEADER_SIZE))
+    return false;
+
+  const uint8_t type = decode_frame_header(frame).type;
+  uint32_t pool = 0;
+  if (type == static_cast<uint8_t>(FrameType::Payload)) {
+    shared = false;
+    if (!read_stream(frame + FRAME_HEADER_SIZE,
+                     PAYLOAD_PREFIX_SIZE - FRAME_HEADER_SIZE) ||
+        !decode_payload_prefix(frame, size))
+      return false;
+  } else if (type == static_cast<uint8_t>(FrameType::Reference)) {
+    shared = true;
+    if (!read_stream(frame + FRAME_HEADER_SIZE,
+                     REFERENCE_FRAME_SIZE - FRAME_HEADER_SIZE) ||
+        !decode_reference_frame(frame, pool, offset, size))
+      return false;
+  } else {
+    fprintf(stderr, "hybrid transport expected a payload frame\n");
+    return false;
+  }
+
+  // Payloads are bounded by the pool either way, and references must point
+  // into this connection's only pool.
+  if (size > max_payload_size() ||
+      (shared && (pool != 0 || offset < ShmArena::BLOCK_HEADER_SIZE ||
+                  offset > pool_size - size))) {
+    fprintf(stderr, "hybrid transport received an invalid payload frame\n");
+    return false;
+  }
+  return true;
+}
+
+bool ipc::HybridTransport::read_stream(char *out, size_t length) {
+  const int fd = socket_fd;
+  return reader.read(out, length, [fd](char *buffer, size_t length) {
+    ssize_t recvd;
+    while ((recvd = recv(fd, buffer, length, 0)) < 0 && errno == EINTR) {
+    }
+    if (recvd < 0)
+      perror("recv");
+    return recvd;
+  });
+}
+
+bool ipc::HybridTransport::send_all(const char *buffer, size_t length,
+                                    int flags) {
+  size_t total_sent = 0;
+  while (total_sent < length) {
+    ssize_t sent = ::send(socket_fd, buffer + total_sent, length - total_sent,
+                          flags | MSG_NOSIGNAL);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR)
+        continue; // interrupted, retry
+      perror("send");
+      return false;
+    }
+    total_sent += sent;
+  }
+  return true;
+}
+
+void ipc::HybridTransport::set_inline_threshold(size_t bytes) {
+  inline_threshold = bytes;
+}
+
+size_t ipc::HybridTransport::get_inline_threshold() const {
+  return inline_threshold;
+}
+
+size_t ipc::HybridTransport::max_payload_size() const {
+  // The largest block is the biggest power of two that fits in the pool.
+  size_t block = size_t(1) << ShmArena::MIN_BLOCK_SHIFT;
+  while (block * 2 <= pool_size)
+    block *= 2;
+  return block < ShmArena::BLOCK_HEADER_SIZE
+             ? 0
+             : block - ShmArena::BLOCK_HEADER_SIZE;
+}
+
+const ipc::HybridStats &ipc::HybridTransport::stats() const {
+  return counters;
+}
+
+void ipc::HybridTransport::set_segment_options(
+    const ShmSegmentOptions &options) {
+  segment.set_options(options);
+}
+
+const ipc::ShmSegmentReport &ipc::HybridTransport::segment_report() const {
+  return segment.report();
+}
+
+void ipc::HybridTransport::cleanup() {
+  if (socket_fd != -1) {
+    close(socket_fd);
+    socket_fd = -1;
+  }
+  header = nullptr;
+  arena = nullptr;
+  segment.close();
+}
@@ -1,7 +1,9 @@
 #ifndef MSG_QUEUE_TRANSPORT_HPP
 #define MSG_QUEUE_TRANSPORT_HPP
 
+#include <Deadline.hpp>      // For timed send and receive
 #include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <WireFormat.hpp>    // For the framing used on the wire
 #include <cstring>           // For memcpy
 #include <mqueue.h> // For POSIX message queue functions (mq_open, mq_send, mq_receive, mq_close, mq_unlink)
 #include <sys/ipc.h> // For System V IPC key generation (ftok) - though POSIX mqueue is used, this might be a remnant or alternative consideration.
@@ -9,6 +11,7 @@
 #include <sys/types.h> // For basic system data types
 #include <sys/wait.h> // For waitpid (not directly used in this header, but often related to IPC processes)
 #include <unistd.h>   // For POSIX functions
+#include <vector>     // For the receive buffer
 
 namespace ipc {
 
@@ -42,7 +45,8 @@ struct MsgQueueBuffer {
  *
  * This class provides a concrete implementation for inter-process communication
  * using system-wide message queues, allowing processes to send and receive
- * structured messages.
+ * structured messages. Each queue message holds one compact frame (see
+ * WireFormat.hpp), so its length follows the payload size.
  */
 class MsgQueueTransport : public IIPCTransport {
 public:
@@ -78,9 +82,8 @@ public:
   /*!
    * @brief Sends an IPCMessage through the message queue.
    *
-   * This method serializes the `IPCMessage` into a `MsgQueueBuffer` and sends
-   * it to the message queue. A default message type (e.g., 1) is typically
-   * used.
+   * This method encodes the `IPCMessage` as one frame and sends it to the
+   * message queue.
    *
    * @param msg A constant reference to the IPCMessage to be sent.
    * @return True if the message is successfully sent, false otherwise.
@@ -90,8 +93,8 @@ public:
   /*!
    * @brief Receives an IPCMessage from the message queue.
    *
-   * This method reads a message from the message queue into a `MsgQueueBuffer`
-   * and deserializes it back into the provided `IPCMessage` structure.
+   * This method reads one frame from the message queue and decodes it into the
+   * provided `IPCMessage` structure.
    *
    * @param msg A reference to an IPCMessage object where the received data will
    * be stored.
@@ -99,6 +102,35 @@ public:
    */
   bool receive_message(IPCMessage &msg) override;
 
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for room
+   * in the queue (`mq_timedsend`).
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for one
+   * (`mq_timedreceive`).
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Returns the receive queue descriptor, which Linux lets poll
+   * report readable while a message is queued, or -1.
+   */
+  int readiness_fd() override;
+
   /*!
    * @brief Cleans up resources associated with the message queue transport.
    *
@@ -108,6 +140,12 @@ public:
   void cleanup() override;
 
 private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
   /*! @brief The send message queue descriptor. Initialized to (mqd_t)-1, an invalid
    * descriptor. */
   mqd_t send_mq = (mqd_t)-1;
@@ -118,6 +156,8 @@ private:
   std::string send_name;
   /* @param recieve_name A unique name for the recieve message queue (e.g.,*/
   std::string recieve_name;
+  /*! @brief Receive buffer, sized to the queue's `mq_msgsize`. */
+  std::vector<char> receive_buffer;
 };
 } // namespace ipc
 #endif // MSG_QUEUE_TRANSPORT_HPP
\ No newline at end of file
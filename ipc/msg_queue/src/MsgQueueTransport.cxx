@@ -3,6 +3,7 @@
 #include <sys/msg.h>
 #include <unistd.h>
 #include <cassert>
+#include <cerrno>
 
 
 ipc::MsgQueueTransport::MsgQueueTransport() = default;
@@ -48,23 +49,84 @@ bool ipc::MsgQueueTransport::initialize(const std::string &name, bool create) {
     return false;
   }
 
+  // mq_receive needs room for the largest message the queue accepts.
+  struct mq_attr receive_attr;
+  size_t receive_size = MAX_FRAME_SIZE;
+  if (mq_getattr(recieve_mq, &receive_attr) == 0 &&
+      static_cast<size_t>(receive_attr.mq_msgsize) > receive_size)
+    receive_size = static_cast<size_t>(receive_attr.mq_msgsize);
+  receive_buffer.resize(receive_size);
+
   return true;
 }
 
 bool ipc::MsgQueueTransport::send_message(const IPCMessage &msg) {
-  // Use msg.counter as message priority
-  return mq_send(send_mq, (const char *)&msg, sizeof(msg), 0) == 0;
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
 }
 
 bool ipc::MsgQueueTransport::receive_message(IPCMessage &msg) {
-  auto received = mq_receive(recieve_mq, (char *)&msg, sizeof(msg), nullptr);
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::MsgQueueTransport::send_for(const IPCMessage &msg,
+                                 std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::MsgQueueTransport::receive_for(IPCMessage &msg,
+                                    std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::MsgQueueTransport::send_until(const IPCMessage &msg,
+                                                  const Deadline &deadline) {
+  char frame[MAX_FRAME_SIZE];
+  const size_t length = encode_frame(msg, frame);
+
+  int result;
+  do {
+    if (deadline.is_never()) {
+      result = mq_send(send_mq, frame, length, 0);
+    } else {
+      const timespec when = deadline.realtime_timespec();
+      result = mq_timedsend(send_mq, frame, length, 0, &when);
+    }
+  } while (result == -1 && errno == EINTR);
+
+  if (result == 0)
+    return IPCStatus::Ok;
+  return errno == ETIMEDOUT ? IPCStatus::Timeout : IPCStatus::Error;
+}
+
+ipc::IPCStatus ipc::MsgQueueTransport::receive_until(IPCMessage &msg,
+                                                     const Deadline &deadline) {
+  ssize_t received;
+  do {
+    if (deadline.is_never()) {
+      received = mq_receive(recieve_mq, receive_buffer.data(),
+                            receive_buffer.size(), nullptr);
+    } else {
+      const timespec when = deadline.realtime_timespec();
+      received = mq_timedreceive(recieve_mq, receive_buffer.data(),
+                                 receive_buffer.size(), nullptr, &when);
+    }
+  } while (received < 0 && errno == EINTR);
+
   if (received < 0) {
+    if (errno == ETIMEDOUT)
+      return IPCStatus::Timeout;
     perror("mq_receive failed");
-    return false;
+    return IPCStatus::Error;
   }
-  return true;
+  return decode_frame(receive_buffer.data(), static_cast<size_t>(received), msg)
+             ? IPCStatus::Ok
+             : IPCStatus::Error;
 }
 
+int ipc::MsgQueueTransport::readiness_fd() { return static_cast<int>(recieve_mq); }
+
 void ipc::MsgQueueTransport::cleanup() {
   if (send_mq != -1) {
     mq_close(send_mq);
@@ -0,0 +1,197 @@
+#ifndef IPC_MULTIPLEXER_HPP
+#define IPC_MULTIPLEXER_HPP
+
+#include <Deadline.hpp>      // For timed channel operations
+#include <IIPCTransport.hpp> // For IIPCTransport and IPCStatus
+#include <condition_variable> // For waking channels whose messages arrived
+#include <cstddef>           // For size_t
+#include <cstdint>           // For uint32_t
+#include <deque>             // For the per-channel receive queues
+#include <memory>            // For std::unique_ptr
+#include <mutex>             // For the send and receive locks
+#include <unordered_map>     // For the channels by ID
+
+namespace ipc {
+
+class MuxChannel;
+
+/*!
+ * @brief Counts what a Multiplexer did with messages it could not file.
+ */
+struct MuxStats {
+  /*! @brief Messages for channels that were not open when they arrived. */
+  uint64_t unopened_drops = 0;
+
+  /*!
+   * @brief Times reading from the link stopped because a message arrived
+   * for a channel whose queue was full.
+   */
+  uint64_t backpressure_stalls = 0;
+};
+
+/*!
+ * @brief Carries many numbered logical channels over one connected
+ * transport, typically a TCPSocketTransport or UnixSocketTransport.
+ *
+ * Each channel is a MuxChannel, which is an IIPCTransport of its own, so
+ * code written against the interface runs unchanged on a channel. A
+ * channel's messages travel as ordinary messages on the shared link with
+ * the channel ID in IPCMessage::channel, which the framed transports put in
+ * the frame header, so the whole of `data` is left to the channel.
+ *
+ * Received messages are sorted into per-channel queues. Whichever channel
+ * needs a message reads from the link and files what it gets for the
+ * others, so channels can be used from different threads, each waiting
+ * only for its own messages. Messages for channels that are not open when
+ * they arrive are dropped. A message for a channel that already has
+ * `max_queued` waiting is not dropped: filing stops there and the link is
+ * not read again until that channel's receiver makes room, so the
+ * transport's own flow control holds back the peer and memory stays
+ * bounded. Until then the other channels get only the messages read before
+ * the stall, so every channel of a busy link needs a receiver. `stats()`
+ * counts the drops and stalls. Large sends are written in chunks
+ * of BATCH_SIZE messages so that concurrent senders interleave.
+ *
+ * Both peers must agree on the channel numbers. The link must outlive the
+ * multiplexer, and the multiplexer its channels.
+ */
+class Multiplexer {
+public:
+  /*! @brief Most messages written or read per link call. */
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /*! @brief Default number of messages each channel may have waiting. */
+  static constexpr size_t DEFAULT_MAX_QUEUED = 4096;
+
+  /*!
+   * @brief Multiplexes an initialized, connected transport.
+   *
+   * @param link The shared connection. It must not be used directly while
+   * channels are in use.
+   * @param max_queued Most received messages a channel holds before reading
+   * from the link stops.
+   */
+  explicit Multiplexer(IIPCTransport &link,
+                       size_t max_queued = DEFAULT_MAX_QUEUED);
+
+  /*! @brief Destroys the multiplexer. Its channels must be closed first. */
+  ~Multiplexer();
+
+  Multiplexer(const Multiplexer &) = delete;
+  Multiplexer &operator=(const Multiplexer &) = delete;
+
+  /*!
+   * @brief Opens channel `id`.
+   *
+   * Only messages read from the link after this call are delivered; both
+   * peers should open a channel before using it.
+   *
+   * @return The channel, or nullptr if it is already open.
+   */
+  std::unique_ptr<MuxChannel> open_channel(uint32_t id);
+
+  /*! @brief Returns the number of open channels. */
+  size_t channel_count() const;
+
+  /*! @brief Returns true once the link failed; every channel then fails. */
+  bool failed() const;
+
+  /*! @brief Returns the counts of drops and stalls so far. */
+  MuxStats stats() const;
+
+  /*! @brief Returns the shared link. */
+  IIPCTransport &get_link() const;
+
+private:
+  friend class MuxChannel;
+
+  /*! @brief Received messages of one channel. */
+  struct Queue {
+    /*! @brief Messages in arrival order. */
+    std::deque<IPCMessage> messages;
+
+    /*! @brief True while a MuxChannel is open on it. */
+    bool open = false;
+  };
+
+  /*!
+   * @brief Sends `count` messages on `channel`, giving up at `deadline`.
+   *
+   * @param sent Receives the number of messages sent.
+   * @return IPCStatus::Ok, IPCStatus::Timeout, or IPCStatus::Error if the
+   * link failed.
+   */
+  IPCStatus send(uint32_t channel, const IPCMessage *msgs, size_t count,
+                 const Deadline &deadline, size_t &sent);
+
+  /*! @brief Receives the next message of `channel`, giving up at `deadline`. */
+  IPCStatus receive(uint32_t channel, IPCMessage &msg,
+                    const Deadline &deadline);
+
+  /*!
+   * @brief Takes up to `max` messages already queued for `channel`.
+   *
+   * @return The number of messages taken.
+   */
+  size_t receive_queued(uint32_t channel, IPCMessage *msgs, size_t max);
+
+  /*! @brief Closes `channel` and drops its queued messages. */
+  void close_channel(uint32_t channel);
+
+  /*!
+   * @brief Reads one batch from the link and queues it by channel.
+   *
+   * Called without `receive_mutex` held, by one reader at a time, and only
+   * while `unfiled` is empty.
+   */
+  IPCStatus read_link(const Deadline &deadline);
+
+  /*!
+   * @brief Files `unfiled` into the queues up to the first message whose
+   * queue is full. `receive_mutex` must be held.
+   */
+  void file_unfiled();
+
+  /*!
+   * @brief Takes the first message of `queue` and files what its space
+   * lets through. `receive_mutex` must be held.
+   */
+  void take(Queue &queue, IPCMessage &msg);
+
+  /*! @brief The shared connection. */
+  IIPCTransport &link;
+
+  /*! @brief Serializes writes to the link. */
+  std::mutex send_mutex;
+
+  /*! @brief Guards the queues and the reader role. */
+  mutable std::mutex receive_mutex;
+
+  /*! @brief Signaled when a reader has queued messages or given up. */
+  std::condition_variable queued;
+
+  /*! @brief Open channels by ID. */
+  std::unordered_map<uint32_t, Queue> queues;
+
+  /*!
+   * @brief Messages read from the link but held back by a full queue, in
+   * arrival order. The link is not read while any are left.
+   */
+  std::deque<IPCMessage> unfiled;
+
+  /*! @brief Most messages a channel's queue holds. */
+  size_t max_queued;
+
+  /*! @brief Drop and stall counters, guarded by `receive_mutex`. */
+  MuxStats counters;
+
+  /*! @brief True while a channel is reading from the link. */
+  bool reading = false;
+
+  /*! @brief Set once the link failed. */
+  bool link_failed = false;
+};
+
+} // namespace ipc
+
+#endif // IPC_MULTIPLEXER_HPP
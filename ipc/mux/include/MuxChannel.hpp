@@ -0,0 +1,116 @@
+#ifndef IPC_MUX_CHANNEL_HPP
+#define IPC_MUX_CHANNEL_HPP
+
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <Multiplexer.hpp>   // For the multiplexer carrying the channel
+#include <cstdint>           // For uint32_t
+
+namespace ipc {
+
+/*!
+ * @brief One logical channel of a Multiplexer, usable like any other
+ * IIPCTransport.
+ *
+ * Channels are created open by `Multiplexer::open_channel()`. Messages
+ * sent on a channel get its ID as their IPCMessage::channel, and so do
+ * the messages it receives. A channel has no readiness descriptor of its
+ * own.
+ */
+class MuxChannel : public IIPCTransport {
+public:
+  /*! @brief Closes the channel. */
+  ~MuxChannel() override;
+
+  /*!
+   * @brief Reports whether the channel is open. There is nothing to set
+   * up: the channel was opened by its multiplexer.
+   *
+   * @return True if the channel is open and its link has not failed.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends `msg` on this channel.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if sent, false if the channel is closed or the link failed.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next message of this channel, reading the link on
+   * behalf of other channels while waiting.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message was received, false on failure.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends `msg`, waiting at most `timeout` for the link.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives the next message of this channel, waiting at most
+   * `timeout`.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with one link batch per
+   * Multiplexer::BATCH_SIZE messages.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Waits for the first message, then adds those already queued for
+   * this channel.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*! @brief Returns the channel number. */
+  uint32_t get_id() const;
+
+  /*!
+   * @brief Closes the channel. Messages still queued for it are dropped,
+   * and the ID may be opened again.
+   */
+  void cleanup() override;
+
+private:
+  friend class Multiplexer;
+
+  /*! @brief Creates an open channel; see Multiplexer::open_channel(). */
+  MuxChannel(Multiplexer &mux, uint32_t id) : mux(&mux), id(id) {}
+
+  /*! @brief The carrying multiplexer, or null once closed. */
+  Multiplexer *mux;
+
+  /*! @brief The channel number. */
+  uint32_t id;
+};
+
+} // namespace ipc
+
+#endif // IPC_MUX_CHANNEL_HPP
@@ -0,0 +1,195 @@
+#include <Multiplexer.hpp>
+#include <MuxChannel.hpp>
+#include <algorithm>
+
+ipc::Multiplexer::Multiplexer(IIPCTransport &link, size_t max_queued)
+    : link(link), max_queued(max_queued) {}
+
+ipc::Multiplexer::~Multiplexer() = default;
+
+std::unique_ptr<ipc::MuxChannel> ipc::Multiplexer::open_channel(uint32_t id) {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  Queue &queue = queues[id];
+  if (queue.open)
+    return nullptr;
+  queue.open = true;
+  return std::unique_ptr<MuxChannel>(new MuxChannel(*this, id));
+}
+
+size_t ipc::Multiplexer::channel_count() const {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  return std::count_if(queues.begin(), queues.end(),
+                       [](const auto &entry) { return entry.second.open; });
+}
+
+bool ipc::Multiplexer::failed() const {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  return link_failed;
+}
+
+ipc::MuxStats ipc::Multiplexer::stats() const {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  return counters;
+}
+
+ipc::IIPCTransport &ipc::Multiplexer::get_link() const { return link; }
+
+ipc::IPCStatus ipc::Multiplexer::send(uint32_t channel, const IPCMessage *msgs,
+                                      size_t count, const Deadline &deadline,
+                                      size_t &sent) {
+  sent = 0;
+  if (failed())
+    return IPCStatus::Error;
+
+  IPCMessage batch[BATCH_SIZE];
+  while (sent < count) {
+    const size_t n = std::min(BATCH_SIZE, count - sent);
+    for (size_t i = 0; i < n; ++i) {
+      batch[i] = msgs[sent + i];
+      batch[i].channel = channel;
+    }
+
+    // The lock is taken per chunk, so other channels get their turn.
+    std::unique_lock<std::mutex> lock(send_mutex);
+    size_t done;
+    IPCStatus status = IPCStatus::Ok;
+    if (deadline.is_never()) {
+      done = link.send_batch(batch, n);
+      if (done < n)
+        status = IPCStatus::Error;
+    } else {
+      done = 0;
+      while (done < n &&
+             (status = link.send_for(batch[done], deadline.remaining())) ==
+                 IPCStatus::Ok)
+        ++done;
+    }
+    lock.unlock();
+
+    sent += done;
+    if (status == IPCStatus::Error) {
+      std::lock_guard<std::mutex> failed_lock(receive_mutex);
+      link_failed = true;
+      queued.notify_all();
+    }
+    if (status != IPCStatus::Ok)
+      return status;
+  }
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::Multiplexer::receive(uint32_t channel, IPCMessage &msg,
+                                         const Deadline &deadline) {
+  std::unique_lock<std::mutex> lock(receive_mutex);
+  for (;;) {
+    auto it = queues.find(channel);
+    if (it == queues.end() || !it->second.open)
+      return IPCStatus::Error;
+    if (!it->second.messages.empty()) {
+      take(it->second, msg);
+      return IPCStatus::Ok;
+    }
+    if (link_failed && unfiled.empty())
+      return IPCStatus::Error;
+
+    if (!reading && unfiled.empty()) {
+      // Read the link on behalf of every channel, then look again.
+      reading = true;
+      lock.unlock();
+      const IPCStatus status = read_link(deadline);
+      lock.lock();
+      reading = false;
+      queued.notify_all();
+      if (status == IPCStatus::Timeout) {
+        it = queues.find(channel);
+        if (it == queues.end() || it->second.messages.empty())
+          return IPCStatus::Timeout;
+      }
+      continue;
+    }
+
+    // Another channel is reading, or a full channel holds up the link;
+    // wait until something was queued or room was made.
+    if (deadline.is_never()) {
+      queued.wait(lock);
+    } else if (queued.wait_for(lock, deadline.remaining()) ==
+               std::cv_status::timeout) {
+      it = queues.find(channel);
+      if (it == queues.end() || it->second.messages.empty())
+        return IPCStatus::Timeout;
+    }
+  }
+}
+
+size_t ipc::Multiplexer::receive_queued(uint32_t channel, IPCMessage *msgs,
+                                        size_t max) {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  auto it = queues.find(channel);
+  if (it == queues.end())
+    return 0;
+  size_t n = 0;
+  while (n < max && !it->second.messages.empty())
+    take(it->second, msgs[n++]);
+  return n;
+}
+
+void ipc::Multiplexer::close_channel(uint32_t channel) {
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  queues.erase(channel);
+  // Messages held back for the channel are now simply undeliverable.
+  file_unfiled();
+  queued.notify_all();
+}
+
+ipc::IPCStatus ipc::Multiplexer::read_link(const Deadline &deadline) {
+  IPCMessage batch[BATCH_SIZE];
+  size_t count = 0;
+  IPCStatus status;
+  if (deadline.is_never()) {
+    count = link.receive_batch(batch, BATCH_SIZE);
+    status = count > 0 ? IPCStatus::Ok : IPCStatus::Error;
+  } else {
+    status = link.receive_for(batch[0], deadline.remaining());
+    if (status == IPCStatus::Ok)
+      for (count = 1; count < BATCH_SIZE &&
+                      link.try_receive(batch[count]) == IPCStatus::Ok;
+           ++count) {
+      }
+  }
+
+  std::lock_guard<std::mutex> lock(receive_mutex);
+  unfiled.insert(unfiled.end(), batch, batch + count);
+  file_unfiled();
+  if (!unfiled.empty())
+    ++counters.backpressure_stalls;
+  if (status == IPCStatus::Error)
+    link_failed = true;
+  return status;
+}
+
+void ipc::Multiplexer::file_unfiled() {
+  while (!unfiled.empty()) {
+    const IPCMessage &msg = unfiled.front();
+    auto it = queues.find(msg.channel);
+    if (it == queues.end()) {
+      ++counters.unopened_drops;
+    } else {
+      // Filing stops rather than drops, keeping every channel in order.
+      if (it->second.messages.size() >= max_queued)
+        return;
+      it->second.messages.push_back(msg);
+    }
+    unfiled.pop_front();
+  }
+}
+
+void ipc::Multiplexer::take(Queue &queue, IPCMessage &msg) {
+  msg = queue.messages.front();
+  queue.messages.pop_front();
+  if (!unfiled.empty()) {
+    // The room made may let held back messages through, and once they are
+    // all filed the link can be read again.
+    file_unfiled();
+    queued.notify_all();
+  }
+}
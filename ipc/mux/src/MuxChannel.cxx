@@ -0,0 +1,55 @@
+#include <MuxChannel.hpp>
+
+ipc::MuxChannel::~MuxChannel() { cleanup(); }
+
+bool ipc::MuxChannel::initialize(const std::string &, bool) {
+  return mux != nullptr && !mux->failed();
+}
+
+bool ipc::MuxChannel::send_message(const IPCMessage &msg) {
+  size_t sent;
+  return mux != nullptr &&
+         mux->send(id, &msg, 1, Deadline::never(), sent) == IPCStatus::Ok;
+}
+
+bool ipc::MuxChannel::receive_message(IPCMessage &msg) {
+  return mux != nullptr &&
+         mux->receive(id, msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::MuxChannel::send_for(const IPCMessage &msg,
+                                         std::chrono::nanoseconds timeout) {
+  size_t sent;
+  if (mux == nullptr)
+    return IPCStatus::Error;
+  return mux->send(id, &msg, 1, Deadline(timeout), sent);
+}
+
+ipc::IPCStatus ipc::MuxChannel::receive_for(IPCMessage &msg,
+                                            std::chrono::nanoseconds timeout) {
+  if (mux == nullptr)
+    return IPCStatus::Error;
+  return mux->receive(id, msg, Deadline(timeout));
+}
+
+size_t ipc::MuxChannel::send_batch(const IPCMessage *msgs, size_t count) {
+  size_t sent = 0;
+  if (mux != nullptr)
+    mux->send(id, msgs, count, Deadline::never(), sent);
+  return sent;
+}
+
+size_t ipc::MuxChannel::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+  return 1 + mux->receive_queued(id, msgs + 1, max - 1);
+}
+
+uint32_t ipc::MuxChannel::get_id() const { return id; }
+
+void ipc::MuxChannel::cleanup() {
+  if (mux != nullptr) {
+    mux->close_channel(id);
+    mux = nullptr;
+  }
+}
@@ -1,7 +1,14 @@
 #ifndef PIPE_TRANSPORT_HPP
 #define PIPE_TRANSPORT_HPP
 
+#include <Deadline.hpp>      // For timed send and receive
 #include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SendCoalescer.hpp>  // For coalesced sends
+#include <UringStream.hpp>   // For the io_uring backend
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <cstdint>           // For uint64_t
+#include <memory>            // For std::unique_ptr
+#include <vector>            // For received payloads
 #include <unistd.h> // For POSIX pipe functions (e.g., open, close, read, write)
 
 namespace ipc {
@@ -12,7 +19,13 @@ namespace ipc {
  * This class provides a concrete implementation for inter-process communication
  * using two named pipes to facilitate bidirectional message exchange between
  * processes. One pipe is used for sending messages, and the other for
- * receiving.
+ * receiving. Messages travel as compact frames (see WireFormat.hpp), so the
+ * bytes written follow the payload size rather than sizeof(IPCMessage).
+ *
+ * Bulk payloads can bypass the user space copies: `send_gift()` hands its
+ * pages to the pipe by reference with `vmsplice()` and `receive_to_fd()`
+ * moves them on to a file or socket with `splice()`. Raising the pipe size
+ * with `set_pipe_size()` lets a single write carry a whole batch or payload.
  */
 class PipeTransport : public IIPCTransport {
 public:
@@ -21,8 +34,20 @@ public:
    *
    * Initializes internal state variables. Named pipes are not created or opened
    * until the initialize method is called.
+   *
+   * @param backend How messages are read and written. With IOBackend::IoUring
+   * the pipes are driven through a UringStream. Each peer may choose its own.
+   */
+  explicit PipeTransport(IOBackend backend = IOBackend::Syscalls);
+
+  /*!
+   * @brief How long the opening side waits for the creator to make the
+   * FIFOs, in milliseconds.
    */
-  PipeTransport();
+  static constexpr int OPEN_TIMEOUT_MS = 5000;
+
+  /*! @brief Largest payload receive() accepts, in bytes. */
+  static constexpr uint64_t MAX_PAYLOAD_SIZE = uint64_t(1) << 32;
 
   /*!
    * @brief Destroys the PipeTransport object.
@@ -38,6 +63,8 @@ public:
    * This method creates or opens the two named pipes required for
    * communication. One process should call initialize with `create = true` to
    * create the pipes, and the other with `create = false` to connect to them.
+   * The connecting side may start first; it waits up to OPEN_TIMEOUT_MS for
+   * the pipes to appear.
    *
    * @param name A base name for the named pipes. Two pipes will be
    * created/opened (e.g., `name_pipe1` and `name_pipe2`).
@@ -50,7 +77,8 @@ public:
   /*!
    * @brief Sends an IPCMessage through the named pipe.
    *
-   * Writes the entire IPCMessage structure to the designated write pipe.
+   * Encodes the message as one frame and writes it to the designated write
+   * pipe. Frames never exceed PIPE_BUF, so each write is atomic.
    *
    * @param msg A constant reference to the IPCMessage to be sent.
    * @return True if the message is successfully written, false otherwise.
@@ -60,7 +88,8 @@ public:
   /*!
    * @brief Receives an IPCMessage from the named pipe.
    *
-   * Reads an IPCMessage structure from the designated read pipe.
+   * Decodes the next frame from the designated read pipe, reading ahead
+   * into a buffer when more data is available.
    *
    * @param msg A reference to an IPCMessage object where the received data will
    * be stored.
@@ -68,6 +97,155 @@ public:
    */
   bool receive_message(IPCMessage &msg) override;
 
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for the
+   * pipe to accept it.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for a
+   * complete frame. A partially received frame stays buffered for the next
+   * call.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with one `writev()` per FrameBatch.
+   *
+   * Frame headers and payloads are gathered straight from `msgs`.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Sets how small sends are coalesced.
+   *
+   * With an enabled policy, `send_message()` queues the message and the
+   * queue is written in one batch once it holds `max_bytes` of frames or its
+   * oldest message has waited `max_delay`, whichever comes first. Receiving
+   * and `send_batch()` flush the queue first. The timed sends only apply their
+   * timeout to unbuffered writes.
+   *
+   * @param policy The new policy; pending messages are flushed first.
+   * @return False if flushing the pending messages failed.
+   */
+  bool set_coalescing(const CoalescingPolicy &policy);
+
+  /*!
+   * @brief Writes the messages held back by coalescing in one batch.
+   *
+   * @return True if nothing is left pending, false on failure.
+   */
+  bool flush() override;
+
+  /*!
+   * @brief Sends a byte payload of any size as one payload frame, copying
+   * it into the pipe.
+   *
+   * Not available with IOBackend::IoUring. Pending coalesced messages are
+   * flushed first.
+   *
+   * @param data The payload.
+   * @param size The payload size in bytes.
+   * @return True if the payload was sent, false otherwise.
+   */
+  bool send(const void *data, size_t size);
+
+  /*!
+   * @brief Sends a byte payload as one payload frame by gifting its pages
+   * to the pipe with `vmsplice(SPLICE_F_GIFT)`.
+   *
+   * Nothing is copied: the pipe keeps references to the user pages
+   * themselves, and the reader gets their contents as they are when it
+   * reads or splices them, which may be long after the call returned. The
+   * caller therefore gives the pages up and must not write to them again;
+   * memory from `mmap()` can simply be unmapped. The gift flag only lets a
+   * later `splice()` move whole, page-aligned pages on instead of copying
+   * them. Other conditions are as for send().
+   *
+   * @param buffer The payload, ideally page-aligned and a whole number of
+   * pages long so that the gift can be used.
+   * @param size The payload size in bytes.
+   * @return True if the payload was sent, false otherwise.
+   */
+  bool send_gift(void *buffer, size_t size);
+
+  /*!
+   * @brief Waits for the next payload frame and copies it into `out`.
+   *
+   * The frame must have been sent with send() or send_gift(); a message
+   * frame in its place is an error.
+   *
+   * @return True if a payload was received, false otherwise.
+   */
+  bool receive(std::vector<char> &out);
+
+  /*!
+   * @brief Waits for the next payload frame and moves its bytes to `out_fd`
+   * with `splice()`, without copying them through user space.
+   *
+   * Bytes already read ahead into the frame buffer are written normally.
+   *
+   * @param out_fd A file, socket or pipe open for writing. Files are
+   * written at their current offset.
+   * @param size Receives the payload size in bytes.
+   * @return True if the whole payload was written, false otherwise.
+   */
+  bool receive_to_fd(int out_fd, uint64_t &size);
+
+  /*!
+   * @brief Sets the capacity requested for the outgoing pipe with
+   * `F_SETPIPE_SZ`. Zero keeps the kernel default.
+   *
+   * Takes effect at once if the transport is initialized, otherwise on
+   * `initialize()`. Unprivileged processes are limited to
+   * /proc/sys/fs/pipe-max-size; larger requests are reduced to it.
+   *
+   * @return False if the capacity of an open pipe could not be changed.
+   */
+  bool set_pipe_size(size_t bytes);
+
+  /*!
+   * @brief Returns the capacity the outgoing pipe actually got, in bytes,
+   * or 0 before initialization.
+   */
+  size_t pipe_capacity() const;
+
+  /*!
+   * @brief Receives up to `max` messages.
+   *
+   * Waits for the first message, then decodes what is already buffered and
+   * whatever one more read can fetch without blocking.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*!
+   * @brief Returns the read end of the incoming pipe, or -1.
+   *
+   * Frames already buffered by receive_batch() do not make it readable;
+   * drain with try_receive() before polling.
+   */
+  int readiness_fd() override;
+
   /*!
    * @brief Cleans up resources associated with the named pipe transport.
    *
@@ -77,6 +255,29 @@ public:
   void cleanup() override;
 
 private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Writes `msgs` without coalescing; returns how many were sent. */
+  size_t write_batch(const IPCMessage *msgs, size_t count);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Reads the prefix of the next payload frame.
+   *
+   * @param size Receives the payload size.
+   * @return False on end of stream, error or a frame that is no payload.
+   */
+  bool receive_prefix(uint64_t &size);
+
+  /*! @brief Reads `length` bytes of the incoming stream into `out`. */
+  bool read_stream(char *out, size_t length);
+
+  /*! @brief Applies `requested_pipe_size` to the outgoing pipe. */
+  bool apply_pipe_size();
+
   /*! @brief The name of the first named pipe. */
   std::string pipe1_name;
 
@@ -99,6 +300,24 @@ private:
    * cleanup.
    */
   bool is_creator = false;
+
+  /*! @brief Reassembles frames from the read pipe. */
+  FrameReader reader;
+
+  /*! @brief The I/O backend chosen at construction. */
+  IOBackend backend;
+
+  /*! @brief The io_uring engine, or null with IOBackend::Syscalls. */
+  std::unique_ptr<UringStream> stream;
+
+  /*! @brief Messages held back by the coalescing policy. */
+  SendCoalescer coalescer;
+
+  /*! @brief Capacity requested for the outgoing pipe, or 0. */
+  size_t requested_pipe_size = 0;
+
+  /*! @brief Capacity of the outgoing pipe, or 0. */
+  size_t capacity = 0;
 };
 } // namespace ipc
 
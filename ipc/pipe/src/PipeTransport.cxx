@@ -1,8 +1,63 @@
 #include <PipeTransport.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
-ipc::PipeTransport::PipeTransport() = default;
+namespace {
+
+/*!
+ * @brief Opens a FIFO, retrying for up to `timeout_ms` while it does not
+ * exist yet.
+ */
+int open_fifo(const std::string &path, int flags, int timeout_ms) {
+  for (int waited = 0;; waited += 10) {
+    const int fd = open(path.c_str(), flags);
+    if (fd != -1 || (errno != ENOENT && errno != EINTR) ||
+        waited >= timeout_ms)
+      return fd;
+    usleep(10 * 1000);
+  }
+}
+
+/*! @brief Writes all `length` bytes of `buffer` to `fd`. */
+bool write_all(int fd, const char *buffer, size_t length) {
+  while (length > 0) {
+    const ssize_t written = write(fd, buffer, length);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("write");
+      return false;
+    }
+    buffer += written;
+    length -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+/*! @brief Returns /proc/sys/fs/pipe-max-size, or 0 if it cannot be read. */
+size_t pipe_max_size() {
+  FILE *file = fopen("/proc/sys/fs/pipe-max-size", "r");
+  if (!file)
+    return 0;
+  unsigned long size = 0;
+  if (fscanf(file, "%lu", &size) != 1)
+    size = 0;
+  fclose(file);
+  return size;
+}
+
+} // namespace
+
+ipc::PipeTransport::PipeTransport(IOBackend backend)
+    : backend(backend), coalescer([this](const IPCMessage *msgs, size_t count) {
+        return write_batch(msgs, count);
+      }) {}
 
 ipc::PipeTransport::~PipeTransport() { cleanup(); }
 
@@ -10,6 +65,7 @@ bool ipc::PipeTransport::initialize(const std::string &name, bool create) {
   is_creator = create;
   pipe1_name = "/tmp/" + name + "_pipe1";
   pipe2_name = "/tmp/" + name + "_pipe2";
+  reader.reset();
 
   if (create) {
     // Create the FIFOs
@@ -21,24 +77,284 @@ bool ipc::PipeTransport::initialize(const std::string &name, bool create) {
     read_fd = open(pipe2_name.c_str(), O_RDONLY);
   } else {
     // Child reads from pipe1, writes to pipe2
-    read_fd = open(pipe1_name.c_str(), O_RDONLY);
-    write_fd = open(pipe2_name.c_str(), O_WRONLY);
+    read_fd = open_fifo(pipe1_name, O_RDONLY, OPEN_TIMEOUT_MS);
+    write_fd = open_fifo(pipe2_name, O_WRONLY, OPEN_TIMEOUT_MS);
+  }
+
+  if (read_fd == -1 || write_fd == -1) {
+    perror("open fifo");
+    return false;
   }
+  // Best effort: pipe_capacity() reports what was granted.
+  apply_pipe_size();
 
-  return (read_fd != -1 && write_fd != -1);
+  if (backend == IOBackend::IoUring) {
+    stream = std::make_unique<UringStream>();
+    if (!stream->open(read_fd, write_fd, false)) {
+      cleanup();
+      return false;
+    }
+  }
+  return true;
 }
 
 bool ipc::PipeTransport::send_message(const IPCMessage &msg) {
-  ssize_t written = write(write_fd, &msg, sizeof(msg));
-  return written == sizeof(msg);
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
 }
 
 bool ipc::PipeTransport::receive_message(IPCMessage &msg) {
-  ssize_t read_bytes = read(read_fd, &msg, sizeof(msg));
-  return read_bytes == sizeof(msg);
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::PipeTransport::send_for(const IPCMessage &msg,
+                                            std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::PipeTransport::receive_for(IPCMessage &msg,
+                                               std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::PipeTransport::send_until(const IPCMessage &msg,
+                                              const Deadline &deadline) {
+  if (write_fd == -1)
+    return IPCStatus::Error;
+  if (coalescer.enabled()) {
+    return coalescer.add(msg) ? IPCStatus::Ok : IPCStatus::Error;
+  }
+  if (stream) {
+    size_t sent;
+    return stream->send(&msg, 1, deadline, sent);
+  }
+
+  // A frame is at most PIPE_BUF bytes, so once the pipe reports room the
+  // write completes without blocking.
+  const IPCStatus status = wait_fd(write_fd, POLLOUT, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char frame[MAX_FRAME_SIZE];
+  const size_t length = encode_frame(msg, frame);
+
+  ssize_t written;
+  while ((written = write(write_fd, frame, length)) < 0 && errno == EINTR) {
+  }
+  return written == static_cast<ssize_t>(length) ? IPCStatus::Ok
+                                                 : IPCStatus::Error;
+}
+
+ipc::IPCStatus ipc::PipeTransport::receive_until(IPCMessage &msg,
+                                                 const Deadline &deadline) {
+  if (read_fd == -1)
+    return IPCStatus::Error;
+  // The peer may be waiting for a held back message before it answers.
+  if (!flush())
+    return IPCStatus::Error;
+  if (stream)
+    return stream->receive(msg, deadline);
+
+  IPCStatus status = IPCStatus::Ok;
+  const bool received =
+      reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+        status = wait_fd(read_fd, POLLIN, deadline);
+        if (status != IPCStatus::Ok)
+          return -1;
+        ssize_t read_bytes;
+        while ((read_bytes = read(read_fd, buffer, length)) < 0 &&
+               errno == EINTR) {
+        }
+        if (read_bytes <= 0)
+          status = IPCStatus::Error;
+        return read_bytes;
+      });
+  if (received)
+    return IPCStatus::Ok;
+  return status == IPCStatus::Ok ? IPCStatus::Error : status;
+}
+
+size_t ipc::PipeTransport::send_batch(const IPCMessage *msgs, size_t count) {
+  if (!flush())
+    return 0;
+  return write_batch(msgs, count);
+}
+
+bool ipc::PipeTransport::set_coalescing(const CoalescingPolicy &policy) {
+  const bool flushed = flush();
+  coalescer.set_policy(policy);
+  return flushed;
+}
+
+bool ipc::PipeTransport::flush() { return coalescer.flush(); }
+
+size_t ipc::PipeTransport::write_batch(const IPCMessage *msgs, size_t count) {
+  size_t sent = 0;
+  if (stream) {
+    stream->send(msgs, count, Deadline::never(), sent);
+    return sent;
+  }
+
+  FrameBatch batch;
+  while (sent < count) {
+    const size_t added = batch.add(msgs + sent, count - sent);
+    if (!batch.write_all(write_fd))
+      break;
+    sent += added;
+  }
+  return sent;
+}
+
+size_t ipc::PipeTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+  if (stream)
+    return 1 + stream->receive_ready(msgs + 1, max - 1);
+
+  // Only read again if the pipe has data right now.
+  size_t received = 1;
+  while (received < max &&
+         reader.next(msgs[received], [this](char *buffer, size_t length) {
+           pollfd pfd{read_fd, POLLIN, 0};
+           if (poll(&pfd, 1, 0) != 1 || !(pfd.revents & POLLIN))
+             return ssize_t{0};
+           return read(read_fd, buffer, length);
+         }))
+    ++received;
+  return received;
+}
+
+bool ipc::PipeTransport::send(const void *data, size_t size) {
+  if (write_fd == -1 || stream || !flush())
+    return false;
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  encode_payload_prefix(size, prefix);
+  return write_all(write_fd, prefix, sizeof(prefix)) &&
+         write_all(write_fd, static_cast<const char *>(data), size);
+}
+
+bool ipc::PipeTransport::send_gift(void *buffer, size_t size) {
+  if (write_fd == -1 || stream || !flush())
+    return false;
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  encode_payload_prefix(size, prefix);
+  if (!write_all(write_fd, prefix, sizeof(prefix)))
+    return false;
+
+  // vmsplice() stops when the pipe is full and blocks only for the rest.
+  iovec iov{buffer, size};
+  while (iov.iov_len > 0) {
+    const ssize_t spliced = vmsplice(write_fd, &iov, 1, SPLICE_F_GIFT);
+    if (spliced < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("vmsplice");
+      return false;
+    }
+    iov.iov_base = static_cast<char *>(iov.iov_base) + spliced;
+    iov.iov_len -= static_cast<size_t>(spliced);
+  }
+  return true;
+}
+
+bool ipc::PipeTransport::receive(std::vector<char> &out) {
+  uint64_t size = 0;
+  if (!receive_prefix(size) || size > MAX_PAYLOAD_SIZE)
+    return false;
+  out.resize(size);
+  return read_stream(out.data(), size);
+}
+
+bool ipc::PipeTransport::receive_to_fd(int out_fd, uint64_t &size) {
+  if (!receive_prefix(size))
+    return false;
+
+  // Whatever was read ahead with the prefix has left the pipe already.
+  uint64_t remaining = size;
+  char chunk[4096];
+  while (remaining > 0 && reader.buffered() > 0) {
+    const size_t length = static_cast<size_t>(
+        std::min<uint64_t>({sizeof(chunk), reader.buffered(), remaining}));
+    read_stream(chunk, length);
+    if (!write_all(out_fd, chunk, length))
+      return false;
+    remaining -= length;
+  }
+
+  while (remaining > 0) {
+    const ssize_t moved =
+        splice(read_fd, nullptr, out_fd, nullptr,
+               static_cast<size_t>(std::min<uint64_t>(remaining, INT_MAX)),
+               SPLICE_F_MOVE);
+    if (moved <= 0) {
+      if (moved < 0 && errno == EINTR)
+        continue;
+      // Zero means the writer went away in the middle of the payload.
+      perror("splice");
+      return false;
+    }
+    remaining -= static_cast<uint64_t>(moved);
+  }
+  return true;
+}
+
+bool ipc::PipeTransport::set_pipe_size(size_t bytes) {
+  requested_pipe_size = bytes;
+  return write_fd == -1 || apply_pipe_size();
+}
+
+size_t ipc::PipeTransport::pipe_capacity() const { return capacity; }
+
+bool ipc::PipeTransport::receive_prefix(uint64_t &size) {
+  if (read_fd == -1 || stream || !flush())
+    return false;
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  return read_stream(prefix, sizeof(prefix)) &&
+         decode_payload_prefix(prefix, size);
+}
+
+bool ipc::PipeTransport::read_stream(char *out, size_t length) {
+  const int fd = read_fd;
+  return reader.read(out, length, [fd](char *buffer, size_t size) {
+    ssize_t read_bytes;
+    while ((read_bytes = read(fd, buffer, size)) < 0 && errno == EINTR) {
+    }
+    return read_bytes;
+  });
+}
+
+bool ipc::PipeTransport::apply_pipe_size() {
+  bool applied = true;
+  if (requested_pipe_size > 0) {
+    const int size =
+        static_cast<int>(std::min<size_t>(requested_pipe_size, INT_MAX));
+    if (fcntl(write_fd, F_SETPIPE_SZ, size) < 0) {
+      // Without CAP_SYS_RESOURCE the system limit is as far as it goes.
+      const bool limited = errno == EPERM;
+      const int limit = static_cast<int>(
+          std::min<size_t>(pipe_max_size(), INT_MAX));
+      applied = limited && limit > 0 &&
+                fcntl(write_fd, F_SETPIPE_SZ, std::min(size, limit)) >= 0;
+      if (!applied)
+        perror("fcntl(F_SETPIPE_SZ)");
+    }
+  }
+  const int current = fcntl(write_fd, F_GETPIPE_SZ);
+  capacity = current > 0 ? static_cast<size_t>(current) : 0;
+  return applied;
+}
+
+int ipc::PipeTransport::readiness_fd() {
+  return stream ? stream->fd() : read_fd;
 }
 
 void ipc::PipeTransport::cleanup() {
+  // Messages still held back are dropped; flush() first to deliver them.
+  coalescer.clear();
+  // The stream must let go of the pipes before they are closed.
+  stream.reset();
   if (read_fd != -1) {
     close(read_fd);
     read_fd = -1;
@@ -47,6 +363,7 @@ void ipc::PipeTransport::cleanup() {
     close(write_fd);
     write_fd = -1;
   }
+  capacity = 0;
   if (is_creator) {
     unlink(pipe1_name.c_str());
     unlink(pipe2_name.c_str());
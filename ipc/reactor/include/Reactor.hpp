@@ -0,0 +1,169 @@
+#ifndef IPC_REACTOR_HPP
+#define IPC_REACTOR_HPP
+
+#include <IIPCTransport.hpp> // For IIPCTransport and IPCStatus
+#include <atomic>            // For std::atomic
+#include <cstddef>           // For size_t
+#include <functional>        // For std::function
+#include <memory>            // For std::unique_ptr
+#include <unordered_map>     // For the registered transports
+#include <vector>            // For the ready and retired lists
+
+namespace ipc {
+
+/*!
+ * @brief Multiplexes any number of transports on one thread with a single
+ * `epoll_wait()`.
+ *
+ * Each transport is registered edge-triggered through its `readiness_fd()`.
+ * A transport without one is polled instead: while any is registered, the
+ * reactor wakes at least every POLL_INTERVAL_MS and tries each of them.
+ * On a wake-up the reactor drains the transport with `try_receive()` until
+ * it reports IPCStatus::WouldBlock, which re-arms the descriptor, and hands
+ * the messages to the transport's handler in batches of up to BATCH_SIZE.
+ * A transport that still has messages after DRAIN_LIMIT of them goes back
+ * on the ready list, so one busy channel cannot starve the others.
+ *
+ * The reactor does not own the transports; they must outlive their
+ * registration. Only `stop()` may be called from another thread.
+ */
+class Reactor {
+public:
+  /*!
+   * @brief Called with each batch of received messages.
+   *
+   * A call with `count == 0` reports that the transport failed or its peer
+   * went away; it has already been removed from the reactor.
+   *
+   * @param transport The transport the messages came from.
+   * @param msgs The received messages, valid for the duration of the call.
+   * @param count The number of messages.
+   */
+  using Handler = std::function<void(IIPCTransport &transport,
+                                     const IPCMessage *msgs, size_t count)>;
+
+  /*! @brief Most messages passed to a handler in one call. */
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /*! @brief Most messages taken from one transport per dispatch round. */
+  static constexpr size_t DRAIN_LIMIT = 1024;
+
+  /*! @brief Most epoll events collected per `epoll_wait()`. */
+  static constexpr int MAX_EVENTS = 64;
+
+  /*! @brief Longest wait between tries of transports without a descriptor. */
+  static constexpr int POLL_INTERVAL_MS = 1;
+
+  /*! @brief Constructs a reactor with no epoll instance yet. */
+  Reactor() = default;
+
+  /*! @brief Calls `cleanup()`. */
+  ~Reactor();
+
+  Reactor(const Reactor &) = delete;
+  Reactor &operator=(const Reactor &) = delete;
+
+  /*!
+   * @brief Creates the epoll instance and the descriptor `stop()` uses to
+   * wake it.
+   *
+   * @return True on success, false otherwise.
+   */
+  bool initialize();
+
+  /*!
+   * @brief Registers `transport` and dispatches its messages to `handler`.
+   *
+   * Messages already queued are dispatched on the next `run_once()`.
+   * Callable from a handler.
+   *
+   * @return False if the reactor is not initialized, the transport is
+   * already registered, or epoll fails.
+   */
+  bool add(IIPCTransport &transport, Handler handler);
+
+  /*!
+   * @brief Unregisters `transport`. Callable from a handler, including the
+   * transport's own.
+   *
+   * @return False if the transport was not registered.
+   */
+  bool remove(IIPCTransport &transport);
+
+  /*! @brief Returns the number of registered transports. */
+  size_t size() const;
+
+  /*!
+   * @brief Waits for ready transports and dispatches their messages.
+   *
+   * Does not wait if a transport is still ready from an earlier round, and
+   * waits at most POLL_INTERVAL_MS while polled transports are registered.
+   *
+   * @param timeout_ms How long to wait, or -1 to wait indefinitely.
+   * @return The number of messages dispatched, or -1 on failure.
+   */
+  long run_once(int timeout_ms = -1);
+
+  /*!
+   * @brief Calls `run_once()` until `stop()` is called or it fails.
+   *
+   * A `stop()` that precedes `run()` makes it return at once.
+   *
+   * @return True if stopped, false on failure.
+   */
+  bool run();
+
+  /*! @brief Makes `run()` return. Safe to call from any thread. */
+  void stop();
+
+  /*! @brief Unregisters every transport and closes the epoll instance. */
+  void cleanup();
+
+private:
+  /*! @brief A registered transport. */
+  struct Entry {
+    IIPCTransport *transport;
+    Handler handler;
+    /*! @brief The readiness descriptor, or -1 if the entry is polled. */
+    int fd;
+    /*! @brief True while the entry is on `ready`. */
+    bool queued = false;
+    /*! @brief True once removed; the entry is freed after the round. */
+    bool removed = false;
+  };
+
+  /*! @brief Puts `entry` on the ready list unless it is already there. */
+  void mark_ready(Entry *entry);
+
+  /*!
+   * @brief Drains up to DRAIN_LIMIT messages from `entry`.
+   *
+   * @return The number of messages dispatched.
+   */
+  size_t drain(Entry *entry);
+
+  /*! @brief The epoll instance. */
+  int epoll_fd = -1;
+
+  /*! @brief Eventfd written by `stop()`. */
+  int wake_fd = -1;
+
+  /*! @brief Set by `stop()`, consumed by `run()`. */
+  std::atomic<bool> stopping{false};
+
+  /*! @brief Registered transports. */
+  std::unordered_map<IIPCTransport *, std::unique_ptr<Entry>> entries;
+
+  /*! @brief Registered transports without a readiness descriptor. */
+  std::vector<Entry *> polled;
+
+  /*! @brief Entries with messages possibly pending, in dispatch order. */
+  std::vector<Entry *> ready;
+
+  /*! @brief Removed entries, freed once no handler can refer to them. */
+  std::vector<std::unique_ptr<Entry>> retired;
+};
+
+} // namespace ipc
+
+#endif // IPC_REACTOR_HPP
@@ -0,0 +1,200 @@
+#include <Reactor.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+ipc::Reactor::~Reactor() { cleanup(); }
+
+bool ipc::Reactor::initialize() {
+  cleanup();
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    perror("epoll_create1");
+    return false;
+  }
+  wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd == -1) {
+    perror("eventfd");
+    cleanup();
+    return false;
+  }
+
+  // The wake-up descriptor is the only one registered with a null pointer.
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.ptr = nullptr;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == -1) {
+    perror("epoll_ctl");
+    cleanup();
+    return false;
+  }
+  return true;
+}
+
+bool ipc::Reactor::add(IIPCTransport &transport, Handler handler) {
+  if (epoll_fd == -1 || entries.count(&transport))
+    return false;
+
+  auto entry = std::make_unique<Entry>();
+  entry->transport = &transport;
+  entry->handler = std::move(handler);
+  entry->fd = transport.readiness_fd();
+
+  if (entry->fd == -1) {
+    polled.push_back(entry.get());
+  } else {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = entry.get();
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, entry->fd, &event) == -1) {
+      perror("epoll_ctl");
+      return false;
+    }
+  }
+
+  // Messages queued before registration raise no edge, so drain once.
+  mark_ready(entry.get());
+  entries.emplace(&transport, std::move(entry));
+  return true;
+}
+
+bool ipc::Reactor::remove(IIPCTransport &transport) {
+  auto it = entries.find(&transport);
+  if (it == entries.end())
+    return false;
+
+  // The descriptor may already be closed, which removed it from epoll.
+  if (it->second->fd != -1)
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+  else
+    polled.erase(std::find(polled.begin(), polled.end(), it->second.get()));
+  it->second->removed = true;
+  retired.push_back(std::move(it->second));
+  entries.erase(it);
+  return true;
+}
+
+size_t ipc::Reactor::size() const { return entries.size(); }
+
+long ipc::Reactor::run_once(int timeout_ms) {
+  if (epoll_fd == -1)
+    return -1;
+
+  int wait_ms = ready.empty() ? timeout_ms : 0;
+  if (!polled.empty() && (wait_ms == -1 || wait_ms > POLL_INTERVAL_MS))
+    wait_ms = POLL_INTERVAL_MS;
+
+  epoll_event events[MAX_EVENTS];
+  int count;
+  while ((count = epoll_wait(epoll_fd, events, MAX_EVENTS, wait_ms)) == -1 &&
+         errno == EINTR) {
+  }
+  if (count == -1) {
+    perror("epoll_wait");
+    return -1;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    if (events[i].data.ptr) {
+      mark_ready(static_cast<Entry *>(events[i].data.ptr));
+    } else {
+      uint64_t value;
+      ssize_t ignored = read(wake_fd, &value, sizeof(value));
+      (void)ignored;
+    }
+  }
+  for (Entry *entry : polled)
+    mark_ready(entry);
+
+  // Handlers may add and remove transports, so dispatch from a snapshot.
+  std::vector<Entry *> round;
+  round.swap(ready);
+  long dispatched = 0;
+  for (Entry *entry : round) {
+    entry->queued = false;
+    if (!entry->removed)
+      dispatched += static_cast<long>(drain(entry));
+  }
+  ready.erase(std::remove_if(ready.begin(), ready.end(),
+                             [](Entry *entry) { return entry->removed; }),
+              ready.end());
+  retired.clear();
+  return dispatched;
+}
+
+bool ipc::Reactor::run() {
+  while (!stopping.exchange(false, std::memory_order_acq_rel)) {
+    if (run_once(-1) < 0)
+      return false;
+  }
+  return true;
+}
+
+void ipc::Reactor::stop() {
+  stopping.store(true, std::memory_order_release);
+  if (wake_fd != -1) {
+    const uint64_t one = 1;
+    ssize_t ignored = write(wake_fd, &one, sizeof(one));
+    (void)ignored;
+  }
+}
+
+void ipc::Reactor::cleanup() {
+  entries.clear();
+  polled.clear();
+  ready.clear();
+  retired.clear();
+  if (wake_fd != -1) {
+    close(wake_fd);
+    wake_fd = -1;
+  }
+  if (epoll_fd != -1) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+}
+
+void ipc::Reactor::mark_ready(Entry *entry) {
+  if (entry->queued || entry->removed)
+    return;
+  entry->queued = true;
+  ready.push_back(entry);
+}
+
+size_t ipc::Reactor::drain(Entry *entry) {
+  IPCMessage batch[BATCH_SIZE];
+  size_t total = 0;
+
+  while (total < DRAIN_LIMIT) {
+    size_t count = 0;
+    IPCStatus status = IPCStatus::Ok;
+    while (count < BATCH_SIZE &&
+           (status = entry->transport->try_receive(batch[count])) ==
+               IPCStatus::Ok)
+      ++count;
+
+    if (count > 0) {
+      entry->handler(*entry->transport, batch, count);
+      total += count;
+      if (entry->removed)
+        return total;
+    }
+    if (status == IPCStatus::WouldBlock)
+      return total;
+    if (status == IPCStatus::Error) {
+      // The entry stays alive on `retired` until the round ends.
+      remove(*entry->transport);
+      entry->handler(*entry->transport, nullptr, 0);
+      return total;
+    }
+  }
+
+  // Not drained yet: the edge was consumed, so revisit it next round.
+  mark_ready(entry);
+  return total;
+}
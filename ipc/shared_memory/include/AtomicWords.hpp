@@ -0,0 +1,49 @@
+#ifndef IPC_ATOMIC_WORDS_HPP
+#define IPC_ATOMIC_WORDS_HPP
+
+#include <atomic>  // For std::atomic
+#include <cstddef> // For size_t
+#include <cstdint> // For uint64_t
+#include <cstring> // For memcpy
+
+namespace ipc {
+
+/*!
+ * @brief Storage for a trivially copyable value that a writer may overwrite
+ * while readers copy it.
+ *
+ * Seqlock-style readers validate their copy afterwards and retry on a torn
+ * read, but the copy itself must not be a data race. Storing the value as
+ * relaxed atomic 64-bit words keeps it race-free without costing more than
+ * plain moves on common architectures.
+ *
+ * @tparam T A trivially copyable type.
+ */
+template <typename T> struct AtomicWords {
+  /*! @brief Number of 64-bit words needed to hold a T. */
+  static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) /
+                                  sizeof(uint64_t);
+
+  /*! @brief The value, split into words. */
+  std::atomic<uint64_t> words[WORDS];
+
+  /*! @brief Stores `value` word by word with relaxed ordering. */
+  void store(const T &value) {
+    uint64_t buffer[WORDS] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+    for (size_t i = 0; i < WORDS; ++i)
+      words[i].store(buffer[i], std::memory_order_relaxed);
+  }
+
+  /*! @brief Loads the value word by word with relaxed ordering. */
+  void load(T &value) const {
+    uint64_t buffer[WORDS];
+    for (size_t i = 0; i < WORDS; ++i)
+      buffer[i] = words[i].load(std::memory_order_relaxed);
+    std::memcpy(&value, buffer, sizeof(T));
+  }
+};
+
+} // namespace ipc
+
+#endif // IPC_ATOMIC_WORDS_HPP
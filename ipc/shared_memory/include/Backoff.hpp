@@ -0,0 +1,53 @@
+#ifndef IPC_BACKOFF_HPP
+#define IPC_BACKOFF_HPP
+
+#include <sched.h> // For sched_yield
+
+namespace ipc {
+
+/*!
+ * @brief Hints the CPU that the caller is busy-waiting.
+ *
+ * Emits `pause` on x86 and `yield` on ARM, which reduces power use and the
+ * penalty of leaving the spin loop. Compiles to nothing elsewhere.
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/*!
+ * @brief Spin-then-yield backoff for lock-free retry loops.
+ *
+ * The first `SPIN_LIMIT` calls to `pause()` only relax the CPU; later calls
+ * give the rest of the time slice away with `sched_yield()`.
+ */
+class Backoff {
+public:
+  /*! @brief Number of relaxed spins before the backoff starts yielding. */
+  static constexpr unsigned SPIN_LIMIT = 128;
+
+  /*! @brief Waits a little before the caller retries. */
+  void pause() {
+    if (spins < SPIN_LIMIT) {
+      ++spins;
+      cpu_relax();
+    } else {
+      sched_yield();
+    }
+  }
+
+  /*! @brief Restarts the spin phase, e.g. after the caller made progress. */
+  void reset() { spins = 0; }
+
+private:
+  /*! @brief Number of spins performed since the last reset. */
+  unsigned spins = 0;
+};
+
+} // namespace ipc
+
+#endif // IPC_BACKOFF_HPP
@@ -0,0 +1,142 @@
+#ifndef IPC_DOORBELL_HPP
+#define IPC_DOORBELL_HPP
+
+#include <WaitStrategy.hpp> // For WaitPoint
+#include <atomic>           // For std::atomic
+#include <cstddef>          // For size_t
+#include <cstdint>          // For uint64_t
+#include <string>           // For std::string
+#include <unistd.h>         // For write
+
+namespace ipc {
+
+/*!
+ * @brief A pollable wake-up for a consumer that waits in an event loop rather
+ * than on a WaitPoint.
+ *
+ * It only costs a system call while the consumer is armed: the consumer
+ * calls `arm()` after finding its queue empty, re-checks the queue, and then
+ * polls `fd()`. A producer calls `ring()` after `notify()`; it writes only if
+ * it finds the consumer armed, and disarms it.
+ *
+ * The doorbell is either an eventfd handed over by `adopt()`, for peers that
+ * share a channel to pass descriptors over, or a named FIFO. The FIFO is
+ * only created once the consumer asks for `listen()`, and the producer
+ * opens it when it first finds the consumer armed and unlinks it right
+ * away, so it exists in the file system only while both sides set up.
+ */
+class Doorbell {
+public:
+  /*! @brief Constructs a closed doorbell. */
+  Doorbell() = default;
+
+  /*! @brief Closes the doorbell and unlinks its FIFO if still present. */
+  ~Doorbell();
+
+  Doorbell(const Doorbell &) = delete;
+  Doorbell &operator=(const Doorbell &) = delete;
+
+  /*!
+   * @brief Takes ownership of the eventfd `fd` as the doorbell.
+   *
+   * Both peers adopt descriptors of the same eventfd.
+   */
+  void adopt(int fd);
+
+  /*!
+   * @brief Selects the FIFO at `path` as the doorbell without creating or
+   * opening it.
+   */
+  void bind(const std::string &path);
+
+  /*!
+   * @brief Returns the descriptor the consumer polls, creating and opening
+   * the bound FIFO on first use.
+   *
+   * @return The descriptor, or -1 if neither adopted nor bound, or on
+   * failure.
+   */
+  int listen();
+
+  /*! @brief Closes the doorbell and unlinks its FIFO if still present. */
+  void close();
+
+  /*! @brief Returns the descriptor to poll for readability, or -1. */
+  int fd() const { return doorbell_fd; }
+
+  /*!
+   * @brief Consumes pending rings and marks the consumer as waiting for the
+   * doorbell by setting the shared flag `armed`.
+   *
+   * The caller must check its queue again afterwards: anything published
+   * before the arm is not announced by the doorbell.
+   */
+  void arm(std::atomic<uint32_t> &armed);
+
+  /*! @brief Arms the consumer of `point`. */
+  void arm(WaitPoint &point) { arm(point.doorbell_armed); }
+
+  /*!
+   * @brief Rings the doorbell if the shared flag `armed` is set.
+   *
+   * The publication must be ordered before the check, by a fence or by the
+   * lock that also guards the consumer's arm. The FIFO is opened before the
+   * consumer is disarmed, so if that fails the consumer stays armed and the
+   * next ring tries again.
+   */
+  void ring(std::atomic<uint32_t> &armed) {
+    if (armed.load(std::memory_order_relaxed) != 0 &&
+        (doorbell_fd != -1 || open_bound()) &&
+        armed.exchange(0, std::memory_order_acq_rel) != 0) {
+      // A full FIFO or eventfd is already readable, so EAGAIN needs no
+      // handling.
+      const uint64_t one = 1;
+      ssize_t ignored = write(doorbell_fd, &one, counter ? sizeof(one) : 1);
+      (void)ignored;
+    }
+  }
+
+  /*!
+   * @brief Rings the doorbell if the consumer of `point` is armed.
+   *
+   * Call after `point.notify()`, whose fence orders the publication before
+   * the check.
+   */
+  void ring(WaitPoint &point) { ring(point.doorbell_armed); }
+
+  /*!
+   * @brief Returns the FIFO path used for doorbell `index` of the segment
+   * `name`.
+   */
+  static std::string path_for(const std::string &name, int index);
+
+  /*!
+   * @brief Creates `count` non-blocking eventfds for `adopt()`.
+   *
+   * @return False, with none left open, if any could not be created.
+   */
+  static bool make_eventfds(int *fds, size_t count);
+
+private:
+  /*!
+   * @brief Opens the FIFO the consumer created and unlinks it, since both
+   * sides hold it open from now on.
+   */
+  bool open_bound();
+
+  /*! @brief The FIFO or eventfd descriptor, non-blocking. */
+  int doorbell_fd = -1;
+
+  /*! @brief True if the descriptor is an eventfd rather than a FIFO. */
+  bool counter = false;
+
+  /*! @brief Path of the FIFO, empty for an eventfd. */
+  std::string path;
+
+  /*! @brief True if this instance created the FIFO. */
+  bool owner = false;
+};
+
+} // namespace ipc
+
+#endif // IPC_DOORBELL_HPP
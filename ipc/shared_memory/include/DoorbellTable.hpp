@@ -0,0 +1,127 @@
+#ifndef IPC_DOORBELL_TABLE_HPP
+#define IPC_DOORBELL_TABLE_HPP
+
+#include <Doorbell.hpp> // For the FIFO of each reader
+#include <atomic>       // For std::atomic
+#include <cstdint>      // For fixed-width integer types
+#include <string>       // For std::string
+
+namespace ipc {
+
+/*! @brief One reader's entry in a DoorbellTable. */
+struct DoorbellSlot {
+  /*! @brief Process ID of the reader holding the slot, or 0 if free. */
+  std::atomic<uint32_t> owner;
+
+  /*! @brief Bumped whenever the slot is claimed, so writers reopen. */
+  std::atomic<uint32_t> generation;
+
+  /*! @brief Non-zero while the reader waits on its doorbell. */
+  std::atomic<uint32_t> armed;
+};
+
+/*!
+ * @brief Doorbells of the readers of a multi-reader segment, placed in
+ * shared memory next to the queue.
+ *
+ * `armed_count` counts the armed slots, so a writer pays one load, and no
+ * system call, while no reader waits in an event loop.
+ */
+struct DoorbellTable {
+  /*! @brief Maximum number of readers polling doorbells at the same time. */
+  static constexpr unsigned MAX_READERS = 64;
+
+  /*! @brief Number of slots whose `armed` flag is set. */
+  std::atomic<uint32_t> armed_count;
+
+  /*! @brief One slot per polling reader. */
+  DoorbellSlot slots[MAX_READERS];
+
+  /*! @brief Clears the table in freshly mapped memory. */
+  void init();
+};
+
+/*!
+ * @brief A process's handle on a DoorbellTable: the doorbell of its own
+ * slot as a reader, and the descriptors it rings as a writer.
+ *
+ * Works like Doorbell, but for queues with any number of readers. A reader
+ * claims a slot and its FIFO only when it asks for `listen()`, and gives
+ * both up in `close()`. Slots of readers that died are reclaimed. The FIFOs
+ * stay linked while their reader lives, because writers may come and go.
+ */
+class ReaderDoorbells {
+public:
+  /*! @brief Constructs a handle bound to no table. */
+  ReaderDoorbells();
+
+  /*! @brief Releases the slot and closes every descriptor. */
+  ~ReaderDoorbells();
+
+  ReaderDoorbells(const ReaderDoorbells &) = delete;
+  ReaderDoorbells &operator=(const ReaderDoorbells &) = delete;
+
+  /*!
+   * @brief Selects the table in the segment `name` without claiming a slot.
+   */
+  void bind(DoorbellTable *table, const std::string &name);
+
+  /*!
+   * @brief Returns this reader's descriptor, claiming a slot and creating
+   * its FIFO on first use.
+   *
+   * @return The descriptor, or -1 if unbound, every slot is taken or on
+   * failure.
+   */
+  int listen();
+
+  /*!
+   * @brief Consumes pending rings and marks this reader as waiting.
+   *
+   * As with Doorbell, the caller must check its queue again afterwards.
+   */
+  void arm();
+
+  /*!
+   * @brief Rings every armed reader.
+   *
+   * Call after the WaitPoint's `notify()`, whose fence orders the
+   * publication before the check.
+   */
+  void ring() {
+    if (table && table->armed_count.load(std::memory_order_relaxed) != 0)
+      ring_armed();
+  }
+
+  /*! @brief Releases the slot, closes every descriptor and unbinds. */
+  void close();
+
+private:
+  /*! @brief Slow path of `ring()`. */
+  void ring_armed();
+
+  /*! @brief Returns a descriptor for writing to `slot`'s FIFO, or -1. */
+  int writer_fd(unsigned slot);
+
+  /*! @brief The shared table, or nullptr while unbound. */
+  DoorbellTable *table = nullptr;
+
+  /*! @brief Segment name the FIFO paths derive from. */
+  std::string name;
+
+  /*! @brief Index of the slot this reader claimed, or -1. */
+  int own_slot = -1;
+
+  /*! @brief The FIFO of `own_slot`. */
+  Doorbell own;
+
+  /*! @brief Descriptors opened for ringing other readers, or -1. */
+  int writer_fds[DoorbellTable::MAX_READERS];
+
+  /*! @brief Slot generation each of `writer_fds` was opened for. */
+  uint32_t writer_generations[DoorbellTable::MAX_READERS];
+};
+
+} // namespace ipc
+
+#endif // IPC_DOORBELL_TABLE_HPP
@@ -0,0 +1,61 @@
+#ifndef IPC_FD_PASSING_HPP
+#define IPC_FD_PASSING_HPP
+
+#include <string>     // For std::string
+#include <sys/socket.h> // For socklen_t
+#include <sys/un.h>     // For sockaddr_un
+
+namespace ipc {
+
+/*!
+ * @brief Fills `address` and `length` with the abstract address `name`.
+ *
+ * Abstract addresses start with a NUL byte and are not NUL-terminated, so
+ * `name` may be at most 107 bytes long.
+ *
+ * @return False, leaving `address` unusable, if `name` is empty or too long.
+ */
+bool make_abstract_address(const std::string &name, sockaddr_un &address,
+                           socklen_t &length);
+
+/*!
+ * @brief Creates an AF_UNIX stream socket listening on an abstract address.
+ *
+ * Abstract addresses live outside the file system, so nothing is left
+ * behind if the process crashes.
+ *
+ * @param name The address without the leading NUL byte.
+ * @return The listening socket, or -1 if `name` is too long or on failure.
+ */
+int listen_abstract(const std::string &name);
+
+/*!
+ * @brief Connects an AF_UNIX stream socket to an abstract address.
+ *
+ * Retries for up to `timeout_ms` milliseconds while nobody listens yet, so
+ * the connecting process may start before the listening one.
+ *
+ * @param name The address without the leading NUL byte.
+ * @param timeout_ms How long to keep retrying, in milliseconds.
+ * @return The connected socket, or -1 if `name` is too long or on failure.
+ */
+int connect_abstract(const std::string &name, int timeout_ms);
+
+/*!
+ * @brief Sends a file descriptor over a connected AF_UNIX socket with
+ * SCM_RIGHTS.
+ *
+ * @return True on success, false otherwise.
+ */
+bool send_descriptor(int socket_fd, int fd);
+
+/*!
+ * @brief Receives a file descriptor sent with `send_descriptor()`.
+ *
+ * @return The received descriptor (close-on-exec), or -1 on failure.
+ */
+int receive_descriptor(int socket_fd);
+
+} // namespace ipc
+
+#endif // IPC_FD_PASSING_HPP
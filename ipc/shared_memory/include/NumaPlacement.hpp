@@ -0,0 +1,63 @@
+#ifndef IPC_NUMA_PLACEMENT_HPP
+#define IPC_NUMA_PLACEMENT_HPP
+
+#include <cstddef> // For size_t
+#include <vector>  // For the list of nodes
+
+namespace ipc {
+
+/*!
+ * @brief Returns the number of NUMA nodes with memory, or 1 if the system
+ * does not expose NUMA topology.
+ */
+int numa_node_count();
+
+/*!
+ * @brief Returns the IDs of the NUMA nodes with memory in ascending order,
+ * or just node 0 if the system does not expose NUMA topology.
+ *
+ * Node IDs need not be dense, so pick nodes from this list rather than
+ * counting up to numa_node_count().
+ */
+std::vector<int> numa_nodes();
+
+/*!
+ * @brief Returns the NUMA node the calling thread is currently running on,
+ * or -1 if it cannot be determined.
+ */
+int current_numa_node();
+
+/*!
+ * @brief Returns the NUMA node backing the page at `addr`, or -1 if it
+ * cannot be determined.
+ *
+ * The page is faulted in if it is not resident yet, so query only pages
+ * that are about to be touched anyway.
+ */
+int numa_node_of(const void *addr);
+
+/*!
+ * @brief Binds the pages of [addr, addr + size) to NUMA node `node` with
+ * `mbind(MPOL_BIND)`, moving any pages already placed elsewhere.
+ *
+ * For shared memory the policy is stored with the object, so it also
+ * governs pages first touched by other processes.
+ *
+ * @return True on success, false otherwise.
+ */
+bool bind_memory_to_node(void *addr, size_t size, int node);
+
+/*!
+ * @brief Runs the calling thread on the CPUs of NUMA node `node` and makes
+ * the node its preferred node for new allocations.
+ *
+ * Use it on the thread that consumes a segment bound with
+ * ShmSegmentOptions::numa_node so that it reads local memory.
+ *
+ * @return True if the CPU affinity was set, false otherwise.
+ */
+bool bind_thread_to_node(int node);
+
+} // namespace ipc
+
+#endif // IPC_NUMA_PLACEMENT_HPP
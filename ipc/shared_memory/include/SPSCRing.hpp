@@ -0,0 +1,215 @@
+#ifndef IPC_SPSC_RING_HPP
+#define IPC_SPSC_RING_HPP
+
+#include <algorithm> // For std::min
+#include <atomic>    // For std::atomic head/tail indices
+#include <cstddef>   // For size_t
+#include <cstdint>   // For fixed-width integer types
+
+namespace ipc {
+
+/*! @brief Assumed size of a CPU cache line, used to pad shared indices. */
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/*! @brief Largest queue capacity: the biggest power of two in a uint32_t. */
+constexpr uint32_t MAX_QUEUE_CAPACITY = uint32_t(1) << 31;
+
+/*!
+ * @brief Rounds a requested queue capacity up to a power of two, at least 2.
+ *
+ * @return The capacity, or 0 if `value` exceeds MAX_QUEUE_CAPACITY.
+ */
+constexpr uint32_t round_up_pow2(uint32_t value) {
+  if (value > MAX_QUEUE_CAPACITY)
+    return 0;
+  uint32_t result = 2;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+/*!
+ * @brief A lock-free single-producer/single-consumer ring placed in shared
+ * memory.
+ *
+ * The ring header is followed in memory by `capacity` cache-line aligned
+ * slots, so the whole ring occupies `bytes_for(capacity)` bytes and can be
+ * carved out of a mapped segment with placement. The producer owns `head`
+ * and the consumer owns `tail`; each index lives on its own cache line
+ * together with a private copy of the peer's index, so the two sides only
+ * touch each other's line when the cached view says the ring is full or
+ * empty.
+ *
+ * @tparam T A trivially copyable element type.
+ */
+template <typename T> struct SPSCRing {
+  /*! @brief A single element padded to a whole number of cache lines. */
+  struct alignas(CACHE_LINE_SIZE) Slot {
+    T value;
+  };
+
+  /*! @brief Index of the next slot to be written. Owned by the producer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;
+
+  /*! @brief Producer's last observed value of `tail`. */
+  uint64_t cached_tail;
+
+  /*! @brief Index of the next slot to be read. Owned by the consumer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail;
+
+  /*! @brief Consumer's last observed value of `head`. */
+  uint64_t cached_head;
+
+  /*! @brief Number of slots. Always a power of two. */
+  alignas(CACHE_LINE_SIZE) uint64_t capacity;
+
+  /*! @brief `capacity - 1`, used to wrap indices. */
+  uint64_t mask;
+
+  /*!
+   * @brief Returns the number of bytes needed for a ring of `capacity` slots.
+   *
+   * @param capacity The number of slots. Must be a power of two.
+   */
+  static constexpr size_t bytes_for(size_t capacity) {
+    return sizeof(SPSCRing) + capacity * sizeof(Slot);
+  }
+
+  /*!
+   * @brief Initializes a ring in freshly mapped memory.
+   *
+   * Must be called exactly once by the creator before any peer attaches.
+   *
+   * @param slots The number of slots. Must be a power of two.
+   */
+  void init(size_t slots) {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    cached_tail = 0;
+    cached_head = 0;
+    capacity = slots;
+    mask = slots - 1;
+  }
+
+  /*! @brief Returns the first slot, located directly after the header. */
+  Slot *slots() { return reinterpret_cast<Slot *>(this + 1); }
+
+  /*!
+   * @brief Returns the next free slot for in-place construction.
+   *
+   * The slot is not visible to the consumer until `commit()` is called.
+   *
+   * @return A pointer to the slot, or nullptr if the ring is full.
+   */
+  T *producer_slot() {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - cached_tail == capacity) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if (h - cached_tail == capacity)
+        return nullptr;
+    }
+    return &slots()[h & mask].value;
+  }
+
+  /*! @brief Publishes the slot returned by `producer_slot()`. */
+  void commit() {
+    head.store(head.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  /*!
+   * @brief Returns the oldest published slot for in-place reading.
+   *
+   * The slot stays owned by the consumer until `release()` is called.
+   *
+   * @return A pointer to the slot, or nullptr if the ring is empty.
+   */
+  const T *consumer_slot() {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t == cached_head) {
+      cached_head = head.load(std::memory_order_acquire);
+      if (t == cached_head)
+        return nullptr;
+    }
+    return &slots()[t & mask].value;
+  }
+
+  /*! @brief Returns the slot obtained from `consumer_slot()` to the producer. */
+  void release() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  /*!
+   * @brief Copies `value` into the ring without blocking.
+   *
+   * @return True if the element was published, false if the ring is full.
+   */
+  bool try_push(const T &value) {
+    T *slot = producer_slot();
+    if (!slot)
+      return false;
+    *slot = value;
+    commit();
+    return true;
+  }
+
+  /*!
+   * @brief Copies the oldest element out of the ring without blocking.
+   *
+   * @return True if an element was consumed, false if the ring is empty.
+   */
+  bool try_pop(T &value) {
+    const T *slot = consumer_slot();
+    if (!slot)
+      return false;
+    value = *slot;
+    release();
+    return true;
+  }
+
+  /*!
+   * @brief Copies as many of `values` as fit into the ring and publishes
+   * them with a single update of `head`.
+   *
+   * @param values Pointer to the first element to push.
+   * @param count The number of elements to push.
+   * @return The number of elements published, 0 if the ring is full.
+   */
+  size_t try_push_batch(const T *values, size_t count) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (capacity - (h - cached_tail) < count)
+      cached_tail = tail.load(std::memory_order_acquire);
+    const size_t n =
+        std::min<uint64_t>(count, capacity - (h - cached_tail));
+    for (size_t i = 0; i < n; ++i)
+      slots()[(h + i) & mask].value = values[i];
+    if (n > 0)
+      head.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+  /*!
+   * @brief Copies up to `max` of the oldest elements out of the ring and
+   * returns their slots with a single update of `tail`.
+   *
+   * @param values Pointer to storage for at least `max` elements.
+   * @param max The maximum number of elements to pop.
+   * @return The number of elements consumed, 0 if the ring is empty.
+   */
+  size_t try_pop_batch(T *values, size_t max) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (cached_head - t < max)
+      cached_head = head.load(std::memory_order_acquire);
+    const size_t n = std::min<uint64_t>(max, cached_head - t);
+    for (size_t i = 0; i < n; ++i)
+      values[i] = slots()[(t + i) & mask].value;
+    if (n > 0)
+      tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+};
+
+} // namespace ipc
+
+#endif // IPC_SPSC_RING_HPP
@@ -4,6 +4,11 @@
 #define IPS_TRANSPORT_SHM_HPP
 
 #include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SPSCRing.hpp>      // For the lock-free ring used in ring mode
+#include <Doorbell.hpp>      // For the ring mode readiness descriptor
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For the ring mode wait policies
+#include <atomic>            // For the ring segment magic and doorbell flag
 #include <fcntl.h>           // For file control options (e.g., O_CREAT, O_RDWR)
 #include <pthread.h>         // For POSIX threads mutex and condition variables
 #include <string>            // For std::string
@@ -40,25 +45,80 @@ struct IPCMessageSHM : IPCMessage {
 
   /*! @brief Add a termination flag. */
   volatile bool terminate = false;
+
+  /*!
+   * @brief Non-zero while the receiver waits on its Doorbell. Set and
+   * cleared with `mutex` held by the arming side.
+   */
+  std::atomic<uint32_t> doorbell_armed{0};
+};
+
+/*!
+ * @brief Selects the layout of the segment used by SharedMemoryTransport.
+ */
+enum class SharedMemoryMode {
+  SingleSlot, /*!< One IPCMessageSHM slot handed off under a mutex/condvar. */
+  Ring        /*!< Two lock-free SPSC rings, one per direction. */
 };
 
+/*!
+ * @brief Header placed at the start of a ring mode segment.
+ *
+ * It is followed by two SPSCRing<IPCMessage> instances: the first carries
+ * messages from the creator to the opener, the second the reverse direction.
+ */
+struct SharedRingHeader {
+  /*! @brief Set to `SHARED_RING_MAGIC` once the segment is initialized. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Number of slots in each ring, written once by the creator. */
+  uint32_t capacity;
+
+  /*! @brief Notified after a message is pushed into ring 0 or 1. */
+  WaitPoint readable[2];
+
+  /*! @brief Notified after a message is popped from ring 0 or 1. */
+  WaitPoint writable[2];
+};
+
+/*! @brief Ring type used for each direction in ring mode. */
+using MessageRing = SPSCRing<IPCMessage>;
+
 /*!
  * @brief Implements the IIPCTransport interface using POSIX shared memory.
  *
  * This class provides a concrete IPC transport mechanism that uses a shared
- * memory segment for message exchange. It incorporates a mutex and condition
- * variable within the shared memory for robust synchronization between
- * processes.
+ * memory segment for message exchange. In the default single-slot mode it
+ * incorporates a mutex and condition variable within the shared memory for
+ * robust synchronization between processes. In ring mode the segment holds
+ * one lock-free single-producer/single-consumer ring per direction, so a
+ * producer can run ahead of a slow consumer until its ring fills up.
  */
 class SharedMemoryTransport : public IIPCTransport {
 public:
+  /*! @brief Default number of slots per direction in ring mode. */
+  static constexpr uint32_t DEFAULT_RING_CAPACITY = 1024;
+
+  /*! @brief Value stored in SharedRingHeader::magic once ready. */
+  static constexpr uint32_t SHARED_RING_MAGIC = 0x52494e47; // "RING"
+
   /*!
    * @brief Constructs a new SharedMemoryTransport object.
    *
    * Initializes internal state variables. Shared memory segment is not created
    * or mapped until the initialize method is called.
+   *
+   * @param mode The segment layout to use. Both peers must agree on it.
+   * @param ring_capacity Slots per direction in ring mode, rounded up to a
+   * power of two. Ignored by the opener, which uses the creator's value.
+   * Above MAX_QUEUE_CAPACITY the creator's `initialize()` fails.
+   * @param wait How this instance waits on a full or empty ring. Each peer
+   * may pick its own strategy.
    */
-  SharedMemoryTransport();
+  explicit SharedMemoryTransport(
+      SharedMemoryMode mode = SharedMemoryMode::SingleSlot,
+      uint32_t ring_capacity = DEFAULT_RING_CAPACITY,
+      WaitStrategy wait = WaitStrategy::Yield);
 
   /*!
    * @brief Destroys the SharedMemoryTransport object.
@@ -90,7 +150,9 @@ public:
    *
    * This method copies the provided message into the shared memory segment
    * and uses the shared mutex and condition variable to signal the receiver.
-   * It ensures thread-safe access to the shared message.
+   * It ensures thread-safe access to the shared message. In ring mode the
+   * message is pushed onto the outgoing ring and the call only waits while
+   * that ring is full.
    *
    * @param msg A constant reference to the IPCMessage to be sent.
    * @return True if the message is successfully written and signaled, false
@@ -103,7 +165,8 @@ public:
    *
    * This method reads a message from the shared memory segment, using the
    * shared mutex and condition variable to wait for new messages and ensure
-   * thread-safe access.
+   * thread-safe access. In ring mode the oldest message is popped from the
+   * incoming ring, waiting while that ring is empty.
    *
    * @param msg A reference to an IPCMessage object where the received data will
    * be stored.
@@ -111,6 +174,61 @@ public:
    */
   bool receive_message(IPCMessage &msg) override;
 
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for the
+   * slot to be free (single-slot mode) or the ring to have room.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for one
+   * to be published.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages. In ring mode each wait for free space is
+   * followed by copying as many messages as fit and publishing them with one
+   * index update and one wake-up.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Receives up to `max` messages. In ring mode it waits for the first
+   * one, then takes every message already published, up to `max`, with one
+   * index update.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*!
+   * @brief Returns the descriptor of the incoming doorbell: the incoming
+   * ring's in ring mode, the slot's in single-slot mode.
+   *
+   * Once this has been called, a receive that finds nothing to read arms the
+   * doorbell and the peer writes to it on its next send. The single slot
+   * carries both directions, so only one of the two peers may poll it.
+   */
+  int readiness_fd() override;
+
   /*!
    * @brief Cleans up resources associated with the shared memory transport.
    *
@@ -129,33 +247,175 @@ public:
    * synchronization.
    *
    * @return A pointer to the IPCMessageSHM object in shared memory, or nullptr
-   * if the shared memory has not been successfully initialized.
+   * if the shared memory has not been successfully initialized or the
+   * transport is in ring mode.
    */
   IPCMessageSHM *get_shared_message() const;
 
+  /*!
+   * @brief Loans the next free outgoing slot for in-place construction.
+   *
+   * Waits, according to the wait strategy, while the outgoing ring is full.
+   * The caller fills the returned message directly in shared memory and
+   * then publishes it with `commit()`. Only one slot can be on loan at a
+   * time. Available in ring mode only.
+   *
+   * @return A writable pointer into shared memory, or nullptr if the
+   * transport is not in ring mode, not initialized, or a loan is already
+   * outstanding.
+   */
+  IPCMessage *loan();
+
+  /*!
+   * @brief Loans the next free outgoing slot like `loan()`, waiting at most
+   * `timeout` while the outgoing ring is full.
+   *
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return A writable pointer into shared memory, or nullptr on timeout or
+   * for the reasons given for `loan()`.
+   */
+  IPCMessage *loan_for(std::chrono::nanoseconds timeout);
+
+  /*!
+   * @brief Publishes the slot obtained from `loan()` to the peer.
+   *
+   * @return True if a loaned slot was published, false if none was on loan.
+   */
+  bool commit();
+
+  /*!
+   * @brief Acquires the oldest incoming message without copying it.
+   *
+   * Waits, according to the wait strategy, while the incoming ring is
+   * empty. The returned view stays valid until `release()` is called. Only
+   * one message can be acquired at a time. Available in ring mode only.
+   *
+   * @return A read-only pointer into shared memory, or nullptr if the
+   * transport is not in ring mode, not initialized, or a message is already
+   * acquired.
+   */
+  const IPCMessage *acquire();
+
+  /*!
+   * @brief Acquires the oldest incoming message like `acquire()`, waiting at
+   * most `timeout` while the incoming ring is empty.
+   *
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return A read-only pointer into shared memory, or nullptr on timeout or
+   * for the reasons given for `acquire()`.
+   */
+  const IPCMessage *acquire_for(std::chrono::nanoseconds timeout);
+
+  /*!
+   * @brief Returns the slot obtained from `acquire()` to the peer.
+   *
+   * @return True if an acquired slot was released, false if none was held.
+   */
+  bool release();
+
+  /*!
+   * @brief Selects huge page backing, prefaulting, locking or memfd mode.
+   *
+   * Must be called before `initialize()` to take effect. In memfd mode the
+   * creator's `initialize()` blocks until the opener has connected and
+   * received the segment descriptor.
+   */
+  void set_segment_options(const ShmSegmentOptions &options);
+
+  /*! @brief Reports which segment options took effect after initialize. */
+  const ShmSegmentReport &segment_report() const;
+
+  /*! @brief Returns the segment layout this transport was constructed with. */
+  SharedMemoryMode get_mode() const;
+
+  /*! @brief Returns the ring mode wait strategy of this instance. */
+  WaitStrategy get_wait_strategy() const;
+
 private:
-  /*! @brief The name of the POSIX shared memory object. */
-  std::string shm_name;
+  /*! @brief The segment layout, fixed at construction. */
+  SharedMemoryMode mode;
 
-  /*! @brief File descriptor for the shared memory object. Initialized to -1. */
-  int shm_fd = -1;
+  /*! @brief Requested slots per direction in ring mode. */
+  uint32_t ring_capacity;
+
+  /*! @brief How this instance waits in ring mode. */
+  WaitStrategy wait_strategy;
 
   /*!
-   * @brief Pointer to the mapped IPCMessageSHM structure in shared memory.
+   * @brief The mapped shared memory segment.
    *
-   * This pointer provides direct access to the shared data and synchronization
-   * primitives.
+   * The creating instance owns the object and unlinks it during cleanup.
    */
-  IPCMessageSHM *shared_msg = nullptr;
+  ShmSegment segment;
+
+  /*! @brief Ring this instance produces into (ring mode only). */
+  MessageRing *tx_ring = nullptr;
+
+  /*! @brief Ring this instance consumes from (ring mode only). */
+  MessageRing *rx_ring = nullptr;
+
+  /*! @brief Wait points guarding `tx_ring` (ring mode only). */
+  WaitPoint *tx_readable = nullptr, *tx_writable = nullptr;
+
+  /*! @brief Wait points guarding `rx_ring` (ring mode only). */
+  WaitPoint *rx_readable = nullptr, *rx_writable = nullptr;
+
+  /*! @brief Rung after pushing into `tx_ring` (ring mode only). */
+  Doorbell tx_doorbell;
+
+  /*!
+   * @brief Rung by the peer after pushing into `rx_ring`. In single-slot
+   * mode the one doorbell of the slot, rung by whichever side sends.
+   */
+  Doorbell rx_doorbell;
+
+  /*! @brief True once `readiness_fd()` was called, so empty reads arm. */
+  bool doorbell_in_use = false;
+
+  /*! @brief True while a slot handed out by `loan()` is not committed. */
+  bool loan_outstanding = false;
+
+  /*! @brief True while a slot handed out by `acquire()` is not released. */
+  bool acquire_outstanding = false;
+
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Loans an outgoing slot, giving up at `deadline`. */
+  IPCMessage *loan_until(const Deadline &deadline);
+
+  /*! @brief Acquires an incoming slot, giving up at `deadline`. */
+  const IPCMessage *acquire_until(const Deadline &deadline);
+
+  /*! @brief Wakes the peer after pushing into `tx_ring`. */
+  void notify_readable();
 
   /*!
-   * @brief A flag indicating if this instance is the owner of the shared memory
-   * object.
+   * @brief Arms `rx_doorbell` if in use and retries one pop, so that an
+   * empty result guarantees a later ring.
+   */
+  bool arm_and_pop(IPCMessage &msg);
+
+  /*!
+   * @brief Maps the ring mode segment and wires up `tx_ring`/`rx_ring`.
    *
-   * If true, this instance is responsible for unlinking the shared memory
-   * object during cleanup.
+   * @param name The name passed to `initialize()`.
+   * @param create True if this instance created the segment and must
+   * initialize the header and both rings.
+   * @return True on success, false otherwise.
    */
-  bool is_owner = false;
+  bool initialize_rings(const std::string &name, bool create);
+
+  /*!
+   * @brief Pointer to the mapped IPCMessageSHM structure in shared memory.
+   *
+   * This pointer provides direct access to the shared data and synchronization
+   * primitives.
+   */
+  IPCMessageSHM *shared_msg = nullptr;
 };
 } // namespace ipc
 
@@ -0,0 +1,154 @@
+#ifndef IPC_SHM_ARENA_HPP
+#define IPC_SHM_ARENA_HPP
+
+#include <SPSCRing.hpp> // For CACHE_LINE_SIZE
+#include <cstddef>      // For size_t
+#include <cstdint>      // For fixed-width integer types
+#include <pthread.h>    // For the robust process-shared mutex
+
+namespace ipc {
+
+/*!
+ * @brief A buddy allocator placed in shared memory.
+ *
+ * The arena header is followed by a pool of `pool_size` bytes, initially
+ * split into the largest aligned power-of-two blocks that fit. Blocks come
+ * in power-of-two size classes from 64 bytes upward: an allocation splits
+ * the smallest free block that fits in halves until it has the right size,
+ * and a release merges the block with its buddy for as long as the buddy
+ * is free too. Freed space is therefore available to every size class
+ * again, and a pool whose blocks have all been released can always serve
+ * its largest block.
+ *
+ * The free lists are guarded by a robust process-shared mutex in the arena,
+ * so any number of processes can allocate and free concurrently. It is
+ * held only for a bounded number of list updates, never across a wait.
+ * Lists that are truly lock-free would need a split or merge to update
+ * several lists in one atomic step, so the lock stays; being robust, it is
+ * handed to the next caller if its holder dies, and that caller rebuilds
+ * the free lists from the block headers. Blocks the dead process was
+ * splitting or merging at the time are lost, and nothing else is.
+ *
+ * All positions are byte offsets relative to `pool()`, which lets processes
+ * that map the segment at different addresses exchange buffers by offset.
+ */
+struct ShmArena {
+  /*! @brief Offset value meaning "no block". */
+  static constexpr uint64_t NPOS = ~uint64_t(0);
+
+  /*! @brief log2 of the smallest block size. */
+  static constexpr unsigned MIN_BLOCK_SHIFT = 6;
+
+  /*! @brief Number of size classes; the largest is 2^(6 + 31) bytes. */
+  static constexpr unsigned NUM_CLASSES = 32;
+
+  /*! @brief Bytes reserved in front of every payload for bookkeeping. */
+  static constexpr size_t BLOCK_HEADER_SIZE = 16;
+
+  /*! @brief Bookkeeping stored at the start of each block. */
+  struct BlockHeader {
+    /*! @brief Index of the size class the block belongs to. */
+    uint32_t size_class;
+
+    /*! @brief Nonzero while the block is on a free list. */
+    uint32_t free;
+
+    /*! @brief Next free block (block unit index + 1), valid while free. */
+    uint32_t next;
+
+    /*! @brief Previous free block (block unit index + 1), valid while free. */
+    uint32_t prev;
+  };
+
+  /*! @brief Robust mutex guarding the free lists and block headers. */
+  alignas(CACHE_LINE_SIZE) pthread_mutex_t lock;
+
+  /*!
+   * @brief Heads of the doubly linked per-class free lists, as block unit
+   * index + 1 (0 means empty).
+   */
+  uint32_t free_lists[NUM_CLASSES];
+
+  /*! @brief Size of the pool following the header, in bytes. */
+  uint64_t pool_size;
+
+  /*! @brief Returns the bytes needed for an arena with a `pool_size` pool. */
+  static constexpr size_t bytes_for(size_t pool_size) {
+    return sizeof(ShmArena) + pool_size;
+  }
+
+  /*!
+   * @brief Initializes the arena in freshly mapped memory.
+   *
+   * Must be called exactly once by the creator of the segment.
+   */
+  void init(size_t pool_bytes);
+
+  /*!
+   * @brief Allocates a block with room for `size` payload bytes.
+   *
+   * @return The payload offset, or NPOS if the request is too large or no
+   * free block is big enough.
+   */
+  uint64_t allocate(size_t size);
+
+  /*!
+   * @brief Returns a block obtained from `allocate()` to the pool, merging
+   * it with its free buddies.
+   *
+   * @param offset The payload offset returned by `allocate()`.
+   */
+  void deallocate(uint64_t offset);
+
+  /*! @brief Returns the payload capacity of the block at `offset`. */
+  size_t capacity_of(uint64_t offset);
+
+  /*! @brief Returns the start of the pool, located after the header. */
+  char *pool() { return reinterpret_cast<char *>(this + 1); }
+
+  /*! @brief Translates a payload offset into an address in this process. */
+  void *at(uint64_t offset) { return pool() + offset; }
+
+  /*! @brief Translates an address inside the pool back into an offset. */
+  uint64_t offset_of(const void *ptr) {
+    return static_cast<uint64_t>(static_cast<const char *>(ptr) - pool());
+  }
+
+private:
+  /*! @brief Returns the header of the block whose payload is at `offset`. */
+  BlockHeader *header_of(uint64_t offset) {
+    return block_at(offset - BLOCK_HEADER_SIZE);
+  }
+
+  /*! @brief Returns the header of the block starting at pool offset `block`. */
+  BlockHeader *block_at(uint64_t block) {
+    return reinterpret_cast<BlockHeader *>(pool() + block);
+  }
+
+  /*! @brief Marks the block at `block` free and links it into `cls`. */
+  void push_free(uint64_t block, unsigned cls);
+
+  /*! @brief Unlinks the free block at `block` from its free list. */
+  void unlink_free(uint64_t block);
+
+  /*!
+   * @brief Acquires the free list mutex, repairing the lists if its last
+   * holder died.
+   *
+   * @return False if the mutex is unusable.
+   */
+  bool lock_lists();
+
+  /*! @brief Releases the free list mutex. */
+  void unlock_lists() { pthread_mutex_unlock(&lock); }
+
+  /*!
+   * @brief Rebuilds the free lists by walking the block headers. Blocks not
+   * marked free, including one a dead holder was splitting, are skipped.
+   */
+  void rebuild_lists();
+};
+
+} // namespace ipc
+
+#endif // IPC_SHM_ARENA_HPP
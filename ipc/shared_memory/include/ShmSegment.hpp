@@ -0,0 +1,239 @@
+#ifndef IPC_SHM_SEGMENT_HPP
+#define IPC_SHM_SEGMENT_HPP
+
+#include <cstddef> // For size_t
+#include <string>  // For std::string
+
+namespace ipc {
+
+/*!
+ * @brief Requests how a shared memory segment should be backed and mapped.
+ *
+ * Every option is best effort: the segment is still created when an option
+ * cannot be honoured, and ShmSegmentReport tells what actually took effect.
+ */
+struct ShmSegmentOptions {
+  /*!
+   * @brief Back the segment with explicit huge pages from a hugetlbfs mount
+   * (e.g. /dev/hugepages) instead of /dev/shm. Only used by the creator.
+   */
+  bool huge_pages = false;
+
+  /*! @brief Ask for transparent huge pages with `madvise(MADV_HUGEPAGE)`. */
+  bool transparent_huge_pages = false;
+
+  /*! @brief Fault every page in at map time with `MAP_POPULATE`. */
+  bool prefault = false;
+
+  /*! @brief Pin the mapping in RAM with `mlock`. */
+  bool lock = false;
+
+  /*!
+   * @brief Create an anonymous segment with `memfd_create` instead of a
+   * named object, and hand its descriptor to the opener over an abstract
+   * AF_UNIX socket. Both peers must set this option.
+   */
+  bool memfd = false;
+
+  /*!
+   * @brief How long an opener keeps retrying to reach the creator's
+   * rendezvous socket in memfd mode, and how long the creator's `publish()`
+   * waits for an opener, in milliseconds.
+   */
+  int rendezvous_timeout_ms = 5000;
+
+  /*!
+   * @brief Bind the segment's pages to this NUMA node with `mbind` before
+   * they are first touched. -1 leaves placement to the first-touch policy.
+   */
+  int numa_node = -1;
+};
+
+/*!
+ * @brief Reports which ShmSegmentOptions took effect for a mapping.
+ */
+struct ShmSegmentReport {
+  /*! @brief True if the segment lives on hugetlbfs. */
+  bool huge_pages = false;
+
+  /*!
+   * @brief True if `MADV_HUGEPAGE` was accepted and the kernel's shmem THP
+   * policy allows huge pages for this mapping.
+   */
+  bool transparent_huge_pages = false;
+
+  /*! @brief True if every page of the mapping was resident after mapping. */
+  bool prefaulted = false;
+
+  /*! @brief True if the mapping is locked in RAM. */
+  bool locked = false;
+
+  /*! @brief True if the segment is an anonymous memfd. */
+  bool memfd = false;
+
+  /*! @brief True if the segment's size is sealed against shrink and grow. */
+  bool sealed = false;
+
+  /*! @brief Page size of the backing file system in bytes. */
+  size_t page_size = 0;
+
+  /*! @brief Size of the mapping in bytes, after any rounding. */
+  size_t size = 0;
+
+  /*! @brief True if the mapping was bound to ShmSegmentOptions::numa_node. */
+  bool numa_bound = false;
+
+  /*!
+   * @brief NUMA node holding the first page of the mapping, or -1 if it was
+   * not resident yet or the node is unknown.
+   */
+  int numa_node = -1;
+};
+
+/*!
+ * @brief Owns a named POSIX shared memory object and its mapping.
+ *
+ * Wraps the `shm_open` + `ftruncate` + `mmap` sequence shared by the
+ * shared-memory based transports. The creating instance is the owner and
+ * unlinks the object when it is closed. Options set with `set_options()`
+ * select huge page backing, prefaulting and locking for the next mapping.
+ *
+ * In memfd mode the segment has no name in /dev/shm: the creator makes a
+ * sealed `memfd_create` object and `publish()` passes its descriptor to the
+ * opener with SCM_RIGHTS over the abstract socket "ipc-shm/<name>". Nothing
+ * needs unlinking and nothing leaks if either process crashes.
+ */
+class ShmSegment {
+public:
+  /*! @brief Constructs an empty, unmapped segment. */
+  ShmSegment() = default;
+
+  /*! @brief Unmaps the segment and unlinks it if this instance owns it. */
+  ~ShmSegment();
+
+  ShmSegment(const ShmSegment &) = delete;
+  ShmSegment &operator=(const ShmSegment &) = delete;
+
+  /*!
+   * @brief Sets the options used by the next `create()` or `open()`.
+   */
+  void set_options(const ShmSegmentOptions &options);
+
+  /*!
+   * @brief Creates (or truncates) a shared memory object and maps it.
+   *
+   * With huge page backing the size is rounded up to a whole number of huge
+   * pages. If the huge pages cannot be had, because there is no hugetlbfs
+   * mount or too few pages are reserved, the segment is created on ordinary
+   * pages instead and `report().huge_pages` is false.
+   *
+   * @param name The object name without the leading slash.
+   * @param size The minimum size of the segment in bytes.
+   * @return True on success, false otherwise.
+   */
+  bool create(const std::string &name, size_t size);
+
+  /*!
+   * @brief Makes a created and initialized segment available to its peer.
+   *
+   * Creators call this once the segment contents are ready. In memfd mode
+   * it waits up to `rendezvous_timeout_ms` for one opener to connect and
+   * then passes it the descriptor, followed by the `extra_count`
+   * descriptors at `extra`; for named segments it does nothing. Every
+   * transport that accepts memfd mode must call it.
+   *
+   * @param extra Descriptors the opener receives along with the segment.
+   * @param extra_count The number of descriptors at `extra`.
+   * @return True on success, false otherwise.
+   */
+  bool publish(const int *extra = nullptr, size_t extra_count = 0);
+
+  /*!
+   * @brief Opens an existing shared memory object and maps all of it.
+   *
+   * Looks in /dev/shm first and then on the hugetlbfs mount, so openers
+   * need not know how the creator backed the segment. In memfd mode it
+   * instead receives the descriptor from the creator's `publish()`.
+   *
+   * @param name The object name without the leading slash.
+   * @param extra Receives the extra descriptors passed to `publish()` in
+   * memfd mode, which the caller then owns. Left untouched otherwise.
+   * @param extra_count The number of descriptors expected at `extra`.
+   * @return True on success, false otherwise.
+   */
+  bool open(const std::string &name, int *extra = nullptr,
+            size_t extra_count = 0);
+
+  /*!
+   * @brief Unmaps the segment, closes its descriptor and, if this instance
+   * created it, unlinks the shared memory object.
+   */
+  void close();
+
+  /*! @brief Returns the base address of the mapping, or nullptr. */
+  void *data() const;
+
+  /*! @brief Returns the size of the mapping in bytes. */
+  size_t size() const;
+
+  /*! @brief Returns true if this instance created the object. */
+  bool is_owner() const;
+
+  /*! @brief Returns which options took effect for the current mapping. */
+  const ShmSegmentReport &report() const;
+
+private:
+  /*! @brief Maps `map_size` bytes of `shm_fd` and applies the options. */
+  bool map(size_t map_size);
+
+  /*!
+   * @brief Creates, sizes and maps the object, on huge pages if `huge`.
+   * Memfd objects are also sealed.
+   *
+   * @return False, with nothing left behind, on failure.
+   */
+  bool create_object(size_t size, bool huge);
+
+  /*!
+   * @brief Receives the creator's memfd and extra descriptors, then maps
+   * the segment.
+   */
+  bool open_memfd(int *extra, size_t extra_count);
+
+  /*! @brief Returns the abstract rendezvous address for memfd mode. */
+  std::string rendezvous_name() const;
+
+  /*! @brief Returns the hugetlbfs mount point, or an empty string. */
+  static std::string hugetlbfs_mount();
+
+  /*! @brief Options for the next mapping. */
+  ShmSegmentOptions options;
+
+  /*! @brief What took effect for the current mapping. */
+  ShmSegmentReport status;
+
+  /*! @brief The name passed to `initialize`, without the leading slash. */
+  std::string base_name;
+
+  /*! @brief The name passed to `shm_open`, including the leading slash. */
+  std::string shm_name;
+
+  /*! @brief Path of the hugetlbfs file, or empty for /dev/shm backing. */
+  std::string huge_path;
+
+  /*! @brief File descriptor for the shared memory object. */
+  int shm_fd = -1;
+
+  /*! @brief Base address of the mapping. */
+  void *base = nullptr;
+
+  /*! @brief Size of the mapping in bytes. */
+  size_t length = 0;
+
+  /*! @brief True if this instance created the object. */
+  bool owner = false;
+};
+
+} // namespace ipc
+
+#endif // IPC_SHM_SEGMENT_HPP
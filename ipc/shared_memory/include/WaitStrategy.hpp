@@ -0,0 +1,226 @@
+#ifndef IPC_WAIT_STRATEGY_HPP
+#define IPC_WAIT_STRATEGY_HPP
+
+#include <Backoff.hpp>  // For cpu_relax and Backoff
+#include <Deadline.hpp> // For timed waits
+#include <SPSCRing.hpp> // For CACHE_LINE_SIZE
+#include <atomic>       // For std::atomic and fences
+#include <cstdint>      // For fixed-width integer types
+#include <pthread.h>    // For process-shared mutex and condition variable
+
+namespace ipc {
+
+/*!
+ * @brief Selects how a shared-memory transport waits for its peer.
+ */
+enum class WaitStrategy {
+  Spin,   /*!< Busy-spin with `pause`; lowest latency, burns a core. */
+  Yield,  /*!< Spin briefly, then `sched_yield()` between retries. */
+  Futex,  /*!< Spin briefly, then park on a futex until notified. */
+  CondVar /*!< Sleep on a process-shared condition variable. */
+};
+
+/*!
+ * @brief A rendezvous point placed in shared memory next to a queue.
+ *
+ * Waiters of any strategy block on the same point and producers call
+ * `notify()` after making progress. The point counts sleeping waiters so
+ * that `notify()` costs one fence and one load, and no system call, while
+ * nobody sleeps. Because waking handles both futex and condvar sleepers,
+ * peers may use different wait strategies on the same queue.
+ */
+struct WaitPoint {
+  /*! @brief Futex word, bumped whenever sleeping waiters are notified. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> sequence;
+
+  /*! @brief Number of waiters parked (or about to park) on the futex. */
+  std::atomic<uint32_t> futex_waiters;
+
+  /*! @brief Number of waiters blocked (or about to block) on the condvar. */
+  std::atomic<uint32_t> cond_waiters;
+
+  /*! @brief Non-zero while the consumer waits on its Doorbell instead. */
+  std::atomic<uint32_t> doorbell_armed;
+
+  /*! @brief Process-shared mutex paired with `cond`. */
+  pthread_mutex_t mutex;
+
+  /*!
+   * @brief Process-shared condition variable for CondVar waiters. Uses
+   * CLOCK_MONOTONIC so that timed waits ignore wall clock changes.
+   */
+  pthread_cond_t cond;
+
+  /*!
+   * @brief Initializes the point in freshly mapped memory.
+   *
+   * Must be called exactly once by the creator of the segment.
+   */
+  void init();
+
+  /*!
+   * @brief Wakes every sleeping waiter, if there is any.
+   *
+   * Must be called after the state a waiter may be waiting for has been
+   * published.
+   */
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (futex_waiters.load(std::memory_order_relaxed) != 0 ||
+        cond_waiters.load(std::memory_order_relaxed) != 0)
+      wake_all();
+  }
+
+  /*!
+   * @brief Blocks on the futex while `sequence` still equals `expected`.
+   *
+   * @param timeout Relative timeout, or nullptr to wait until woken.
+   */
+  void futex_wait(uint32_t expected, const timespec *timeout = nullptr);
+
+  /*! @brief Slow path of `notify()`: issues the wake-up system calls. */
+  void wake_all();
+};
+
+/*!
+ * @brief Busy-spin wait policy.
+ *
+ * Each policy exposes `wait(point, ready)`, which returns once the callable
+ * `ready` returns true. `ready` is expected to attempt the operation (for
+ * example a `try_push`) so that success and the check are one step.
+ * `wait_until(point, ready, deadline)` does the same but gives up at the
+ * deadline, returning whether `ready` succeeded; `ready` is always tried at
+ * least once.
+ */
+struct SpinWait {
+  template <typename Ready> static void wait(WaitPoint &point, Ready &&ready) {
+    wait_until(point, ready, Deadline::never());
+  }
+
+  template <typename Ready>
+  static bool wait_until(WaitPoint &, Ready &&ready, const Deadline &deadline) {
+    while (!ready()) {
+      if (deadline.expired())
+        return false;
+      cpu_relax();
+    }
+    return true;
+  }
+};
+
+/*! @brief Spin-then-yield wait policy. */
+struct YieldWait {
+  template <typename Ready> static void wait(WaitPoint &point, Ready &&ready) {
+    wait_until(point, ready, Deadline::never());
+  }
+
+  template <typename Ready>
+  static bool wait_until(WaitPoint &, Ready &&ready, const Deadline &deadline) {
+    Backoff backoff;
+    while (!ready()) {
+      if (deadline.expired())
+        return false;
+      backoff.pause();
+    }
+    return true;
+  }
+};
+
+/*! @brief Spin-then-park wait policy using a shared futex. */
+struct FutexWait {
+  /*! @brief Number of relaxed spins before parking on the futex. */
+  static constexpr unsigned SPIN_LIMIT = 256;
+
+  template <typename Ready> static void wait(WaitPoint &point, Ready &&ready) {
+    wait_until(point, ready, Deadline::never());
+  }
+
+  template <typename Ready>
+  static bool wait_until(WaitPoint &point, Ready &&ready,
+                         const Deadline &deadline) {
+    for (unsigned i = 0; i < SPIN_LIMIT; ++i) {
+      if (ready())
+        return true;
+      if (deadline.expired())
+        return false;
+      cpu_relax();
+    }
+    for (;;) {
+      point.futex_waiters.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const uint32_t seq = point.sequence.load(std::memory_order_acquire);
+      if (ready()) {
+        point.futex_waiters.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+      if (deadline.is_never()) {
+        point.futex_wait(seq);
+      } else {
+        const timespec timeout = deadline.remaining_timespec();
+        point.futex_wait(seq, &timeout);
+      }
+      point.futex_waiters.fetch_sub(1, std::memory_order_relaxed);
+      if (deadline.expired())
+        return ready();
+    }
+  }
+};
+
+/*! @brief Wait policy using the process-shared condition variable. */
+struct CondVarWait {
+  template <typename Ready> static void wait(WaitPoint &point, Ready &&ready) {
+    wait_until(point, ready, Deadline::never());
+  }
+
+  template <typename Ready>
+  static bool wait_until(WaitPoint &point, Ready &&ready,
+                         const Deadline &deadline) {
+    if (ready())
+      return true;
+    if (deadline.expired())
+      return false;
+    pthread_mutex_lock(&point.mutex);
+    point.cond_waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool done;
+    while (!(done = ready())) {
+      if (deadline.is_never()) {
+        pthread_cond_wait(&point.cond, &point.mutex);
+      } else {
+        const timespec when = deadline.monotonic_timespec();
+        if (pthread_cond_timedwait(&point.cond, &point.mutex, &when) ==
+                ETIMEDOUT &&
+            !(done = ready()))
+          break;
+      }
+    }
+    point.cond_waiters.fetch_sub(1, std::memory_order_relaxed);
+    pthread_mutex_unlock(&point.mutex);
+    return done;
+  }
+};
+
+/*!
+ * @brief Invokes `fn` with the policy object matching `strategy`.
+ *
+ * Transports call this once per operation so that the wait loop itself is
+ * instantiated per policy and carries no strategy branch.
+ */
+template <typename Fn>
+decltype(auto) with_wait_strategy(WaitStrategy strategy, Fn &&fn) {
+  switch (strategy) {
+  case WaitStrategy::Spin:
+    return fn(SpinWait{});
+  case WaitStrategy::Futex:
+    return fn(FutexWait{});
+  case WaitStrategy::CondVar:
+    return fn(CondVarWait{});
+  case WaitStrategy::Yield:
+  default:
+    return fn(YieldWait{});
+  }
+}
+
+} // namespace ipc
+
+#endif // IPC_WAIT_STRATEGY_HPP
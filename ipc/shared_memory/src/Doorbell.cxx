@@ -0,0 +1,106 @@
+#include <Doorbell.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+
+ipc::Doorbell::~Doorbell() { close(); }
+
+void ipc::Doorbell::adopt(int fd) {
+  close();
+  doorbell_fd = fd;
+  counter = true;
+}
+
+void ipc::Doorbell::bind(const std::string &fifo_path) {
+  close();
+  path = fifo_path;
+}
+
+int ipc::Doorbell::listen() {
+  if (doorbell_fd != -1 || path.empty())
+    return doorbell_fd;
+
+  unlink(path.c_str());
+  if (mkfifo(path.c_str(), 0666) == -1) {
+    perror("mkfifo doorbell");
+    return -1;
+  }
+  owner = true;
+
+  // Read-write keeps the FIFO open from both ends, so neither open nor
+  // write ever waits for a peer.
+  doorbell_fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (doorbell_fd == -1) {
+    perror("open doorbell");
+    unlink(path.c_str());
+    owner = false;
+  }
+  return doorbell_fd;
+}
+
+bool ipc::Doorbell::open_bound() {
+  if (path.empty())
+    return false;
+  doorbell_fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (doorbell_fd == -1) {
+    perror("open doorbell");
+    return false;
+  }
+  unlink(path.c_str());
+  return true;
+}
+
+void ipc::Doorbell::close() {
+  if (owner) {
+    // The producer normally unlinked the FIFO already; leave alone a newer
+    // one that another transport created at the same path.
+    struct stat linked {};
+    struct stat opened {};
+    if (stat(path.c_str(), &linked) == 0 && fstat(doorbell_fd, &opened) == 0 &&
+        linked.st_dev == opened.st_dev && linked.st_ino == opened.st_ino)
+      unlink(path.c_str());
+  }
+  if (doorbell_fd != -1) {
+    ::close(doorbell_fd);
+    doorbell_fd = -1;
+  }
+  owner = false;
+  counter = false;
+  path.clear();
+}
+
+void ipc::Doorbell::arm(std::atomic<uint32_t> &armed) {
+  if (doorbell_fd == -1)
+    return;
+
+  char buffer[64];
+  while (read(doorbell_fd, buffer, sizeof(buffer)) > 0) {
+  }
+  armed.store(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+std::string ipc::Doorbell::path_for(const std::string &name, int index) {
+  std::string flat = name;
+  for (char &c : flat)
+    if (c == '/')
+      c = '_';
+  return "/tmp/" + flat + "_doorbell" + std::to_string(index);
+}
+
+bool ipc::Doorbell::make_eventfds(int *fds, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    fds[i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fds[i] == -1) {
+      perror("eventfd doorbell");
+      while (i-- > 0) {
+        ::close(fds[i]);
+        fds[i] = -1;
+      }
+      return false;
+    }
+  }
+  return true;
+}
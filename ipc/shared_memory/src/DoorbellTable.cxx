@@ -0,0 +1,140 @@
+#include <DoorbellTable.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+namespace {
+
+/*! @brief Returns true if no process `pid` exists any more. */
+bool process_gone(uint32_t pid) {
+  return kill(static_cast<pid_t>(pid), 0) == -1 && errno == ESRCH;
+}
+
+} // namespace
+
+void ipc::DoorbellTable::init() {
+  armed_count.store(0, std::memory_order_relaxed);
+  for (DoorbellSlot &slot : slots) {
+    slot.owner.store(0, std::memory_order_relaxed);
+    slot.generation.store(0, std::memory_order_relaxed);
+    slot.armed.store(0, std::memory_order_relaxed);
+  }
+}
+
+ipc::ReaderDoorbells::ReaderDoorbells() {
+  for (unsigned i = 0; i < DoorbellTable::MAX_READERS; ++i) {
+    writer_fds[i] = -1;
+    writer_generations[i] = 0;
+  }
+}
+
+ipc::ReaderDoorbells::~ReaderDoorbells() { close(); }
+
+void ipc::ReaderDoorbells::bind(DoorbellTable *doorbell_table,
+                                const std::string &segment_name) {
+  close();
+  table = doorbell_table;
+  name = segment_name;
+}
+
+int ipc::ReaderDoorbells::listen() {
+  if (own_slot != -1 || !table)
+    return own.fd();
+
+  const uint32_t pid = static_cast<uint32_t>(getpid());
+  for (unsigned i = 0; i < DoorbellTable::MAX_READERS; ++i) {
+    DoorbellSlot &slot = table->slots[i];
+    uint32_t owner = slot.owner.load(std::memory_order_relaxed);
+    if (owner != 0 && (owner == pid || !process_gone(owner)))
+      continue;
+    if (!slot.owner.compare_exchange_strong(owner, pid,
+                                            std::memory_order_acq_rel))
+      continue;
+
+    // A reader that died armed still counts as armed.
+    if (slot.armed.exchange(0, std::memory_order_relaxed) != 0)
+      table->armed_count.fetch_sub(1, std::memory_order_relaxed);
+    slot.generation.fetch_add(1, std::memory_order_release);
+
+    own.bind(Doorbell::path_for(name, static_cast<int>(i)));
+    if (own.listen() == -1) {
+      own.close();
+      slot.owner.store(0, std::memory_order_release);
+      return -1;
+    }
+    own_slot = static_cast<int>(i);
+    return own.fd();
+  }
+  fprintf(stderr, "no free doorbell slot\n");
+  return -1;
+}
+
+void ipc::ReaderDoorbells::arm() {
+  if (own_slot == -1)
+    return;
+
+  char buffer[64];
+  while (read(own.fd(), buffer, sizeof(buffer)) > 0) {
+  }
+  if (table->slots[own_slot].armed.exchange(1, std::memory_order_relaxed) == 0)
+    table->armed_count.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void ipc::ReaderDoorbells::ring_armed() {
+  for (unsigned i = 0; i < DoorbellTable::MAX_READERS; ++i) {
+    std::atomic<uint32_t> &armed = table->slots[i].armed;
+    if (armed.load(std::memory_order_relaxed) == 0)
+      continue;
+    // As in Doorbell::ring, a reader whose FIFO cannot be opened stays
+    // armed for the next ring.
+    const int fd = writer_fd(i);
+    if (fd == -1 || armed.exchange(0, std::memory_order_acq_rel) == 0)
+      continue;
+    table->armed_count.fetch_sub(1, std::memory_order_relaxed);
+    const char one = 1;
+    ssize_t ignored = write(fd, &one, 1);
+    (void)ignored;
+  }
+}
+
+int ipc::ReaderDoorbells::writer_fd(unsigned slot) {
+  if (static_cast<int>(slot) == own_slot)
+    return own.fd();
+
+  const uint32_t generation =
+      table->slots[slot].generation.load(std::memory_order_acquire);
+  if (writer_fds[slot] != -1 && writer_generations[slot] == generation)
+    return writer_fds[slot];
+
+  // The slot changed hands since the FIFO was opened.
+  if (writer_fds[slot] != -1)
+    ::close(writer_fds[slot]);
+  writer_fds[slot] =
+      ::open(Doorbell::path_for(name, static_cast<int>(slot)).c_str(),
+             O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (writer_fds[slot] == -1)
+    perror("open doorbell");
+  writer_generations[slot] = generation;
+  return writer_fds[slot];
+}
+
+void ipc::ReaderDoorbells::close() {
+  if (own_slot != -1) {
+    DoorbellSlot &slot = table->slots[own_slot];
+    if (slot.armed.exchange(0, std::memory_order_relaxed) != 0)
+      table->armed_count.fetch_sub(1, std::memory_order_relaxed);
+    own.close();
+    slot.owner.store(0, std::memory_order_release);
+    own_slot = -1;
+  }
+  for (unsigned i = 0; i < DoorbellTable::MAX_READERS; ++i) {
+    if (writer_fds[i] != -1)
+      ::close(writer_fds[i]);
+    writer_fds[i] = -1;
+  }
+  table = nullptr;
+  name.clear();
+}
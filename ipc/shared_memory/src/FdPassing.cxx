@@ -0,0 +1,137 @@
+#include <FdPassing.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+bool ipc::make_abstract_address(const std::string &name, sockaddr_un &address,
+                                socklen_t &length) {
+  if (name.empty() || name.size() + 1 > sizeof(address.sun_path)) {
+    fprintf(stderr, "abstract socket name too long: %s\n", name.c_str());
+    return false;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  // sun_path[0] stays '\0', which selects the abstract namespace.
+  memcpy(address.sun_path + 1, name.data(), name.size());
+  length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 +
+                                  name.size());
+  return true;
+}
+
+int ipc::listen_abstract(const std::string &name) {
+  sockaddr_un addr;
+  socklen_t addr_len;
+  if (!make_abstract_address(name, addr, addr_len))
+    return -1;
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    perror("socket");
+    return -1;
+  }
+
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), addr_len) < 0) {
+    perror("bind");
+    close(fd);
+    return -1;
+  }
+
+  if (listen(fd, 1) < 0) {
+    perror("listen");
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+int ipc::connect_abstract(const std::string &name, int timeout_ms) {
+  sockaddr_un addr;
+  socklen_t addr_len;
+  if (!make_abstract_address(name, addr, addr_len))
+    return -1;
+
+  for (int waited_ms = 0;; waited_ms += 10) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      perror("socket");
+      return -1;
+    }
+
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), addr_len) == 0)
+      return fd;
+
+    const int err = errno;
+    close(fd);
+    if ((err != ECONNREFUSED && err != ENOENT) || waited_ms >= timeout_ms) {
+      errno = err;
+      perror("connect");
+      return -1;
+    }
+
+    timespec delay{0, 10 * 1000 * 1000};
+    nanosleep(&delay, nullptr);
+  }
+}
+
+bool ipc::send_descriptor(int socket_fd, int fd) {
+  char byte = 0;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+  while (sendmsg(socket_fd, &msg, MSG_NOSIGNAL) < 0) {
+    if (errno == EINTR)
+      continue;
+    perror("sendmsg");
+    return false;
+  }
+  return true;
+}
+
+int ipc::receive_descriptor(int socket_fd) {
+  char byte = 0;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t received;
+  while ((received = recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC)) < 0) {
+    if (errno == EINTR)
+      continue;
+    perror("recvmsg");
+    return -1;
+  }
+
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (received == 0 || !cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS) {
+    fprintf(stderr, "recvmsg: no descriptor received\n");
+    return -1;
+  }
+
+  int fd = -1;
+  memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  return fd;
+}
@@ -0,0 +1,122 @@
+#include <NumaPlacement.hpp>
+#include <cstdio>
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+/*! @brief Size in bits of the node masks passed to the kernel. */
+constexpr unsigned long MAX_NODES = 1024;
+
+/*! @brief A node mask wide enough for MAX_NODES nodes. */
+struct NodeMask {
+  unsigned long bits[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+
+  explicit NodeMask(int node) {
+    bits[node / (8 * sizeof(unsigned long))] =
+        1UL << (node % (8 * sizeof(unsigned long)));
+  }
+};
+
+/*! @brief Parses a sysfs CPU list such as "0-3,8-11" into `set`. */
+bool parse_cpu_list(const std::string &list, cpu_set_t &set) {
+  CPU_ZERO(&set);
+  size_t pos = 0;
+  bool any = false;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos)
+      end = list.size();
+    const std::string range = list.substr(pos, end - pos);
+    const size_t dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+        CPU_SET(cpu, &set);
+        any = true;
+      }
+    } catch (...) {
+      return false;
+    }
+    pos = end + 1;
+  }
+  return any;
+}
+
+} // namespace
+
+int ipc::numa_node_count() { return static_cast<int>(numa_nodes().size()); }
+
+std::vector<int> ipc::numa_nodes() {
+  std::ifstream online("/sys/devices/system/node/has_memory");
+  std::string list;
+  cpu_set_t nodes; // the node list uses the same syntax as a CPU list
+  if (!(online >> list) || !parse_cpu_list(list, nodes))
+    return {0};
+
+  std::vector<int> ids;
+  for (int node = 0; node < CPU_SETSIZE; ++node)
+    if (CPU_ISSET(node, &nodes))
+      ids.push_back(node);
+  return ids;
+}
+
+int ipc::current_numa_node() {
+  unsigned cpu = 0, node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == -1)
+    return -1;
+  return static_cast<int>(node);
+}
+
+int ipc::numa_node_of(const void *addr) {
+  int node = -1;
+  if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, addr,
+              MPOL_F_NODE | MPOL_F_ADDR) == -1)
+    return -1;
+  return node;
+}
+
+bool ipc::bind_memory_to_node(void *addr, size_t size, int node) {
+  if (node < 0 || static_cast<unsigned long>(node) >= MAX_NODES)
+    return false;
+
+  const NodeMask mask(node);
+  if (syscall(SYS_mbind, addr, size, MPOL_BIND, mask.bits, MAX_NODES + 1,
+              MPOL_MF_MOVE) == -1) {
+    perror("mbind");
+    return false;
+  }
+  return true;
+}
+
+bool ipc::bind_thread_to_node(int node) {
+  if (node < 0 || static_cast<unsigned long>(node) >= MAX_NODES)
+    return false;
+
+  std::ifstream cpulist("/sys/devices/system/node/node" +
+                        std::to_string(node) + "/cpulist");
+  std::string list;
+  cpu_set_t cpus;
+  if (!(cpulist >> list) || !parse_cpu_list(list, cpus)) {
+    fprintf(stderr, "NUMA node %d has no CPUs\n", node);
+    return false;
+  }
+
+  if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+    perror("sched_setaffinity");
+    return false;
+  }
+
+  // Allocations fall back to other nodes instead of failing.
+  const NodeMask mask(node);
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.bits, MAX_NODES + 1) ==
+      -1)
+    perror("set_mempolicy");
+  return true;
+}
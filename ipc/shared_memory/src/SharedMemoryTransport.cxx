@@ -1,48 +1,69 @@
 // ipc/shared_memory/SharedMemoryTransport.cpp
 #include <SharedMemoryTransport.hpp>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <fcntl.h>
+#include <new>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-ipc::SharedMemoryTransport::SharedMemoryTransport() {}
+namespace {
+
+/*!
+ * @brief Waits on the single-slot condition variable until `ready` holds.
+ * The mutex must be held.
+ *
+ * @return False if the deadline passed first.
+ */
+template <typename Ready>
+bool wait_slot(ipc::IPCMessageSHM *slot, const ipc::Deadline &deadline,
+               Ready &&ready) {
+  while (!ready()) {
+    if (deadline.is_never()) {
+      pthread_cond_wait(&slot->cond, &slot->mutex);
+      continue;
+    }
+    const timespec when = deadline.realtime_timespec();
+    if (pthread_cond_timedwait(&slot->cond, &slot->mutex, &when) ==
+            ETIMEDOUT &&
+        !ready())
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+ipc::SharedMemoryTransport::SharedMemoryTransport(SharedMemoryMode mode,
+                                                  uint32_t ring_capacity,
+                                                  WaitStrategy wait)
+    : mode(mode), ring_capacity(round_up_pow2(ring_capacity)),
+      wait_strategy(wait) {}
 
 ipc::SharedMemoryTransport::~SharedMemoryTransport() { cleanup(); }
 
 bool ipc::SharedMemoryTransport::initialize(const std::string &name,
   bool create) {
-  shm_name = "/" + name;
+  if (mode == SharedMemoryMode::Ring) {
+    return initialize_rings(name, create);
+  }
 
   if (create) {
-    shm_fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0666);
-    if (shm_fd == -1) {
-      perror("shm_open create");
-      return false;
-    }
-
-    if (ftruncate(shm_fd, sizeof(IPCMessageSHM)) == -1) {
-      perror("ftruncate");
+    if (!segment.create(name, sizeof(IPCMessageSHM)))
       return false;
-    }
-
-    is_owner = true;
   } else {
-    shm_fd = shm_open(shm_name.c_str(), O_RDWR, 0666);
-    if (shm_fd == -1) {
-      perror("shm_open open");
+    if (!segment.open(name))
+      return false;
+    if (segment.size() < sizeof(IPCMessageSHM)) {
+      fprintf(stderr, "shared memory segment is truncated\n");
+      cleanup();
       return false;
     }
   }
 
-  void *ptr = mmap(nullptr, sizeof(IPCMessageSHM), PROT_READ | PROT_WRITE,
-  MAP_SHARED, shm_fd, 0);
-  if (ptr == MAP_FAILED) {
-    perror("mmap");
-    return false;
-  }
-
-  shared_msg = static_cast<IPCMessageSHM *>(ptr);
+  shared_msg = static_cast<IPCMessageSHM *>(segment.data());
 
   if (create) {
     pthread_mutexattr_t mattr;
@@ -61,62 +82,383 @@ bool ipc::SharedMemoryTransport::initialize(const std::string &name,
     shared_msg->counter = 0;
     shared_msg->ready = false;
     shared_msg->finished = false;
+    shared_msg->channel = 0;
     memset(shared_msg->data, 0, sizeof(shared_msg->data));
+    shared_msg->doorbell_armed.store(0, std::memory_order_relaxed);
+
+    if (!segment.publish()) {
+      cleanup();
+      return false;
+    }
+  }
+
+  // Made only once the receiver asks for its readiness descriptor.
+  rx_doorbell.bind(Doorbell::path_for(name, 0));
+  return true;
+}
+
+bool ipc::SharedMemoryTransport::initialize_rings(const std::string &name,
+                                                  bool create) {
+  // Doorbell i is rung by the producer of ring i. In memfd mode they are
+  // eventfds the creator passes along with the segment; otherwise FIFOs
+  // made only once a consumer asks for its readiness descriptor.
+  const int tx = create ? 0 : 1;
+  int doorbells[2] = {-1, -1};
+
+  if (create) {
+    if (ring_capacity == 0) {
+      fprintf(stderr, "shared memory ring capacity is too large\n");
+      return false;
+    }
+    const size_t size =
+        sizeof(SharedRingHeader) + 2 * MessageRing::bytes_for(ring_capacity);
+    if (!segment.create(name, size)) {
+      cleanup();
+      return false;
+    }
+  } else if (!segment.open(name, doorbells, 2)) {
+    return false;
+  } else if (segment.size() < sizeof(SharedRingHeader)) {
+    fprintf(stderr, "shared memory segment is not a ring segment\n");
+    for (int fd : doorbells)
+      if (fd != -1)
+        ::close(fd);
+    cleanup();
+    return false;
   }
 
+  if (create && segment.report().memfd &&
+      !Doorbell::make_eventfds(doorbells, 2)) {
+    cleanup();
+    return false;
+  }
+  if (doorbells[0] != -1) {
+    tx_doorbell.adopt(doorbells[tx]);
+    rx_doorbell.adopt(doorbells[1 - tx]);
+  } else {
+    tx_doorbell.bind(Doorbell::path_for(name, tx));
+    rx_doorbell.bind(Doorbell::path_for(name, 1 - tx));
+  }
+
+  auto *header = static_cast<SharedRingHeader *>(segment.data());
+  if (create) {
+    header->capacity = ring_capacity;
+    for (int i = 0; i < 2; ++i) {
+      header->readable[i].init();
+      header->writable[i].init();
+    }
+  } else {
+    if (header->magic.load(std::memory_order_acquire) != SHARED_RING_MAGIC) {
+      fprintf(stderr, "shared memory ring segment is not initialized\n");
+      cleanup();
+      return false;
+    }
+    ring_capacity = header->capacity;
+    if (segment.size() < sizeof(SharedRingHeader) +
+                             2 * MessageRing::bytes_for(ring_capacity)) {
+      fprintf(stderr, "shared memory ring segment is truncated\n");
+      cleanup();
+      return false;
+    }
+  }
+
+  char *base = reinterpret_cast<char *>(header + 1);
+  auto *forward = reinterpret_cast<MessageRing *>(base);
+  auto *backward = reinterpret_cast<MessageRing *>(
+      base + MessageRing::bytes_for(ring_capacity));
+
+  if (create) {
+    new (forward) MessageRing;
+    new (backward) MessageRing;
+    forward->init(ring_capacity);
+    backward->init(ring_capacity);
+    header->magic.store(SHARED_RING_MAGIC, std::memory_order_release);
+    if (!segment.publish(doorbells, tx_doorbell.fd() != -1 ? 2 : 0)) {
+      cleanup();
+      return false;
+    }
+  }
+
+  // The creator produces into the first ring, the opener into the second.
+  tx_ring = create ? forward : backward;
+  rx_ring = create ? backward : forward;
+  tx_readable = &header->readable[tx];
+  tx_writable = &header->writable[tx];
+  rx_readable = &header->readable[1 - tx];
+  rx_writable = &header->writable[1 - tx];
   return true;
 }
 
 bool ipc::SharedMemoryTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::SharedMemoryTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::SharedMemoryTransport::send_for(const IPCMessage &msg,
+                                     std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::SharedMemoryTransport::receive_for(IPCMessage &msg,
+                                        std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::SharedMemoryTransport::send_until(const IPCMessage &msg,
+                                       const Deadline &deadline) {
+  if (mode == SharedMemoryMode::Ring) {
+    if (!tx_ring || loan_outstanding)
+      return IPCStatus::Error;
+    const bool sent = with_wait_strategy(wait_strategy, [&](auto policy) {
+      return decltype(policy)::wait_until(
+          *tx_writable, [&] { return tx_ring->try_push(msg); }, deadline);
+    });
+    if (!sent)
+      return IPCStatus::Timeout;
+    notify_readable();
+    return IPCStatus::Ok;
+  }
+
+  if (!shared_msg)
+    return IPCStatus::Error;
+
   pthread_mutex_lock(&shared_msg->mutex);
-  while (shared_msg->ready) {
-    pthread_cond_wait(&shared_msg->cond, &shared_msg->mutex);
+  if (!wait_slot(shared_msg, deadline, [&] { return !shared_msg->ready; })) {
+    pthread_mutex_unlock(&shared_msg->mutex);
+    return IPCStatus::Timeout;
   }
 
   shared_msg->counter = msg.counter;
   shared_msg->finished = msg.finished;
+  shared_msg->channel = msg.channel;
   strncpy(shared_msg->data, msg.data, sizeof(shared_msg->data));
   shared_msg->ready = true;
 
   pthread_cond_signal(&shared_msg->cond);
   pthread_mutex_unlock(&shared_msg->mutex);
 
-  return true;
+  // The receiver arms with the mutex held, so the flag is visible here.
+  rx_doorbell.ring(shared_msg->doorbell_armed);
+  return IPCStatus::Ok;
 }
 
-bool ipc::SharedMemoryTransport::receive_message(IPCMessage &msg) {
+ipc::IPCStatus
+ipc::SharedMemoryTransport::receive_until(IPCMessage &msg,
+                                          const Deadline &deadline) {
+  if (mode == SharedMemoryMode::Ring) {
+    if (!rx_ring || acquire_outstanding)
+      return IPCStatus::Error;
+    const bool received = with_wait_strategy(wait_strategy, [&](auto policy) {
+      return decltype(policy)::wait_until(
+          *rx_readable, [&] { return rx_ring->try_pop(msg); }, deadline);
+    });
+    if (!received && !arm_and_pop(msg))
+      return IPCStatus::Timeout;
+    rx_writable->notify();
+    return IPCStatus::Ok;
+  }
+
+  if (!shared_msg)
+    return IPCStatus::Error;
+
   pthread_mutex_lock(&shared_msg->mutex);
-  while (!shared_msg->ready) {
-    pthread_cond_wait(&shared_msg->cond, &shared_msg->mutex);
+  if (!wait_slot(shared_msg, deadline, [&] { return shared_msg->ready; })) {
+    // No sender can fill the slot before the mutex is released.
+    if (doorbell_in_use)
+      rx_doorbell.arm(shared_msg->doorbell_armed);
+    pthread_mutex_unlock(&shared_msg->mutex);
+    return IPCStatus::Timeout;
   }
 
   msg.counter = shared_msg->counter;
   msg.finished = shared_msg->finished;
+  msg.channel = shared_msg->channel;
   strncpy(msg.data, shared_msg->data, sizeof(msg.data));
   shared_msg->ready = false;
 
   pthread_cond_signal(&shared_msg->cond);
   pthread_mutex_unlock(&shared_msg->mutex);
 
+  return IPCStatus::Ok;
+}
+
+size_t ipc::SharedMemoryTransport::send_batch(const IPCMessage *msgs,
+                                              size_t count) {
+  if (mode != SharedMemoryMode::Ring)
+    return IIPCTransport::send_batch(msgs, count);
+  if (!tx_ring || loan_outstanding)
+    return 0;
+
+  size_t sent = 0;
+  while (sent < count) {
+    with_wait_strategy(wait_strategy, [&](auto policy) {
+      decltype(policy)::wait(*tx_writable, [&] {
+        const size_t pushed =
+            tx_ring->try_push_batch(msgs + sent, count - sent);
+        sent += pushed;
+        return pushed > 0;
+      });
+    });
+    notify_readable();
+  }
+  return sent;
+}
+
+size_t ipc::SharedMemoryTransport::receive_batch(IPCMessage *msgs,
+                                                 size_t max) {
+  if (mode != SharedMemoryMode::Ring)
+    return IIPCTransport::receive_batch(msgs, max);
+  if (!rx_ring || acquire_outstanding || max == 0)
+    return 0;
+
+  size_t received = 0;
+  with_wait_strategy(wait_strategy, [&](auto policy) {
+    decltype(policy)::wait(*rx_readable, [&] {
+      received = rx_ring->try_pop_batch(msgs, max);
+      return received > 0;
+    });
+  });
+  rx_writable->notify();
+  return received;
+}
+
+ipc::IPCMessage *ipc::SharedMemoryTransport::loan() {
+  return loan_until(Deadline::never());
+}
+
+ipc::IPCMessage *
+ipc::SharedMemoryTransport::loan_for(std::chrono::nanoseconds timeout) {
+  return loan_until(Deadline(timeout));
+}
+
+bool ipc::SharedMemoryTransport::commit() {
+  if (!loan_outstanding)
+    return false;
+
+  tx_ring->commit();
+  loan_outstanding = false;
+  notify_readable();
+  return true;
+}
+
+const ipc::IPCMessage *ipc::SharedMemoryTransport::acquire() {
+  return acquire_until(Deadline::never());
+}
+
+const ipc::IPCMessage *
+ipc::SharedMemoryTransport::acquire_for(std::chrono::nanoseconds timeout) {
+  return acquire_until(Deadline(timeout));
+}
+
+bool ipc::SharedMemoryTransport::release() {
+  if (!acquire_outstanding)
+    return false;
+
+  rx_ring->release();
+  acquire_outstanding = false;
+  rx_writable->notify();
   return true;
 }
 
 void ipc::SharedMemoryTransport::cleanup() {
-  if (shared_msg) {
-    munmap(shared_msg, sizeof(IPCMessage));
-    shared_msg = nullptr;
-  }
+  shared_msg = nullptr;
+  tx_ring = nullptr;
+  rx_ring = nullptr;
+  tx_readable = tx_writable = rx_readable = rx_writable = nullptr;
+  loan_outstanding = false;
+  acquire_outstanding = false;
+  doorbell_in_use = false;
+  tx_doorbell.close();
+  rx_doorbell.close();
+  segment.close();
+}
 
-  if (shm_fd != -1) {
-    close(shm_fd);
-    shm_fd = -1;
-  }
+int ipc::SharedMemoryTransport::readiness_fd() {
+  if (!rx_ring && !shared_msg)
+    return -1;
+  doorbell_in_use = true;
+  return rx_doorbell.listen();
+}
+
+void ipc::SharedMemoryTransport::notify_readable() {
+  tx_readable->notify();
+  tx_doorbell.ring(*tx_readable);
+}
+
+ipc::IPCMessage *
+ipc::SharedMemoryTransport::loan_until(const Deadline &deadline) {
+  if (!tx_ring || loan_outstanding)
+    return nullptr;
 
-  if (is_owner) {
-    shm_unlink(shm_name.c_str());
+  IPCMessage *slot = nullptr;
+  with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        *tx_writable,
+        [&] {
+          slot = tx_ring->producer_slot();
+          return slot != nullptr;
+        },
+        deadline);
+  });
+  loan_outstanding = slot != nullptr;
+  return slot;
+}
+
+const ipc::IPCMessage *
+ipc::SharedMemoryTransport::acquire_until(const Deadline &deadline) {
+  if (!rx_ring || acquire_outstanding)
+    return nullptr;
+
+  const IPCMessage *slot = nullptr;
+  with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        *rx_readable,
+        [&] {
+          slot = rx_ring->consumer_slot();
+          return slot != nullptr;
+        },
+        deadline);
+  });
+  if (!slot && doorbell_in_use) {
+    // As in arm_and_pop(), so that a null result guarantees a later ring.
+    rx_doorbell.arm(*rx_readable);
+    slot = rx_ring->consumer_slot();
   }
+  acquire_outstanding = slot != nullptr;
+  return slot;
+}
+
+bool ipc::SharedMemoryTransport::arm_and_pop(IPCMessage &msg) {
+  if (!doorbell_in_use)
+    return false;
+  rx_doorbell.arm(*rx_readable);
+  return rx_ring->try_pop(msg);
 }
 
 ipc::IPCMessageSHM *ipc::SharedMemoryTransport::get_shared_message() const {
   return shared_msg;
 }
+
+void ipc::SharedMemoryTransport::set_segment_options(
+    const ShmSegmentOptions &options) {
+  segment.set_options(options);
+}
+
+const ipc::ShmSegmentReport &
+ipc::SharedMemoryTransport::segment_report() const {
+  return segment.report();
+}
+
+ipc::SharedMemoryMode ipc::SharedMemoryTransport::get_mode() const {
+  return mode;
+}
+
+ipc::WaitStrategy ipc::SharedMemoryTransport::get_wait_strategy() const {
+  return wait_strategy;
+}
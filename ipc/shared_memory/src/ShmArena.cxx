@@ -0,0 +1,167 @@
+#include <ShmArena.hpp>
+#include <cerrno>
+#include <cstdio>
+
+namespace {
+
+/*! @brief Returns the size class that fits `bytes` (header included). */
+unsigned class_for(size_t bytes) {
+  unsigned cls = 0;
+  while ((size_t(1) << (ipc::ShmArena::MIN_BLOCK_SHIFT + cls)) < bytes)
+    ++cls;
+  return cls;
+}
+
+/*! @brief Returns the size in bytes of a block of class `cls`. */
+uint64_t block_size(unsigned cls) {
+  return uint64_t(1) << (ipc::ShmArena::MIN_BLOCK_SHIFT + cls);
+}
+
+/*! @brief Converts a block offset into a free list link. */
+uint32_t link_of(uint64_t block) {
+  return static_cast<uint32_t>((block >> ipc::ShmArena::MIN_BLOCK_SHIFT) + 1);
+}
+
+/*! @brief Converts a nonzero free list link back into a block offset. */
+uint64_t block_of(uint32_t link) {
+  return uint64_t(link - 1) << ipc::ShmArena::MIN_BLOCK_SHIFT;
+}
+
+} // namespace
+
+void ipc::ShmArena::init(size_t pool_bytes) {
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+  pthread_mutex_init(&lock, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  for (auto &head : free_lists)
+    head = 0;
+  pool_size = pool_bytes;
+
+  // Cover the pool with the largest blocks aligned to their own size; their
+  // sizes strictly decrease, so no block has a buddy outside the pool.
+  uint64_t block = 0;
+  for (unsigned cls = NUM_CLASSES; cls-- > 0;) {
+    if (block + block_size(cls) <= pool_size) {
+      push_free(block, cls);
+      block += block_size(cls);
+    }
+  }
+}
+
+uint64_t ipc::ShmArena::allocate(size_t size) {
+  const unsigned cls = class_for(size + BLOCK_HEADER_SIZE);
+  if (cls >= NUM_CLASSES || block_size(cls) > pool_size)
+    return NPOS;
+
+  if (!lock_lists())
+    return NPOS;
+  unsigned found = cls;
+  while (found < NUM_CLASSES && free_lists[found] == 0)
+    ++found;
+  if (found == NUM_CLASSES) {
+    unlock_lists();
+    return NPOS;
+  }
+
+  // Split the block, returning the upper halves, until it fits.
+  const uint64_t block = block_of(free_lists[found]);
+  unlink_free(block);
+  while (found > cls) {
+    --found;
+    push_free(block + block_size(found), found);
+  }
+  BlockHeader *header = block_at(block);
+  header->size_class = cls;
+  header->free = 0;
+  unlock_lists();
+  return block + BLOCK_HEADER_SIZE;
+}
+
+void ipc::ShmArena::deallocate(uint64_t offset) {
+  uint64_t block = offset - BLOCK_HEADER_SIZE;
+
+  if (!lock_lists())
+    return;
+  unsigned cls = block_at(block)->size_class;
+  // A block's buddy is either whole or split into smaller blocks, so its
+  // first bytes always hold a valid header once the merged block would
+  // still be inside the pool.
+  while (cls + 1 < NUM_CLASSES) {
+    const uint64_t buddy = block ^ block_size(cls);
+    const uint64_t merged = block < buddy ? block : buddy;
+    if (merged + block_size(cls + 1) > pool_size)
+      break;
+    const BlockHeader *other = block_at(buddy);
+    if (!other->free || other->size_class != cls)
+      break;
+    unlink_free(buddy);
+    block = merged;
+    ++cls;
+  }
+  push_free(block, cls);
+  unlock_lists();
+}
+
+size_t ipc::ShmArena::capacity_of(uint64_t offset) {
+  return block_size(header_of(offset)->size_class) - BLOCK_HEADER_SIZE;
+}
+
+void ipc::ShmArena::push_free(uint64_t block, unsigned cls) {
+  BlockHeader *header = block_at(block);
+  header->size_class = cls;
+  header->free = 1;
+  header->prev = 0;
+  header->next = free_lists[cls];
+  if (header->next != 0)
+    block_at(block_of(header->next))->prev = link_of(block);
+  free_lists[cls] = link_of(block);
+}
+
+void ipc::ShmArena::unlink_free(uint64_t block) {
+  BlockHeader *header = block_at(block);
+  if (header->prev != 0)
+    block_at(block_of(header->prev))->next = header->next;
+  else
+    free_lists[header->size_class] = header->next;
+  if (header->next != 0)
+    block_at(block_of(header->next))->prev = header->prev;
+  header->free = 0;
+}
+
+bool ipc::ShmArena::lock_lists() {
+  const int result = pthread_mutex_lock(&lock);
+  if (result == EOWNERDEAD) {
+    // The holder died, possibly halfway through a list update.
+    rebuild_lists();
+    pthread_mutex_consistent(&lock);
+    return true;
+  }
+  if (result != 0) {
+    errno = result;
+    perror("pthread_mutex_lock arena");
+    return false;
+  }
+  return true;
+}
+
+void ipc::ShmArena::rebuild_lists() {
+  for (auto &head : free_lists)
+    head = 0;
+
+  // Every header on the walk is current: a split or merge in progress only
+  // rewrites headers inside the block whose header still spans them.
+  uint64_t block = 0;
+  while (block < pool_size) {
+    BlockHeader *header = block_at(block);
+    const unsigned cls = header->size_class;
+    if (cls >= NUM_CLASSES || block + block_size(cls) > pool_size)
+      break;
+    if (header->free)
+      push_free(block, cls);
+    block += block_size(cls);
+  }
+}
@@ -0,0 +1,337 @@
+#include <Deadline.hpp>
+#include <FdPassing.hpp>
+#include <NumaPlacement.hpp>
+#include <ShmSegment.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <linux/magic.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/*!
+ * @brief Returns true if the kernel's shmem THP policy can give huge pages
+ * to a mapping that asked for them with MADV_HUGEPAGE.
+ */
+bool shmem_thp_enabled() {
+  std::ifstream policy("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+  std::string word;
+  while (policy >> word) {
+    if (word.front() == '[')
+      return word != "[never]" && word != "[deny]";
+  }
+  return false;
+}
+
+/*! @brief Returns true if every page of [addr, addr + size) is resident. */
+bool fully_resident(void *addr, size_t size, size_t page_size) {
+  const size_t sys_page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> pages((size + sys_page - 1) / sys_page);
+  if (mincore(addr, size, pages.data()) == -1)
+    return page_size > sys_page; // hugetlbfs pages are always populated
+  for (unsigned char page : pages)
+    if (!(page & 1))
+      return false;
+  return true;
+}
+
+} // namespace
+
+ipc::ShmSegment::~ShmSegment() { close(); }
+
+void ipc::ShmSegment::set_options(const ShmSegmentOptions &opts) {
+  options = opts;
+}
+
+bool ipc::ShmSegment::create(const std::string &name, size_t size) {
+  close();
+  base_name = name;
+  shm_name = "/" + name;
+
+  // Huge pages are reserved at mmap time, so without a mount or without
+  // enough free huge pages only the ordinary backing can succeed.
+  if (options.huge_pages && create_object(size, true))
+    return true;
+  return create_object(size, false);
+}
+
+bool ipc::ShmSegment::create_object(size_t size, bool huge) {
+  if (options.memfd) {
+    unsigned flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+    if (huge)
+      flags |= MFD_HUGETLB;
+    shm_fd = memfd_create(base_name.c_str(), flags);
+    if (shm_fd == -1) {
+      perror("memfd_create");
+      return false;
+    }
+  } else if (huge) {
+    const std::string mount = hugetlbfs_mount();
+    if (mount.empty())
+      return false;
+    huge_path = mount + shm_name;
+    shm_fd = ::open(huge_path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0666);
+    if (shm_fd == -1) {
+      perror("open hugetlbfs");
+      huge_path.clear();
+      return false;
+    }
+  } else {
+    shm_fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0666);
+    if (shm_fd == -1) {
+      perror("shm_open create");
+      return false;
+    }
+  }
+  owner = true;
+
+  struct statfs fs {};
+  const size_t page_size =
+      fstatfs(shm_fd, &fs) == 0 ? static_cast<size_t>(fs.f_bsize) : 4096;
+  size = (size + page_size - 1) / page_size * page_size;
+
+  if (ftruncate(shm_fd, size) == -1) {
+    perror("ftruncate");
+    close();
+    return false;
+  }
+
+  // Peers map the whole object, so it must never shrink (SIGBUS) or grow.
+  if (options.memfd &&
+      fcntl(shm_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) ==
+          -1)
+    perror("fcntl F_ADD_SEALS");
+
+  // Closing on failure unlinks a hugetlbfs file, so the fallback starts
+  // from a clean slate.
+  return map(size);
+}
+
+bool ipc::ShmSegment::open(const std::string &name, int *extra,
+                           size_t extra_count) {
+  close();
+  base_name = name;
+  shm_name = "/" + name;
+
+  if (options.memfd)
+    return open_memfd(extra, extra_count);
+
+  shm_fd = shm_open(shm_name.c_str(), O_RDWR, 0666);
+  if (shm_fd == -1 && errno == ENOENT) {
+    const std::string mount = hugetlbfs_mount();
+    if (!mount.empty())
+      shm_fd = ::open((mount + shm_name).c_str(), O_RDWR);
+    if (shm_fd == -1)
+      errno = ENOENT;
+  }
+  if (shm_fd == -1) {
+    perror("shm_open open");
+    return false;
+  }
+
+  struct stat st {};
+  if (fstat(shm_fd, &st) == -1) {
+    perror("fstat");
+    close();
+    return false;
+  }
+
+  return map(static_cast<size_t>(st.st_size));
+}
+
+bool ipc::ShmSegment::open_memfd(int *extra, size_t extra_count) {
+  const int sock =
+      connect_abstract(rendezvous_name(), options.rendezvous_timeout_ms);
+  if (sock == -1)
+    return false;
+
+  shm_fd = receive_descriptor(sock);
+  size_t received = 0;
+  while (shm_fd != -1 && received < extra_count &&
+         (extra[received] = receive_descriptor(sock)) != -1)
+    ++received;
+  ::close(sock);
+  if (received < extra_count) {
+    for (size_t i = 0; i < received; ++i)
+      ::close(extra[i]);
+    close();
+    return false;
+  }
+  if (shm_fd == -1)
+    return false;
+
+  struct stat st {};
+  if (fstat(shm_fd, &st) == -1) {
+    perror("fstat");
+    close();
+    return false;
+  }
+
+  return map(static_cast<size_t>(st.st_size));
+}
+
+bool ipc::ShmSegment::publish(const int *extra, size_t extra_count) {
+  if (!options.memfd)
+    return true;
+  if (shm_fd == -1)
+    return false;
+
+  const int listener = listen_abstract(rendezvous_name());
+  if (listener == -1)
+    return false;
+
+  const Deadline deadline(
+      std::chrono::milliseconds(options.rendezvous_timeout_ms));
+  pollfd pfd{listener, POLLIN, 0};
+  int ready;
+  do {
+    const timespec remaining = deadline.remaining_timespec();
+    ready = ppoll(&pfd, 1, &remaining, nullptr);
+  } while (ready == -1 && errno == EINTR);
+  if (ready != 1) {
+    if (ready == 0)
+      fprintf(stderr, "no peer opened memfd segment %s in time\n",
+              base_name.c_str());
+    else
+      perror("ppoll");
+    ::close(listener);
+    return false;
+  }
+
+  int peer;
+  while ((peer = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC)) < 0 &&
+         errno == EINTR) {
+  }
+  ::close(listener);
+  if (peer < 0) {
+    perror("accept");
+    return false;
+  }
+
+  bool sent = send_descriptor(peer, shm_fd);
+  for (size_t i = 0; sent && i < extra_count; ++i)
+    sent = send_descriptor(peer, extra[i]);
+  ::close(peer);
+  return sent;
+}
+
+std::string ipc::ShmSegment::rendezvous_name() const {
+  return "ipc-shm/" + base_name;
+}
+
+bool ipc::ShmSegment::map(size_t map_size) {
+  status = ShmSegmentReport{};
+  status.memfd = options.memfd;
+  if (options.memfd) {
+    const int seals = fcntl(shm_fd, F_GET_SEALS);
+    status.sealed = seals != -1 && (seals & F_SEAL_SHRINK) &&
+                    (seals & F_SEAL_GROW);
+  }
+
+  struct statfs fs {};
+  if (fstatfs(shm_fd, &fs) == 0) {
+    status.huge_pages = fs.f_type == HUGETLBFS_MAGIC;
+    status.page_size = static_cast<size_t>(fs.f_bsize);
+  }
+
+  // THP advice and NUMA binding must precede the first touch, so in those
+  // cases pages are populated after mapping instead of by MAP_POPULATE.
+  const bool populate_later =
+      options.transparent_huge_pages || options.numa_node >= 0;
+  int flags = MAP_SHARED;
+  if (options.prefault && !populate_later)
+    flags |= MAP_POPULATE;
+
+  void *ptr =
+      mmap(nullptr, map_size, PROT_READ | PROT_WRITE, flags, shm_fd, 0);
+  if (ptr == MAP_FAILED) {
+    perror("mmap");
+    close();
+    return false;
+  }
+
+  base = ptr;
+  length = map_size;
+  status.size = map_size;
+
+  if (options.numa_node >= 0)
+    status.numa_bound = bind_memory_to_node(base, length, options.numa_node);
+
+  if (options.transparent_huge_pages && !status.huge_pages)
+    status.transparent_huge_pages =
+        madvise(base, length, MADV_HUGEPAGE) == 0 && shmem_thp_enabled();
+
+  if (options.prefault && populate_later)
+    madvise(base, length, MADV_POPULATE_WRITE);
+
+  if (options.lock) {
+    if (mlock(base, length) == 0)
+      status.locked = true;
+    else
+      perror("mlock");
+  }
+
+  if (options.prefault || options.lock)
+    status.prefaulted = fully_resident(base, length, status.page_size);
+
+  // Querying faults the page in, which is only harmless once it is resident
+  // or bound to its node anyway.
+  unsigned char first_page = 0;
+  if (status.numa_bound ||
+      (mincore(base, 1, &first_page) == 0 && (first_page & 1)))
+    status.numa_node = numa_node_of(base);
+
+  return true;
+}
+
+std::string ipc::ShmSegment::hugetlbfs_mount() {
+  std::ifstream mounts("/proc/mounts");
+  std::string line;
+  while (std::getline(mounts, line)) {
+    std::istringstream fields(line);
+    std::string device, mount_point, type;
+    if (fields >> device >> mount_point >> type && type == "hugetlbfs")
+      return mount_point;
+  }
+  return std::string();
+}
+
+void ipc::ShmSegment::close() {
+  if (base) {
+    munmap(base, length);
+    base = nullptr;
+    length = 0;
+  }
+
+  if (shm_fd != -1) {
+    ::close(shm_fd);
+    shm_fd = -1;
+  }
+
+  if (owner && !options.memfd) {
+    if (!huge_path.empty())
+      unlink(huge_path.c_str());
+    else
+      shm_unlink(shm_name.c_str());
+  }
+  owner = false;
+  huge_path.clear();
+  status = ShmSegmentReport{};
+}
+
+void *ipc::ShmSegment::data() const { return base; }
+
+size_t ipc::ShmSegment::size() const { return length; }
+
+bool ipc::ShmSegment::is_owner() const { return owner; }
+
+const ipc::ShmSegmentReport &ipc::ShmSegment::report() const { return status; }
@@ -0,0 +1,48 @@
+#include <WaitStrategy.hpp>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+void ipc::WaitPoint::init() {
+  sequence.store(0, std::memory_order_relaxed);
+  futex_waiters.store(0, std::memory_order_relaxed);
+  cond_waiters.store(0, std::memory_order_relaxed);
+  doorbell_armed.store(0, std::memory_order_relaxed);
+
+  pthread_mutexattr_t mattr;
+  pthread_condattr_t cattr;
+
+  pthread_mutexattr_init(&mattr);
+  pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+  pthread_mutex_init(&mutex, &mattr);
+  pthread_mutexattr_destroy(&mattr);
+
+  pthread_condattr_init(&cattr);
+  pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+  pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+  pthread_cond_init(&cond, &cattr);
+  pthread_condattr_destroy(&cattr);
+}
+
+void ipc::WaitPoint::futex_wait(uint32_t expected, const timespec *timeout) {
+  // Shared (non-private) futex: the word lives in memory mapped by several
+  // processes. EAGAIN, EINTR and ETIMEDOUT simply send the caller back to
+  // its re-check.
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&sequence), FUTEX_WAIT,
+          expected, timeout, nullptr, 0);
+}
+
+void ipc::WaitPoint::wake_all() {
+  if (futex_waiters.load(std::memory_order_relaxed) != 0) {
+    sequence.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&sequence), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+  }
+
+  if (cond_waiters.load(std::memory_order_relaxed) != 0) {
+    pthread_mutex_lock(&mutex);
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+  }
+}
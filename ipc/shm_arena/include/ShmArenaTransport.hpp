@@ -0,0 +1,308 @@
+#ifndef SHM_ARENA_TRANSPORT_HPP
+#define SHM_ARENA_TRANSPORT_HPP
+
+#include <Doorbell.hpp>      // For the readiness descriptor
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SPSCRing.hpp>      // For the descriptor rings
+#include <ShmArena.hpp>      // For the in-segment payload allocator
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For the wait policies
+#include <atomic>            // For std::atomic
+#include <cstdint>           // For fixed-width integer types
+#include <vector>            // For std::vector
+
+namespace ipc {
+
+/*!
+ * @brief Describes one variable-size message travelling through a ring.
+ *
+ * Only this descriptor is copied between processes; the payload stays in
+ * the arena at `offset` until the receiver releases it.
+ */
+struct ArenaDescriptor {
+  /*! @brief Payload offset inside the shared ShmArena. */
+  uint64_t offset;
+
+  /*! @brief Payload length in bytes. */
+  uint64_t size;
+};
+
+/*! @brief Ring type used for each direction of a ShmArenaTransport. */
+using DescriptorRing = SPSCRing<ArenaDescriptor>;
+
+/*!
+ * @brief Header placed at the start of an arena transport segment.
+ *
+ * It is followed by two DescriptorRing instances (creator to opener, then
+ * opener to creator) and by the ShmArena both directions allocate from.
+ */
+struct ShmArenaHeader {
+  /*! @brief Set to `SHM_ARENA_MAGIC` once the segment is initialized. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Number of descriptors in each ring. */
+  uint32_t ring_capacity;
+
+  /*! @brief Size of the arena pool in bytes. */
+  uint64_t arena_size;
+
+  /*! @brief Notified after a descriptor is pushed into ring 0 or 1. */
+  WaitPoint readable[2];
+
+  /*! @brief Notified after a descriptor is popped from ring 0 or 1. */
+  WaitPoint writable[2];
+
+  /*! @brief Notified whenever a payload block is returned to the arena. */
+  WaitPoint freed;
+};
+
+/*!
+ * @brief Implements the IIPCTransport interface with variable-size messages
+ * in POSIX shared memory.
+ *
+ * Payloads of any size up to the arena capacity are written once into a
+ * buddy allocator inside the segment, and only an (offset, size)
+ * descriptor travels through a single-producer/single-consumer ring per
+ * direction. Receivers either copy the payload out with `receive()` or read
+ * it in place with `receive_buffer()` followed by `release_buffer()`.
+ *
+ * The fixed-size `send_message`/`receive_message` calls are kept for
+ * compatibility and transfer a whole IPCMessage as one payload.
+ */
+class ShmArenaTransport : public IIPCTransport {
+public:
+  /*! @brief Default arena pool size. */
+  static constexpr size_t DEFAULT_ARENA_SIZE = 64u << 20;
+
+  /*! @brief Default number of descriptors per direction. */
+  static constexpr uint32_t DEFAULT_RING_CAPACITY = 1024;
+
+  /*! @brief Value stored in ShmArenaHeader::magic once ready. */
+  static constexpr uint32_t SHM_ARENA_MAGIC = 0x41524e41; // "ARNA"
+
+  /*!
+   * @brief Constructs a new ShmArenaTransport object.
+   *
+   * @param arena_size Bytes available for in-flight payloads, shared by both
+   * directions. Only used by the creator.
+   * @param ring_capacity Descriptors per direction, rounded up to a power of
+   * two. Only used by the creator, whose `initialize()` fails above
+   * MAX_QUEUE_CAPACITY.
+   * @param wait How this instance waits on full rings, empty rings and an
+   * exhausted arena.
+   */
+  explicit ShmArenaTransport(size_t arena_size = DEFAULT_ARENA_SIZE,
+                             uint32_t ring_capacity = DEFAULT_RING_CAPACITY,
+                             WaitStrategy wait = WaitStrategy::Yield);
+
+  /*!
+   * @brief Destroys the ShmArenaTransport object.
+   *
+   * Calls the cleanup method, which unmaps the segment and unlinks it if this
+   * instance created it.
+   */
+  ~ShmArenaTransport() override;
+
+  /*!
+   * @brief Creates or opens the arena segment.
+   *
+   * @param name A unique name for the shared memory object.
+   * @param create True to create and initialize the segment, false to attach
+   * to an existing one.
+   * @return True if initialization is successful, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends a whole IPCMessage as a payload of `sizeof(IPCMessage)`.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if the message was sent, false otherwise.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives a payload and copies it into an IPCMessage.
+   *
+   * Payloads shorter than an IPCMessage leave the remaining bytes of `msg`
+   * zeroed; longer payloads are truncated.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a payload was received, false otherwise.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` in total
+   * for arena space and a free descriptor slot.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for one.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Returns the descriptor of the incoming ring's doorbell.
+   *
+   * Once this has been called, a receive that finds the ring empty arms the
+   * doorbell and the peer writes to it on its next send.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Unmaps the segment and unlinks it if this instance created it.
+   */
+  void cleanup() override;
+
+  /*!
+   * @brief Allocates an arena buffer the caller can fill in place.
+   *
+   * Waits up to `timeout` while the arena is exhausted. The buffer must be
+   * passed to `send_buffer()` exactly once.
+   *
+   * @param size The number of payload bytes needed.
+   * @param timeout How long to wait for space; the default waits until the
+   * peer releases enough. Zero makes a single attempt.
+   * @return A writable pointer into shared memory, or nullptr if not
+   * initialized, `size` exceeds what the arena can ever hold or the timeout
+   * expired.
+   */
+  void *allocate(size_t size, std::chrono::nanoseconds timeout =
+                                  std::chrono::nanoseconds::max());
+
+  /*!
+   * @brief Publishes a buffer obtained from `allocate()` to the peer.
+   *
+   * Only the buffer's offset and `size` are copied into the ring.
+   *
+   * @param buffer A pointer returned by `allocate()`.
+   * @param size The number of valid payload bytes in `buffer`.
+   * @return True if the descriptor was published, false otherwise.
+   */
+  bool send_buffer(void *buffer, size_t size);
+
+  /*!
+   * @brief Copies `size` bytes from `data` into the arena and sends them.
+   *
+   * @param timeout How long to wait for arena space, as for `allocate()`.
+   * @return True if the payload was sent, false otherwise.
+   */
+  bool send(const void *data, size_t size,
+            std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+  /*!
+   * @brief Waits for the next payload and returns it in place.
+   *
+   * The returned buffer stays valid until it is passed to
+   * `release_buffer()`.
+   *
+   * @param size Receives the payload length in bytes.
+   * @return A read-only pointer into shared memory, or nullptr if not
+   * initialized.
+   */
+  const void *receive_buffer(size_t &size);
+
+  /*!
+   * @brief Returns a buffer obtained from `receive_buffer()` to the arena.
+   */
+  void release_buffer(const void *buffer);
+
+  /*!
+   * @brief Waits for the next payload and copies it into `out`.
+   *
+   * @return True if a payload was received, false otherwise.
+   */
+  bool receive(std::vector<char> &out);
+
+  /*!
+   * @brief Selects huge page backing, prefaulting, locking or memfd mode.
+   *
+   * Must be called before `initialize()` to take effect.
+   */
+  void set_segment_options(const ShmSegmentOptions &options);
+
+  /*! @brief Reports which segment options took effect after initialize. */
+  const ShmSegmentReport &segment_report() const;
+
+  /*! @brief Returns the largest payload the arena can hold, in bytes. */
+  size_t max_payload_size() const;
+
+private:
+  /*! @brief Requested arena pool size for a newly created segment. */
+  size_t arena_size;
+
+  /*! @brief Requested descriptors per direction for a new segment. */
+  uint32_t ring_capacity;
+
+  /*! @brief How this instance waits. */
+  WaitStrategy wait_strategy;
+
+  /*! @brief The mapped shared memory segment. */
+  ShmSegment segment;
+
+  /*! @brief The segment header, or nullptr before initialize. */
+  ShmArenaHeader *header = nullptr;
+
+  /*! @brief Ring this instance produces descriptors into. */
+  DescriptorRing *tx_ring = nullptr;
+
+  /*! @brief Ring this instance consumes descriptors from. */
+  DescriptorRing *rx_ring = nullptr;
+
+  /*! @brief Index (0 or 1) of `tx_ring` in the segment. */
+  int tx_index = 0;
+
+  /*! @brief The shared payload allocator. */
+  ShmArena *arena = nullptr;
+
+  /*! @brief Rung after pushing into `tx_ring`. */
+  Doorbell tx_doorbell;
+
+  /*! @brief Rung by the peer after pushing into `rx_ring`. */
+  Doorbell rx_doorbell;
+
+  /*! @brief True once `readiness_fd()` was called, so empty reads arm. */
+  bool doorbell_in_use = false;
+
+  /*!
+   * @brief Maps the sub-structures of an attached segment and binds the
+   * doorbell FIFOs unless eventfds were adopted.
+   */
+  bool attach(const std::string &name, bool create);
+
+  /*!
+   * @brief Allocates a block, waiting for frees until `deadline`.
+   *
+   * @return The block's offset, or ShmArena::NPOS on timeout.
+   */
+  uint64_t allocate_until(size_t size, const Deadline &deadline);
+
+  /*! @brief Pushes `desc` to the peer, giving up at `deadline`. */
+  bool push_until(const ArenaDescriptor &desc, const Deadline &deadline);
+
+  /*! @brief Pops the next descriptor, giving up at `deadline`. */
+  bool pop_until(ArenaDescriptor &desc, const Deadline &deadline);
+
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+};
+} // namespace ipc
+
+#endif // SHM_ARENA_TRANSPORT_HPP
@@ -0,0 +1,308 @@
+#include <ShmArenaTransport.hpp>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace {
+
+/*! @brief Rounds `value` up to a multiple of the cache line size. */
+size_t round_up_line(size_t value) {
+  return (value + ipc::CACHE_LINE_SIZE - 1) & ~(ipc::CACHE_LINE_SIZE - 1);
+}
+
+} // namespace
+
+ipc::ShmArenaTransport::ShmArenaTransport(size_t arena_size,
+                                          uint32_t ring_capacity,
+                                          WaitStrategy wait)
+    : arena_size(round_up_line(arena_size)),
+      ring_capacity(round_up_pow2(ring_capacity)), wait_strategy(wait) {}
+
+ipc::ShmArenaTransport::~ShmArenaTransport() { cleanup(); }
+
+bool ipc::ShmArenaTransport::initialize(const std::string &name, bool create) {
+  // As in SharedMemoryTransport's ring mode: eventfds handed over with a
+  // memfd segment, otherwise FIFOs made only when a consumer polls.
+  int doorbells[2] = {-1, -1};
+  if (create) {
+    if (ring_capacity == 0) {
+      fprintf(stderr, "shared memory arena ring capacity is too large\n");
+      return false;
+    }
+    const size_t size = sizeof(ShmArenaHeader) +
+                        2 * DescriptorRing::bytes_for(ring_capacity) +
+                        ShmArena::bytes_for(arena_size);
+    if (!segment.create(name, size))
+      return false;
+
+    header = new (segment.data()) ShmArenaHeader;
+    header->ring_capacity = ring_capacity;
+    header->arena_size = arena_size;
+    for (int i = 0; i < 2; ++i) {
+      header->readable[i].init();
+      header->writable[i].init();
+    }
+    header->freed.init();
+    if (segment.report().memfd) {
+      if (!Doorbell::make_eventfds(doorbells, 2)) {
+        cleanup();
+        return false;
+      }
+      tx_doorbell.adopt(doorbells[0]);
+      rx_doorbell.adopt(doorbells[1]);
+    }
+  } else {
+    if (!segment.open(name, doorbells, 2))
+      return false;
+    if (doorbells[0] != -1) {
+      tx_doorbell.adopt(doorbells[1]);
+      rx_doorbell.adopt(doorbells[0]);
+    }
+    if (segment.size() < sizeof(ShmArenaHeader)) {
+      fprintf(stderr, "shared memory arena segment is truncated\n");
+      cleanup();
+      return false;
+    }
+    header = static_cast<ShmArenaHeader *>(segment.data());
+    if (header->magic.load(std::memory_order_acquire) != SHM_ARENA_MAGIC) {
+      fprintf(stderr, "shared memory arena is not initialized\n");
+      cleanup();
+      return false;
+    }
+    ring_capacity = header->ring_capacity;
+    arena_size = header->arena_size;
+  }
+
+  return attach(name, create);
+}
+
+bool ipc::ShmArenaTransport::attach(const std::string &name, bool create) {
+  // The creator produces into the first ring, the opener into the second.
+  tx_index = create ? 0 : 1;
+  if (tx_doorbell.fd() == -1) {
+    tx_doorbell.bind(Doorbell::path_for(name, tx_index));
+    rx_doorbell.bind(Doorbell::path_for(name, 1 - tx_index));
+  }
+
+  const size_t ring_bytes = DescriptorRing::bytes_for(ring_capacity);
+  if (segment.size() < sizeof(ShmArenaHeader) + 2 * ring_bytes +
+                           ShmArena::bytes_for(arena_size)) {
+    fprintf(stderr, "shared memory arena segment is truncated\n");
+    cleanup();
+    return false;
+  }
+
+  char *base = reinterpret_cast<char *>(header + 1);
+  auto *forward = reinterpret_cast<DescriptorRing *>(base);
+  auto *backward = reinterpret_cast<DescriptorRing *>(base + ring_bytes);
+  arena = reinterpret_cast<ShmArena *>(base + 2 * ring_bytes);
+
+  if (create) {
+    new (forward) DescriptorRing;
+    new (backward) DescriptorRing;
+    new (arena) ShmArena;
+    forward->init(ring_capacity);
+    backward->init(ring_capacity);
+    arena->init(arena_size);
+    header->magic.store(SHM_ARENA_MAGIC, std::memory_order_release);
+    const int doorbells[2] = {tx_doorbell.fd(), rx_doorbell.fd()};
+    if (!segment.publish(doorbells, doorbells[0] != -1 ? 2 : 0)) {
+      cleanup();
+      return false;
+    }
+  }
+
+  tx_ring = create ? forward : backward;
+  rx_ring = create ? backward : forward;
+  return true;
+}
+
+void *ipc::ShmArenaTransport::allocate(size_t size,
+                                      std::chrono::nanoseconds timeout) {
+  if (!arena || size > max_payload_size())
+    return nullptr;
+  const uint64_t offset = allocate_until(size, Deadline(timeout));
+  return offset == ShmArena::NPOS ? nullptr : arena->at(offset);
+}
+
+uint64_t ipc::ShmArenaTransport::allocate_until(size_t size,
+                                                const Deadline &deadline) {
+  uint64_t offset = ShmArena::NPOS;
+  with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->freed,
+        [&] {
+          offset = arena->allocate(size);
+          return offset != ShmArena::NPOS;
+        },
+        deadline);
+  });
+  return offset;
+}
+
+bool ipc::ShmArenaTransport::send_buffer(void *buffer, size_t size) {
+  if (!tx_ring || !buffer)
+    return false;
+  return push_until({arena->offset_of(buffer), size}, Deadline::never());
+}
+
+bool ipc::ShmArenaTransport::push_until(const ArenaDescriptor &desc,
+                                        const Deadline &deadline) {
+  const bool pushed = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->writable[tx_index], [&] { return tx_ring->try_push(desc); },
+        deadline);
+  });
+  if (pushed) {
+    header->readable[tx_index].notify();
+    tx_doorbell.ring(header->readable[tx_index]);
+  }
+  return pushed;
+}
+
+bool ipc::ShmArenaTransport::pop_until(ArenaDescriptor &desc,
+                                       const Deadline &deadline) {
+  const int rx_index = 1 - tx_index;
+  bool popped = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->readable[rx_index], [&] { return rx_ring->try_pop(desc); },
+        deadline);
+  });
+  if (!popped && doorbell_in_use) {
+    // Anything pushed before the arm is found by this second pop.
+    rx_doorbell.arm(header->readable[rx_index]);
+    popped = rx_ring->try_pop(desc);
+  }
+  if (popped)
+    header->writable[rx_index].notify();
+  return popped;
+}
+
+bool ipc::ShmArenaTransport::send(const void *data, size_t size,
+                                 std::chrono::nanoseconds timeout) {
+  void *buffer = allocate(size, timeout);
+  if (!buffer)
+    return false;
+  std::memcpy(buffer, data, size);
+  return send_buffer(buffer, size);
+}
+
+const void *ipc::ShmArenaTransport::receive_buffer(size_t &size) {
+  if (!rx_ring)
+    return nullptr;
+
+  ArenaDescriptor desc{};
+  pop_until(desc, Deadline::never());
+
+  size = desc.size;
+  return arena->at(desc.offset);
+}
+
+void ipc::ShmArenaTransport::release_buffer(const void *buffer) {
+  if (!arena || !buffer)
+    return;
+  arena->deallocate(arena->offset_of(buffer));
+  header->freed.notify();
+}
+
+bool ipc::ShmArenaTransport::receive(std::vector<char> &out) {
+  size_t size = 0;
+  const void *buffer = receive_buffer(size);
+  if (!buffer)
+    return false;
+  out.assign(static_cast<const char *>(buffer),
+             static_cast<const char *>(buffer) + size);
+  release_buffer(buffer);
+  return true;
+}
+
+bool ipc::ShmArenaTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::ShmArenaTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::ShmArenaTransport::send_for(const IPCMessage &msg,
+                                 std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::ShmArenaTransport::receive_for(IPCMessage &msg,
+                                    std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::ShmArenaTransport::send_until(const IPCMessage &msg,
+                                                  const Deadline &deadline) {
+  if (!tx_ring || sizeof(msg) > max_payload_size())
+    return IPCStatus::Error;
+
+  const uint64_t offset = allocate_until(sizeof(msg), deadline);
+  if (offset == ShmArena::NPOS)
+    return IPCStatus::Timeout;
+  std::memcpy(arena->at(offset), &msg, sizeof(msg));
+
+  if (!push_until({offset, sizeof(msg)}, deadline)) {
+    arena->deallocate(offset);
+    header->freed.notify();
+    return IPCStatus::Timeout;
+  }
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::ShmArenaTransport::receive_until(IPCMessage &msg,
+                                                     const Deadline &deadline) {
+  if (!rx_ring)
+    return IPCStatus::Error;
+
+  ArenaDescriptor desc{};
+  if (!pop_until(desc, deadline))
+    return IPCStatus::Timeout;
+
+  const void *buffer = arena->at(desc.offset);
+  msg = IPCMessage{};
+  std::memcpy(&msg, buffer, desc.size < sizeof(msg) ? desc.size : sizeof(msg));
+  release_buffer(buffer);
+  return IPCStatus::Ok;
+}
+
+void ipc::ShmArenaTransport::set_segment_options(
+    const ShmSegmentOptions &options) {
+  segment.set_options(options);
+}
+
+const ipc::ShmSegmentReport &ipc::ShmArenaTransport::segment_report() const {
+  return segment.report();
+}
+
+size_t ipc::ShmArenaTransport::max_payload_size() const {
+  // The largest block is the biggest power of two that fits in the pool.
+  size_t block = size_t(1) << ShmArena::MIN_BLOCK_SHIFT;
+  while (block * 2 <= arena_size)
+    block *= 2;
+  return block < ShmArena::BLOCK_HEADER_SIZE
+             ? 0
+             : block - ShmArena::BLOCK_HEADER_SIZE;
+}
+
+int ipc::ShmArenaTransport::readiness_fd() {
+  if (!rx_ring)
+    return -1;
+  doorbell_in_use = true;
+  return rx_doorbell.listen();
+}
+
+void ipc::ShmArenaTransport::cleanup() {
+  header = nullptr;
+  tx_ring = nullptr;
+  rx_ring = nullptr;
+  arena = nullptr;
+  doorbell_in_use = false;
+  tx_doorbell.close();
+  rx_doorbell.close();
+  segment.close();
+}
@@ -0,0 +1,137 @@
+#ifndef IPC_MPMC_QUEUE_HPP
+#define IPC_MPMC_QUEUE_HPP
+
+#include <SPSCRing.hpp> // For CACHE_LINE_SIZE
+#include <atomic>       // For std::atomic positions and cell sequences
+#include <cstddef>      // For size_t
+#include <cstdint>      // For fixed-width integer types
+
+namespace ipc {
+
+/*!
+ * @brief A bounded multi-producer/multi-consumer queue placed in shared
+ * memory.
+ *
+ * This is Dmitry Vyukov's bounded MPMC queue. Every cell carries a sequence
+ * number that tells producers and consumers whether the cell is free for the
+ * current lap, so each side only contends on its own position counter with a
+ * single compare-and-swap and never takes a lock. The header is followed in
+ * memory by `capacity` cache-line aligned cells, so the whole queue occupies
+ * `bytes_for(capacity)` bytes.
+ *
+ * @tparam T A trivially copyable element type.
+ */
+template <typename T> struct MPMCQueue {
+  /*! @brief A queue cell padded to a whole number of cache lines. */
+  struct alignas(CACHE_LINE_SIZE) Cell {
+    /*!
+     * @brief Lap marker for the cell.
+     *
+     * Equal to the cell's position when it is free for a producer, and to
+     * position + 1 once it holds a value for a consumer.
+     */
+    std::atomic<uint64_t> sequence;
+
+    /*! @brief The stored element. */
+    T value;
+  };
+
+  /*! @brief Next position to be claimed by a producer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> enqueue_pos;
+
+  /*! @brief Next position to be claimed by a consumer. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dequeue_pos;
+
+  /*! @brief Number of cells. Always a power of two. */
+  alignas(CACHE_LINE_SIZE) uint64_t capacity;
+
+  /*! @brief `capacity - 1`, used to wrap positions. */
+  uint64_t mask;
+
+  /*!
+   * @brief Returns the number of bytes needed for a queue of `capacity`
+   * cells.
+   *
+   * @param capacity The number of cells. Must be a power of two.
+   */
+  static constexpr size_t bytes_for(size_t capacity) {
+    return sizeof(MPMCQueue) + capacity * sizeof(Cell);
+  }
+
+  /*!
+   * @brief Initializes a queue in freshly mapped memory.
+   *
+   * Must be called exactly once by the creator before any peer attaches.
+   *
+   * @param cells The number of cells. Must be a power of two.
+   */
+  void init(size_t cells) {
+    capacity = cells;
+    mask = cells - 1;
+    for (size_t i = 0; i < cells; ++i)
+      this->cells()[i].sequence.store(i, std::memory_order_relaxed);
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_release);
+  }
+
+  /*! @brief Returns the first cell, located directly after the header. */
+  Cell *cells() { return reinterpret_cast<Cell *>(this + 1); }
+
+  /*!
+   * @brief Copies `value` into the queue without blocking.
+   *
+   * @return True if the element was enqueued, false if the queue is full.
+   */
+  bool try_push(const T &value) {
+    uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells()[pos & mask];
+      const uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+      const int64_t diff = static_cast<int64_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    Cell &cell = cells()[pos & mask];
+    cell.value = value;
+    cell.sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * @brief Copies the oldest element out of the queue without blocking.
+   *
+   * @return True if an element was dequeued, false if the queue is empty.
+   */
+  bool try_pop(T &value) {
+    uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells()[pos & mask];
+      const uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+      const int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    Cell &cell = cells()[pos & mask];
+    value = cell.value;
+    cell.sequence.store(pos + capacity, std::memory_order_release);
+    return true;
+  }
+};
+
+} // namespace ipc
+
+#endif // IPC_MPMC_QUEUE_HPP
@@ -0,0 +1,181 @@
+#ifndef SHM_QUEUE_TRANSPORT_HPP
+#define SHM_QUEUE_TRANSPORT_HPP
+
+#include <DoorbellTable.hpp> // For the readers' readiness descriptors
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <MPMCQueue.hpp>     // For the lock-free queue placed in the segment
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For the wait policies
+#include <atomic>            // For std::atomic
+#include <cstdint>           // For fixed-width integer types
+
+namespace ipc {
+
+/*!
+ * @brief Header placed at the start of a shared memory queue segment.
+ *
+ * It is followed by a single MPMCQueue<IPCMessage>.
+ */
+struct ShmQueueHeader {
+  /*!
+   * @brief Set to `SHM_QUEUE_MAGIC` by the creator once the queue is fully
+   * initialized, so late openers never see a half-built queue.
+   */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Number of cells in the queue, written once by the creator. */
+  uint32_t capacity;
+
+  /*! @brief Notified after a message is enqueued. */
+  WaitPoint readable;
+
+  /*! @brief Notified after a message is dequeued. */
+  WaitPoint writable;
+
+  /*! @brief Doorbells of consumers that poll `readiness_fd()`. */
+  DoorbellTable doorbells;
+};
+
+/*! @brief Queue type placed after the ShmQueueHeader. */
+using MessageQueueMPMC = MPMCQueue<IPCMessage>;
+
+/*!
+ * @brief Implements the IIPCTransport interface as a multi-producer/
+ * multi-consumer queue in POSIX shared memory.
+ *
+ * Any number of processes can attach to the same queue by name. Every
+ * `send_message` enqueues into, and every `receive_message` dequeues from,
+ * the one shared queue, so this transport suits fan-in (many workers feeding
+ * an aggregator) and work distribution (many consumers draining one queue).
+ * Producers and consumers only contend on their respective position counter
+ * and never take a lock.
+ */
+class ShmQueueTransport : public IIPCTransport {
+public:
+  /*! @brief Default number of cells in the queue. */
+  static constexpr uint32_t DEFAULT_CAPACITY = 4096;
+
+  /*! @brief Value stored in ShmQueueHeader::magic once the queue is ready. */
+  static constexpr uint32_t SHM_QUEUE_MAGIC = 0x4d504d43; // "MPMC"
+
+  /*!
+   * @brief Constructs a new ShmQueueTransport object.
+   *
+   * @param capacity Number of cells, rounded up to a power of two. Only used
+   * by the creating process, whose `initialize()` fails above
+   * MAX_QUEUE_CAPACITY; openers use the creator's value.
+   * @param wait How this instance waits on a full or empty queue. Each
+   * attached process may pick its own strategy.
+   */
+  explicit ShmQueueTransport(uint32_t capacity = DEFAULT_CAPACITY,
+                             WaitStrategy wait = WaitStrategy::Yield);
+
+  /*!
+   * @brief Destroys the ShmQueueTransport object.
+   *
+   * Calls the cleanup method, which unmaps the segment and unlinks it if this
+   * instance created it.
+   */
+  ~ShmQueueTransport() override;
+
+  /*!
+   * @brief Creates or attaches to a named shared memory queue.
+   *
+   * Exactly one process should call initialize with `create = true`; every
+   * other producer or consumer attaches with `create = false`.
+   *
+   * @param name A unique name for the shared memory object.
+   * @param create True to create and initialize the queue, false to attach
+   * to an existing one.
+   * @return True if initialization is successful, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Enqueues a copy of `msg`, waiting while the queue is full.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if the message was enqueued, false if not initialized.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Dequeues the oldest message, waiting while the queue is empty.
+   *
+   * With several consumers, each message is delivered to exactly one of them.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message was dequeued, false if not initialized.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for room
+   * in the queue.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for one.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Returns this consumer's doorbell, claiming a slot in the queue's
+   * DoorbellTable on first use.
+   *
+   * Once this has been called, a receive that finds the queue empty arms
+   * the doorbell, and the next send rings every armed consumer. Another
+   * consumer may take the message first, in which case the retry finds the
+   * queue empty again.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Unmaps the queue and unlinks it if this instance created it.
+   */
+  void cleanup() override;
+
+private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Requested number of cells for a newly created queue. */
+  uint32_t capacity;
+
+  /*! @brief How this instance waits on a full or empty queue. */
+  WaitStrategy wait_strategy;
+
+  /*! @brief The segment header, or nullptr before initialize. */
+  ShmQueueHeader *header = nullptr;
+
+  /*! @brief The mapped shared memory segment. */
+  ShmSegment segment;
+
+  /*! @brief The queue inside `segment`, or nullptr before initialize. */
+  MessageQueueMPMC *queue = nullptr;
+
+  /*! @brief This instance's handle on the queue's doorbells. */
+  ReaderDoorbells doorbells;
+
+  /*! @brief True once `readiness_fd()` was called, so empty reads arm. */
+  bool doorbell_in_use = false;
+};
+} // namespace ipc
+
+#endif // SHM_QUEUE_TRANSPORT_HPP
@@ -0,0 +1,133 @@
+#include <ShmQueueTransport.hpp>
+#include <cstdio>
+#include <new>
+
+ipc::ShmQueueTransport::ShmQueueTransport(uint32_t capacity,
+                                          WaitStrategy wait)
+    : capacity(round_up_pow2(capacity)), wait_strategy(wait) {}
+
+ipc::ShmQueueTransport::~ShmQueueTransport() { cleanup(); }
+
+bool ipc::ShmQueueTransport::initialize(const std::string &name, bool create) {
+  if (create) {
+    if (capacity == 0) {
+      fprintf(stderr, "shared memory queue capacity is too large\n");
+      return false;
+    }
+    const size_t size =
+        sizeof(ShmQueueHeader) + MessageQueueMPMC::bytes_for(capacity);
+    if (!segment.create(name, size))
+      return false;
+
+    header = new (segment.data()) ShmQueueHeader;
+    header->capacity = capacity;
+    header->readable.init();
+    header->writable.init();
+    header->doorbells.init();
+    queue = new (header + 1) MessageQueueMPMC;
+    queue->init(capacity);
+    header->magic.store(SHM_QUEUE_MAGIC, std::memory_order_release);
+    doorbells.bind(&header->doorbells, name);
+    return true;
+  }
+
+  if (!segment.open(name))
+    return false;
+
+  if (segment.size() < sizeof(ShmQueueHeader)) {
+    fprintf(stderr, "shared memory queue segment is truncated\n");
+    cleanup();
+    return false;
+  }
+
+  header = static_cast<ShmQueueHeader *>(segment.data());
+  if (header->magic.load(std::memory_order_acquire) != SHM_QUEUE_MAGIC) {
+    fprintf(stderr, "shared memory queue is not initialized\n");
+    cleanup();
+    return false;
+  }
+
+  capacity = header->capacity;
+  if (segment.size() <
+      sizeof(ShmQueueHeader) + MessageQueueMPMC::bytes_for(capacity)) {
+    fprintf(stderr, "shared memory queue segment is truncated\n");
+    cleanup();
+    return false;
+  }
+
+  queue = reinterpret_cast<MessageQueueMPMC *>(header + 1);
+  doorbells.bind(&header->doorbells, name);
+  return true;
+}
+
+bool ipc::ShmQueueTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::ShmQueueTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::ShmQueueTransport::send_for(const IPCMessage &msg,
+                                 std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::ShmQueueTransport::receive_for(IPCMessage &msg,
+                                    std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::ShmQueueTransport::send_until(const IPCMessage &msg,
+                                                  const Deadline &deadline) {
+  if (!queue)
+    return IPCStatus::Error;
+
+  const bool sent = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->writable, [&] { return queue->try_push(msg); }, deadline);
+  });
+  if (!sent)
+    return IPCStatus::Timeout;
+  header->readable.notify();
+  doorbells.ring();
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::ShmQueueTransport::receive_until(IPCMessage &msg,
+                                                     const Deadline &deadline) {
+  if (!queue)
+    return IPCStatus::Error;
+
+  bool received = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(
+        header->readable, [&] { return queue->try_pop(msg); }, deadline);
+  });
+  if (!received && doorbell_in_use) {
+    // Anything pushed before the arm is found by this second pop.
+    doorbells.arm();
+    received = queue->try_pop(msg);
+  }
+  if (!received)
+    return IPCStatus::Timeout;
+  header->writable.notify();
+  return IPCStatus::Ok;
+}
+
+int ipc::ShmQueueTransport::readiness_fd() {
+  if (!queue)
+    return -1;
+  doorbell_in_use = true;
+  return doorbells.listen();
+}
+
+void ipc::ShmQueueTransport::cleanup() {
+  // Releases the doorbell slot, so before the segment is unmapped.
+  doorbells.close();
+  doorbell_in_use = false;
+  queue = nullptr;
+  header = nullptr;
+  segment.close();
+}
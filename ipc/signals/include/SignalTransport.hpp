@@ -1,7 +1,9 @@
 #ifndef SIGNAL_TRANSPORT_HPP
 #define SIGNAL_TRANSPORT_HPP
 
+#include <Deadline.hpp>      // For timed receive
 #include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <ShmSegment.hpp>    // For the named shared memory mapping
 #include <atomic>            // For std::atomic<bool>
 #include <cerrno>            // For errno
 #include <csignal> // For signal handling (sigaction, kill, sigemptyset, sigaddset, sigprocmask)
@@ -86,6 +88,39 @@ public:
    */
   bool receive_message(IPCMessage &msg) override;
 
+  /*!
+   * @brief Sends an IPCMessage, which never waits: the message is
+   * copied and the peer signalled.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for the
+   * peer's signal (`sigtimedwait`).
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Returns a signalfd that polls readable while SIGUSR1 is pending.
+   *
+   * Created on first use; it blocks SIGUSR1 in the calling thread so the
+   * signal stays pending until a receive call consumes it.
+   *
+   * @return The descriptor, or -1 if it could not be created.
+   */
+  int readiness_fd() override;
+
   /*!
    * @brief Cleans up resources associated with the signal and shared memory
    * transport.
@@ -107,16 +142,29 @@ public:
    */
   void setPeerPid(pid_t pid);
 
+  /*!
+   * @brief Selects huge page backing, prefaulting, locking or memfd mode for
+   * the shared memory segment.
+   *
+   * Must be called before `initialize()` to take effect. In memfd mode the
+   * creator's `initialize()` waits for the opener to connect.
+   */
+  void set_segment_options(const ShmSegmentOptions &options);
+
+  /*! @brief Reports which segment options took effect after initialize. */
+  const ShmSegmentReport &segment_report() const;
+
 private:
   /*! @brief The size of the shared memory segment, equal to the size of
    * IPCMessage. */
   static constexpr size_t SHM_SIZE = sizeof(IPCMessage);
 
-  /*! @brief The name of the POSIX shared memory object. */
-  std::string shm_name;
-
-  /*! @brief File descriptor for the shared memory object. Initialized to -1. */
-  int shm_fd = -1;
+  /*!
+   * @brief The mapped shared memory segment.
+   *
+   * The creating instance owns the object and unlinks it during cleanup.
+   */
+  ShmSegment segment;
 
   /*!
    * @brief Pointer to the mapped IPCMessage structure in shared memory.
@@ -132,6 +180,9 @@ private:
    */
   pid_t peer_pid = -1;
 
+  /*! @brief The signalfd returned by `readiness_fd()`, or -1. */
+  int signal_fd = -1;
+
   /*!
    * @brief An atomic flag indicating whether a signal has been received.
    *
@@ -151,14 +202,13 @@ private:
   static void signal_handler(int signum);
 
   /*!
-   * @brief Waits for the `signal_received` flag to be set.
+   * @brief Waits synchronously for SIGUSR1.
    *
-   * This private helper function blocks until the `signal_received` atomic flag
-   * becomes true, indicating that a signal has been caught by the
-   * `signal_handler`. It then resets the flag.
-   * @return True if a signal was successfully waited for and processed.
+   * @param timeout Relative timeout, or nullptr to wait indefinitely.
+   * @return IPCStatus::Ok once the signal arrived, IPCStatus::Timeout if the
+   * timeout passed first, IPCStatus::Error on failure.
    */
-  bool wait_for_signal();
+  IPCStatus wait_for_signal(const timespec *timeout);
 };
 } // namespace ipc
 
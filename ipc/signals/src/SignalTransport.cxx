@@ -2,6 +2,7 @@
 #include <cerrno>
 #include <csignal>
 #include <iostream>
+#include <sys/signalfd.h>
 
 std::atomic<bool> ipc::SignalTransport::signal_received{false};
 
@@ -10,32 +11,25 @@ ipc::SignalTransport::SignalTransport() = default;
 ipc::SignalTransport::~SignalTransport() { cleanup(); }
 
 bool ipc::SignalTransport::initialize(const std::string &name, bool create) {
-  shm_name = "/" + name;
-
   if (create) {
-    shm_fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0666);
-    if (shm_fd == -1) {
-      perror("shm_open");
+    if (!segment.create(name, SHM_SIZE))
       return false;
-    }
-    if (ftruncate(shm_fd, SHM_SIZE) == -1) {
-      perror("ftruncate");
+    // In memfd mode the opener only gets the segment from here.
+    if (!segment.publish()) {
+      cleanup();
       return false;
     }
   } else {
-    shm_fd = shm_open(shm_name.c_str(), O_RDWR, 0666);
-    if (shm_fd == -1) {
-      perror("shm_open");
+    if (!segment.open(name))
+      return false;
+    if (segment.size() < SHM_SIZE) {
+      std::cerr << "Shared memory segment is truncated\n";
+      cleanup();
       return false;
     }
   }
 
-  shared_msg = (IPCMessage *)mmap(nullptr, SHM_SIZE, PROT_READ | PROT_WRITE,
-                                  MAP_SHARED, shm_fd, 0);
-  if (shared_msg == MAP_FAILED) {
-    perror("mmap");
-    return false;
-  }
+  shared_msg = static_cast<IPCMessage *>(segment.data());
 
   struct sigaction sa {};
   sa.sa_handler = SignalTransport::signal_handler;
@@ -68,7 +62,7 @@ bool ipc::SignalTransport::send_message(const IPCMessage &msg) {
   return true;
 }
 
-bool ipc::SignalTransport::wait_for_signal() {
+ipc::IPCStatus ipc::SignalTransport::wait_for_signal(const timespec *timeout) {
   sigset_t waitset;
   sigemptyset(&waitset);
   sigaddset(&waitset, SIGUSR1);
@@ -77,14 +71,16 @@ bool ipc::SignalTransport::wait_for_signal() {
   int sig = 0;
   siginfo_t info;
   while (true) {
-    sig = sigwaitinfo(&waitset, &info);
+    sig = sigtimedwait(&waitset, &info, timeout);
     if (sig == SIGUSR1) {
-      return true;
+      return IPCStatus::Ok;
     } else if (sig == -1 && errno == EINTR) {
       continue; // interrupted, try again
+    } else if (sig == -1 && errno == EAGAIN) {
+      return IPCStatus::Timeout;
     } else {
-      perror("sigwaitinfo");
-      return false;
+      perror("sigtimedwait");
+      return IPCStatus::Error;
     }
   }
 }
@@ -93,25 +89,66 @@ bool ipc::SignalTransport::receive_message(IPCMessage &msg) {
   if (!shared_msg)
     return false;
 
-  if (!wait_for_signal())
+  if (wait_for_signal(nullptr) != IPCStatus::Ok)
     return false;
 
   std::memcpy(&msg, shared_msg, sizeof(IPCMessage));
   return true;
 }
 
-void ipc::SignalTransport::cleanup() {
-  if (shared_msg) {
-    munmap(shared_msg, SHM_SIZE);
-    shared_msg = nullptr;
+ipc::IPCStatus ipc::SignalTransport::send_for(const IPCMessage &msg,
+                                              std::chrono::nanoseconds) {
+  return send_message(msg) ? IPCStatus::Ok : IPCStatus::Error;
+}
+
+ipc::IPCStatus
+ipc::SignalTransport::receive_for(IPCMessage &msg,
+                                  std::chrono::nanoseconds timeout) {
+  if (!shared_msg)
+    return IPCStatus::Error;
+
+  const timespec relative = Deadline(timeout).remaining_timespec();
+  const IPCStatus status = wait_for_signal(&relative);
+  if (status == IPCStatus::Ok)
+    std::memcpy(&msg, shared_msg, sizeof(IPCMessage));
+  return status;
+}
+
+int ipc::SignalTransport::readiness_fd() {
+  if (signal_fd != -1 || !shared_msg)
+    return signal_fd;
+
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGUSR1);
+  if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+    perror("pthread_sigmask");
+    return -1;
   }
-  if (shm_fd != -1) {
-    close(shm_fd);
-    shm_fd = -1;
+  signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (signal_fd == -1)
+    perror("signalfd");
+  return signal_fd;
+}
+
+void ipc::SignalTransport::cleanup() {
+  if (signal_fd != -1) {
+    close(signal_fd);
+    signal_fd = -1;
   }
-  shm_unlink(shm_name.c_str());
+  shared_msg = nullptr;
+  segment.close();
 }
 
 void ipc::SignalTransport::signal_handler(int) { signal_received = true; }
 
 void ipc::SignalTransport::setPeerPid(pid_t pid) { peer_pid = pid; }
+
+void ipc::SignalTransport::set_segment_options(
+    const ShmSegmentOptions &options) {
+  segment.set_options(options);
+}
+
+const ipc::ShmSegmentReport &ipc::SignalTransport::segment_report() const {
+  return segment.report();
+}
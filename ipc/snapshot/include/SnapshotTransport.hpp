@@ -0,0 +1,193 @@
+#ifndef SNAPSHOT_TRANSPORT_HPP
+#define SNAPSHOT_TRANSPORT_HPP
+
+#include <AtomicWords.hpp>   // For race-free payload storage
+#include <DoorbellTable.hpp> // For the readers' readiness descriptors
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SPSCRing.hpp>      // For CACHE_LINE_SIZE
+#include <ShmSegment.hpp>    // For the named shared memory mapping
+#include <WaitStrategy.hpp>  // For the reader wait policies
+#include <atomic>            // For std::atomic
+#include <cstdint>           // For fixed-width integer types
+
+namespace ipc {
+
+/*!
+ * @brief Layout of a snapshot segment: one seqlock-protected value.
+ *
+ * `sequence` is odd while the writer is overwriting `value` and even
+ * otherwise; it advances by two per publication, so `sequence / 2` is the
+ * number of values published so far.
+ */
+struct SnapshotHeader {
+  /*! @brief Set to `SNAPSHOT_MAGIC` once the segment is initialized. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> magic;
+
+  /*! @brief Seqlock sequence guarding `value`. */
+  alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> sequence;
+
+  /*! @brief The latest published message. */
+  AtomicWords<IPCMessage> value;
+
+  /*! @brief Notified after each publication, for readers waiting on change. */
+  WaitPoint updated;
+
+  /*! @brief Doorbells of readers that poll `readiness_fd()`. */
+  DoorbellTable doorbells;
+};
+
+/*!
+ * @brief Implements the IIPCTransport interface as a "latest value" channel
+ * in POSIX shared memory.
+ *
+ * Meant for state where only the newest value matters. The creating process
+ * is the single writer: `send_message()` overwrites the value in place and
+ * never blocks. Any number of readers attach with `create = false`.
+ * `read_latest()` returns the current value in constant time, retrying only
+ * if it raced with a write, and `receive_message()` waits until a value newer
+ * than the last one this reader saw is published. Intermediate values a
+ * reader did not get to see are skipped, not queued.
+ */
+class SnapshotTransport : public IIPCTransport {
+public:
+  /*! @brief Value stored in SnapshotHeader::magic once ready. */
+  static constexpr uint32_t SNAPSHOT_MAGIC = 0x534e4150; // "SNAP"
+
+  /*!
+   * @brief Constructs a new SnapshotTransport object.
+   *
+   * @param wait How `receive_message()` waits for a newer value. CondVar
+   * is replaced by Futex: waking condvar sleepers takes a process-shared
+   * mutex, so a stalled or crashed reader holding it would block the
+   * writer.
+   */
+  explicit SnapshotTransport(WaitStrategy wait = WaitStrategy::Futex);
+
+  /*!
+   * @brief Destroys the SnapshotTransport object.
+   *
+   * Calls the cleanup method, which unmaps the segment and unlinks it if this
+   * instance is the writer.
+   */
+  ~SnapshotTransport() override;
+
+  /*!
+   * @brief Creates the channel as its writer or attaches as a reader.
+   *
+   * @param name A unique name for the shared memory object.
+   * @param create True for the single writer, false for readers.
+   * @return True if initialization is successful, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Replaces the published value with `msg`. Never blocks.
+   *
+   * @param msg A constant reference to the IPCMessage to be published.
+   * @return True if published, false if this instance is not the writer.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Waits for a value newer than the last one this reader saw and
+   * copies it into `msg`.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a value was received, false if this instance is not a
+   * reader.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends an IPCMessage, which never waits.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for a value
+   * newer than the last one this reader saw.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Copies the current value into `msg` without waiting for a change.
+   *
+   * @param msg A reference to an IPCMessage object where the value will be
+   * stored.
+   * @return True if a value has been published, false if none has yet or the
+   * transport is not initialized.
+   */
+  bool read_latest(IPCMessage &msg);
+
+  /*!
+   * @brief Returns the number of values published when this instance last
+   * wrote or read one.
+   */
+  uint64_t version() const;
+
+  /*!
+   * @brief Returns this reader's doorbell, claiming a slot in the channel's
+   * DoorbellTable on first use, or -1 for the writer.
+   *
+   * Once this has been called, a receive that finds nothing new arms the
+   * doorbell, and the writer rings every armed reader when it publishes.
+   * The writer still never waits: it only writes to FIFOs that are open
+   * non-blocking.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Unmaps the segment and unlinks it if this instance is the writer.
+   */
+  void cleanup() override;
+
+private:
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Attempts one consistent read of the value.
+   *
+   * @param msg Receives the value on success.
+   * @param sequence Receives the even sequence the value was published under.
+   * @return True if a consistent copy was taken, false if a write was in
+   * progress or raced with the copy.
+   */
+  bool try_read(IPCMessage &msg, uint64_t &sequence) const;
+
+  /*! @brief How this reader waits for a newer value. */
+  WaitStrategy wait_strategy;
+
+  /*! @brief True if this instance is the writer. */
+  bool is_writer = false;
+
+  /*! @brief The mapped shared memory segment. */
+  ShmSegment segment;
+
+  /*! @brief The segment header, or nullptr before initialize. */
+  SnapshotHeader *header = nullptr;
+
+  /*! @brief Sequence of the value last written or read by this instance. */
+  uint64_t last_sequence = 0;
+
+  /*! @brief This instance's handle on the channel's doorbells. */
+  ReaderDoorbells doorbells;
+
+  /*! @brief True once `readiness_fd()` was called, so empty reads arm. */
+  bool doorbell_in_use = false;
+};
+} // namespace ipc
+
+#endif // SNAPSHOT_TRANSPORT_HPP
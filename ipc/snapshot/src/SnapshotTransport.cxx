@@ -0,0 +1,143 @@
+#include <Backoff.hpp>
+#include <SnapshotTransport.hpp>
+#include <cstdio>
+#include <new>
+
+ipc::SnapshotTransport::SnapshotTransport(WaitStrategy wait)
+    : wait_strategy(wait == WaitStrategy::CondVar ? WaitStrategy::Futex
+                                                  : wait) {}
+
+ipc::SnapshotTransport::~SnapshotTransport() { cleanup(); }
+
+bool ipc::SnapshotTransport::initialize(const std::string &name, bool create) {
+  is_writer = create;
+  last_sequence = 0;
+
+  if (create) {
+    if (!segment.create(name, sizeof(SnapshotHeader)))
+      return false;
+
+    header = new (segment.data()) SnapshotHeader;
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->value.store(IPCMessage{});
+    header->updated.init();
+    header->doorbells.init();
+    header->magic.store(SNAPSHOT_MAGIC, std::memory_order_release);
+    doorbells.bind(&header->doorbells, name);
+    return true;
+  }
+
+  if (!segment.open(name))
+    return false;
+
+  header = static_cast<SnapshotHeader *>(segment.data());
+  if (segment.size() < sizeof(SnapshotHeader) ||
+      header->magic.load(std::memory_order_acquire) != SNAPSHOT_MAGIC) {
+    fprintf(stderr, "snapshot segment is not initialized\n");
+    cleanup();
+    return false;
+  }
+  doorbells.bind(&header->doorbells, name);
+  return true;
+}
+
+bool ipc::SnapshotTransport::send_message(const IPCMessage &msg) {
+  if (!is_writer || !header)
+    return false;
+
+  // Seqlock write: make the sequence odd, store the value, make it even.
+  header->sequence.store(last_sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->value.store(msg);
+  last_sequence += 2;
+  header->sequence.store(last_sequence, std::memory_order_release);
+
+  header->updated.notify();
+  doorbells.ring();
+  return true;
+}
+
+bool ipc::SnapshotTransport::try_read(IPCMessage &msg,
+                                      uint64_t &sequence) const {
+  const uint64_t before = header->sequence.load(std::memory_order_acquire);
+  if (before & 1)
+    return false;
+
+  header->value.load(msg);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (header->sequence.load(std::memory_order_relaxed) != before)
+    return false;
+
+  sequence = before;
+  return true;
+}
+
+bool ipc::SnapshotTransport::read_latest(IPCMessage &msg) {
+  if (!header)
+    return false;
+
+  uint64_t sequence = 0;
+  Backoff backoff;
+  while (!try_read(msg, sequence))
+    backoff.pause();
+
+  last_sequence = sequence;
+  return sequence != 0;
+}
+
+bool ipc::SnapshotTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::SnapshotTransport::send_for(const IPCMessage &msg,
+                                 std::chrono::nanoseconds) {
+  return send_message(msg) ? IPCStatus::Ok : IPCStatus::Error;
+}
+
+ipc::IPCStatus
+ipc::SnapshotTransport::receive_for(IPCMessage &msg,
+                                    std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::SnapshotTransport::receive_until(IPCMessage &msg,
+                                                     const Deadline &deadline) {
+  if (is_writer || !header)
+    return IPCStatus::Error;
+
+  auto newer = [&] {
+    uint64_t sequence = 0;
+    if (header->sequence.load(std::memory_order_acquire) <= last_sequence ||
+        !try_read(msg, sequence))
+      return false;
+    last_sequence = sequence;
+    return true;
+  };
+  bool received = with_wait_strategy(wait_strategy, [&](auto policy) {
+    return decltype(policy)::wait_until(header->updated, newer, deadline);
+  });
+  if (!received && doorbell_in_use) {
+    // A value published before the arm is found by this second read.
+    doorbells.arm();
+    received = newer();
+  }
+  return received ? IPCStatus::Ok : IPCStatus::Timeout;
+}
+
+uint64_t ipc::SnapshotTransport::version() const { return last_sequence / 2; }
+
+int ipc::SnapshotTransport::readiness_fd() {
+  if (is_writer || !header)
+    return -1;
+  doorbell_in_use = true;
+  return doorbells.listen();
+}
+
+void ipc::SnapshotTransport::cleanup() {
+  // Releases the doorbell slot, so before the segment is unmapped.
+  doorbells.close();
+  doorbell_in_use = false;
+  header = nullptr;
+  segment.close();
+}
@@ -0,0 +1,279 @@
+#ifndef TCP_SERVER_TRANSPORT_HPP
+#define TCP_SERVER_TRANSPORT_HPP
+
+#include <Deadline.hpp>      // For timed send and receive
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <chrono>            // For the broadcast timeout
+#include <cstdint>           // For uint64_t
+#include <deque>             // For the queue of readable clients
+#include <memory>            // For std::unique_ptr
+#include <string>            // For std::string
+#include <unordered_map>     // For clients by ID
+
+namespace ipc {
+
+/*!
+ * @brief Implements the server side of TCP transport for many clients.
+ *
+ * TCPSocketTransport serves exactly one peer. This transport listens,
+ * accepts any number of TCPSocketTransport clients, and watches all of their
+ * connections with one epoll instance. `receive_message()` returns the next
+ * message from any client. Clients with pending data take turns, one message
+ * each, so one busy producer cannot starve the others. `send_message()`
+ * replies to the client that sent the last received message; `send_to()`
+ * addresses any client and `broadcast()` all of them.
+ *
+ * To spread the load over threads, construct one instance per thread with
+ * `reuse_port` set and initialize all of them with the same address. The
+ * kernel then balances new connections across the listeners (SO_REUSEPORT),
+ * and each instance serves its own clients independently.
+ *
+ * Clients that disconnect or fail are dropped. Connections are
+ * non-blocking, and each send waits for its client's socket buffer only as
+ * long as it is told to. `broadcast()` gives every client the broadcast
+ * timeout and drops those that cannot take the message in time, so one
+ * stalled client delays a broadcast at most once. When a send times out
+ * partway through a frame, the rest of the frame is kept and written ahead
+ * of the next send to that client, or while receiving once the socket has
+ * room.
+ */
+class TCPServerTransport : public IIPCTransport {
+public:
+  /*! @brief Identifies a connected client. IDs are never reused. */
+  using ClientId = uint64_t;
+
+  /*! @brief The ClientId that never refers to a client. */
+  static constexpr ClientId NO_CLIENT = 0;
+
+  /*! @brief Most epoll events handled per wait. */
+  static constexpr int MAX_EVENTS = 64;
+
+  /*! @brief Default time each client gets to accept a broadcast. */
+  static constexpr std::chrono::milliseconds DEFAULT_BROADCAST_TIMEOUT{1000};
+
+  /*!
+   * @brief Constructs a new TCPServerTransport object.
+   *
+   * @param reuse_port If true, the listener sets SO_REUSEPORT so that other
+   * instances can listen on the same address as shards.
+   */
+  explicit TCPServerTransport(bool reuse_port = false)
+      : reuse_port(reuse_port) {}
+
+  /*!
+   * @brief Destroys the TCPServerTransport object, closing every connection.
+   */
+  ~TCPServerTransport() override;
+
+  /*!
+   * @brief Starts listening on `name`.
+   *
+   * Returns as soon as the socket listens; clients are accepted while
+   * receiving.
+   *
+   * @param name The address to listen on, as "ip:port". Port 0 picks a free
+   * port; see get_port().
+   * @param create Must be true: this transport only serves. Clients use
+   * TCPSocketTransport.
+   * @return True if the server is listening, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends `msg` to the client that sent the last received message.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if sent, false if there is no such client or it failed.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next message from any client, accepting new
+   * connections while waiting.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored. The sender is then available from last_sender().
+   * @return True if a message was received, false on failure.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends `msg` to the last sender, waiting at most `timeout` for its
+   * socket to accept it.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives the next message from any client, waiting at most
+   * `timeout`.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends `msg` to one client, waiting as long as it takes.
+   *
+   * A client whose connection fails is dropped.
+   *
+   * @param client The client, e.g. from last_sender().
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return IPCStatus::Ok, or IPCStatus::Error if the client is unknown or
+   * the send failed.
+   */
+  IPCStatus send_to(ClientId client, const IPCMessage &msg);
+
+  /*!
+   * @brief Sends `msg` to one client, waiting at most `timeout` for its
+   * socket to accept it.
+   *
+   * @param client The client, e.g. from last_sender().
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout if the message was not sent,
+   * or IPCStatus::Error if the client is unknown or failed.
+   */
+  IPCStatus send_to(ClientId client, const IPCMessage &msg,
+                    std::chrono::nanoseconds timeout);
+
+  /*!
+   * @brief Sends `msg` to every connected client, dropping those that do not
+   * accept it within the broadcast timeout.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return The number of clients the message was sent to.
+   */
+  size_t broadcast(const IPCMessage &msg);
+
+  /*!
+   * @brief Sets how long each client gets to accept a broadcast before it is
+   * dropped. Defaults to DEFAULT_BROADCAST_TIMEOUT.
+   */
+  void set_broadcast_timeout(std::chrono::nanoseconds timeout);
+
+  /*! @brief Returns the sender of the last received message, or NO_CLIENT. */
+  ClientId last_sender() const;
+
+  /*! @brief Returns the number of connected clients. */
+  size_t client_count() const;
+
+  /*! @brief Returns the port listened on, or 0 before initialization. */
+  int get_port() const;
+
+  /*!
+   * @brief Returns the epoll descriptor, which polls readable when a client
+   * connects or sends data, or -1 before initialization.
+   *
+   * Drain with try_receive() before polling: frames already read from a
+   * connection do not make it readable.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Closes every connection and the listening socket.
+   */
+  void cleanup() override;
+
+private:
+  /*! @brief A connected client. */
+  struct Client {
+    /*! @brief The connection. */
+    int fd = -1;
+
+    /*! @brief True while the client is in `ready`. */
+    bool queued = false;
+
+    /*! @brief Reassembles frames from the connection. */
+    FrameReader reader;
+
+    /*!
+     * @brief Rest of a frame the socket did not take in time, written
+     * before anything else. The connection is watched for room meanwhile.
+     */
+    std::string unsent;
+  };
+
+  /*! @brief Receives from any client, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Sends to `client`, giving up at `deadline`. */
+  IPCStatus send_until(ClientId client, const IPCMessage &msg,
+                       const Deadline &deadline);
+
+  /*!
+   * @brief Writes `length` bytes to `client`, giving up at `deadline`.
+   *
+   * @param written Receives the number of bytes written.
+   * @return IPCStatus::Ok once all are written, IPCStatus::Timeout, or
+   * IPCStatus::Error if the connection failed.
+   */
+  static IPCStatus write_until(const Client &client, const char *data,
+                               size_t length, const Deadline &deadline,
+                               size_t &written);
+
+  /*!
+   * @brief Writes what it can of the unsent frame tail of `id` by
+   * `deadline`, and stops watching for room once all is written.
+   *
+   * @return As for write_until(); on IPCStatus::Error the client is dropped.
+   */
+  IPCStatus flush_unsent(ClientId id, Client &client,
+                         const Deadline &deadline);
+
+  /*! @brief Adds or removes EPOLLOUT from the events watched for `id`. */
+  void watch_room(ClientId id, const Client &client, bool watch);
+
+  /*!
+   * @brief Waits up to `timeout_ms` for epoll events, then accepts pending
+   * connections and queues readable clients.
+   *
+   * @return False if waiting failed.
+   */
+  bool poll_events(int timeout_ms);
+
+  /*! @brief Accepts every pending connection. */
+  void accept_clients();
+
+  /*! @brief Closes the connection of `client` and forgets it. */
+  void drop(ClientId client);
+
+  /*! @brief Whether other listeners may share the port. */
+  bool reuse_port;
+
+  /*! @brief Time each client gets to accept a broadcast. */
+  std::chrono::nanoseconds broadcast_timeout = DEFAULT_BROADCAST_TIMEOUT;
+
+  /*! @brief The listening socket, or -1. */
+  int listen_fd = -1;
+
+  /*! @brief Watches the listener and every connection, or -1. */
+  int epoll_fd = -1;
+
+  /*! @brief The port listened on. */
+  int port = 0;
+
+  /*! @brief Connected clients by ID. */
+  std::unordered_map<ClientId, std::unique_ptr<Client>> clients;
+
+  /*! @brief Clients that may have a message to read, in turn order. */
+  std::deque<ClientId> ready;
+
+  /*! @brief The ID given to the next accepted client. */
+  ClientId next_id = NO_CLIENT + 1;
+
+  /*! @brief The sender of the last received message. */
+  ClientId last_client = NO_CLIENT;
+};
+} // namespace ipc
+
+#endif // TCP_SERVER_TRANSPORT_HPP
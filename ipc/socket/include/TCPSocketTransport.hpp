@@ -1,20 +1,45 @@
 #ifndef TCP_SOCKET_TRANSPORT_HPP
 #define TCP_SOCKET_TRANSPORT_HPP
 
+#include <Deadline.hpp>      // For timed send and receive
 #include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <SendCoalescer.hpp>  // For coalesced sends
+#include <UringStream.hpp>   // For the io_uring backend
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <memory>            // For std::unique_ptr
 #include <netinet/in.h>      // For sockaddr_in, AF_INET, SOCK_STREAM, etc.
 #include <string>            // For std::string
+#include <sys/types.h>       // For off_t
 #include <unistd.h>          // For close()
+#include <vector>            // For received payloads
 
 namespace ipc {
 
+/*!
+ * @brief Counters for the zero-copy payload path of TCPSocketTransport.
+ */
+struct ZeroCopyStats {
+  /*! @brief Successful MSG_ZEROCOPY send calls. */
+  uint64_t sends = 0;
+
+  /*! @brief Sends whose completion was read from the error queue. */
+  uint64_t completed = 0;
+
+  /*!
+   * @brief Completed sends for which the kernel copied the data after all,
+   * e.g. over loopback, where zero-copy brings no benefit.
+   */
+  uint64_t copied = 0;
+};
+
 /*!
  * @brief Implements the IIPCTransport interface using TCP sockets.
  *
  * This class provides a concrete implementation for inter-process communication
  * (or inter-machine communication) using TCP/IP sockets. It can operate in
  * either a server mode (listening for connections) or a client mode (connecting
- * to a server).
+ * to a server). Messages travel as compact length-prefixed frames (see
+ * WireFormat.hpp).
  */
 class TCPSocketTransport : public IIPCTransport {
 public:
@@ -23,8 +48,29 @@ public:
    *
    * Initializes internal state variables to default values. Socket creation
    * and connection/listening occur during the `initialize` call.
+   *
+   * @param backend How the connection is read and written. With
+   * IOBackend::IoUring it is driven through a UringStream. Each peer may
+   * choose its own.
    */
-  TCPSocketTransport() = default;
+  explicit TCPSocketTransport(IOBackend backend = IOBackend::Syscalls)
+      : backend(backend),
+        coalescer([this](const IPCMessage *msgs, size_t count) {
+          return write_batch(msgs, count);
+        }) {}
+
+  /*!
+   * @brief How long a client keeps retrying while the server is not
+   * listening yet, in milliseconds.
+   */
+  static constexpr int CONNECT_TIMEOUT_MS = 5000;
+
+  /*! @brief Default payload size from which send() avoids copying. */
+  static constexpr size_t DEFAULT_ZEROCOPY_THRESHOLD = 64 * 1024;
+
+  /*! @brief Largest payload receive() accepts, guarding against corrupt
+   * size fields. */
+  static constexpr uint64_t MAX_PAYLOAD_SIZE = uint64_t{1} << 32;
 
   /*!
    * @brief Destroys the TCPSocketTransport object.
@@ -57,7 +103,7 @@ public:
   /*!
    * @brief Sends an IPCMessage through the TCP socket.
    *
-   * This method serializes the `IPCMessage` and sends its raw bytes over the
+   * This method encodes the `IPCMessage` as one frame and sends it over the
    * established TCP connection. It ensures all bytes are sent.
    *
    * @param msg A constant reference to the IPCMessage to be sent.
@@ -68,9 +114,9 @@ public:
   /*!
    * @brief Receives an IPCMessage from the TCP socket.
    *
-   * This method reads the raw bytes of an `IPCMessage` from the TCP connection
-   * and deserializes them into the provided `IPCMessage` structure. It ensures
-   * all expected bytes are received.
+   * This method decodes the next frame from the TCP connection into the
+   * provided `IPCMessage` structure, reading ahead into a buffer when more
+   * data is available.
    *
    * @param msg A reference to an IPCMessage object where the received data will
    * be stored.
@@ -78,6 +124,151 @@ public:
    */
   bool receive_message(IPCMessage &msg) override;
 
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for the
+   * socket to accept it.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for a
+   * complete frame. A partially received frame stays buffered for the next
+   * call.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with one `writev()` per FrameBatch.
+   *
+   * Frame headers and payloads are gathered straight from `msgs`.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Sets how small sends are coalesced.
+   *
+   * With an enabled policy, `send_message()` queues the message and the
+   * queue is written in one batch once it holds `max_bytes` of frames or its
+   * oldest message has waited `max_delay`, whichever comes first. Receiving
+   * and `send_batch()` flush the queue first. The timed sends only apply their
+   * timeout to unbuffered writes.
+   *
+   * @param policy The new policy; pending messages are flushed first.
+   * @return False if flushing the pending messages failed.
+   */
+  bool set_coalescing(const CoalescingPolicy &policy);
+
+  /*!
+   * @brief Sends a byte payload of any size as one payload frame.
+   *
+   * Payloads of at least the zero-copy threshold are sent with
+   * MSG_ZEROCOPY: the kernel transmits straight from `data` instead of
+   * copying it, and reports on the socket error queue when it is done with
+   * the pages. The call returns once every completion has been read, so
+   * `data` may be reused or freed afterwards. Smaller payloads, and all
+   * payloads where zero-copy is unavailable, are copied as usual.
+   *
+   * Not available with IOBackend::IoUring. Pending coalesced messages are
+   * flushed first.
+   *
+   * @param data The payload.
+   * @param size The payload size in bytes.
+   * @return True if the payload was sent, false otherwise.
+   */
+  bool send(const void *data, size_t size);
+
+  /*!
+   * @brief Sends `size` bytes of a file as one payload frame using
+   * `sendfile()`, so the data goes from the page cache to the socket
+   * without passing through user space.
+   *
+   * @param file_fd A file descriptor that supports mmap-like reads, e.g. a
+   * regular file.
+   * @param offset Where in the file the payload starts.
+   * @param size The payload size in bytes.
+   * @return True if the payload was sent, false otherwise (including a file
+   * shorter than `offset + size`).
+   */
+  bool send_file(int file_fd, off_t offset, size_t size);
+
+  /*!
+   * @brief Waits for the next payload frame and copies it into `out`.
+   *
+   * The frame must have been sent with send() or send_file(); a message
+   * frame in its place is an error.
+   *
+   * @return True if a payload was received, false otherwise.
+   */
+  bool receive(std::vector<char> &out);
+
+  /*!
+   * @brief Sets the payload size from which send() uses MSG_ZEROCOPY.
+   * SIZE_MAX disables zero-copy.
+   */
+  void set_zerocopy_threshold(size_t bytes);
+
+  /*! @brief Returns the counters of the zero-copy path. */
+  const ZeroCopyStats &zerocopy_stats() const;
+
+  /*!
+   * @brief Sets TCP_NODELAY, which sends small segments at once instead of
+   * waiting for outstanding data to be acknowledged (Nagle's algorithm).
+   * Enabling coalescing sets it, since coalescing takes Nagle's place.
+   *
+   * @return False if not connected or the option could not be set.
+   */
+  bool set_no_delay(bool enable);
+
+  /*!
+   * @brief Sets TCP_CORK, which holds back partial segments until the cork
+   * is removed (or for at most 200 ms).
+   *
+   * @return False if not connected or the option could not be set.
+   */
+  bool set_cork(bool enable);
+
+  /*!
+   * @brief Writes the messages held back by coalescing in one batch.
+   *
+   * @return True if nothing is left pending, false on failure.
+   */
+  bool flush() override;
+
+  /*!
+   * @brief Receives up to `max` messages.
+   *
+   * Waits for the first message, then decodes what is already buffered and
+   * whatever one more read can fetch without blocking.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*!
+   * @brief Returns the connected socket, or -1 before a connection exists.
+   *
+   * Frames already buffered by receive_batch() do not make it readable;
+   * drain with try_receive() before polling.
+   */
+  int readiness_fd() override;
+
   /*!
    * @brief Cleans up resources associated with the TCP socket transport.
    *
@@ -87,6 +278,41 @@ public:
   void cleanup() override;
 
 private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Writes `msgs` without coalescing; returns how many were sent. */
+  size_t write_batch(const IPCMessage *msgs, size_t count);
+
+  /*! @brief Sets the IPPROTO_TCP level `option` on the connection. */
+  bool set_tcp_option(int option, bool enable);
+
+  /*!
+   * @brief Sends `size` bytes with MSG_ZEROCOPY and waits for their
+   * completions, copying instead where zero-copy is unavailable.
+   */
+  bool send_zerocopy(int fd, const char *data, size_t size);
+
+  /*!
+   * @brief Reads zero-copy completions from the error queue.
+   *
+   * @param wait If true, waits until every send has completed.
+   * @return False if reading the error queue failed.
+   */
+  bool reap_zerocopy(int fd, bool wait);
+
+  /*! @brief Payload size from which send() uses MSG_ZEROCOPY. */
+  size_t zerocopy_threshold = DEFAULT_ZEROCOPY_THRESHOLD;
+
+  /*! @brief Whether SO_ZEROCOPY was enabled on the connection. */
+  bool zerocopy_enabled = false;
+
+  /*! @brief Counters of the zero-copy path. */
+  ZeroCopyStats stats;
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
   /*! @brief The main socket file descriptor (listening socket for server,
    * connecting socket for client). */
   int socket_fd = -1;
@@ -102,6 +328,18 @@ private:
   /*! @brief A flag indicating if this instance is operating as a server. */
   bool is_server = false;
 
+  /*! @brief Reassembles frames from the connection. */
+  FrameReader reader;
+
+  /*! @brief The I/O backend chosen at construction. */
+  IOBackend backend;
+
+  /*! @brief The io_uring engine, or null with IOBackend::Syscalls. */
+  std::unique_ptr<UringStream> stream;
+
+  /*! @brief Messages held back by the coalescing policy. */
+  SendCoalescer coalescer;
+
   /*!
    * @brief Helper function to ensure all bytes from a buffer are sent over a
    * socket.
@@ -112,26 +350,11 @@ private:
    * @param fd The socket file descriptor to send data through.
    * @param buffer A pointer to the character array containing the data to send.
    * @param length The total number of bytes to send.
+   * @param flags Flags for `send()`, e.g. MSG_MORE.
    * @return True if all bytes were sent successfully, false otherwise (e.g.,
    * connection closed).
    */
-  bool send_all(int fd, const char *buffer, size_t length);
-
-  /*!
-   * @brief Helper function to ensure all expected bytes are received from a
-   * socket.
-   *
-   * This function repeatedly calls `recv()` until the entire `length` of data
-   * has been received into the `buffer`, handling partial receives.
-   *
-   * @param fd The socket file descriptor to receive data from.
-   * @param buffer A pointer to the character array where received data will be
-   * stored.
-   * @param length The total number of bytes expected to receive.
-   * @return True if all bytes were received successfully, false otherwise
-   * (e.g., connection closed).
-   */
-  bool recv_all(int fd, char *buffer, size_t length);
+  bool send_all(int fd, const char *buffer, size_t length, int flags = 0);
 };
 } // namespace ipc
 
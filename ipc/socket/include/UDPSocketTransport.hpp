@@ -0,0 +1,195 @@
+#ifndef UDP_SOCKET_TRANSPORT_HPP
+#define UDP_SOCKET_TRANSPORT_HPP
+
+#include <Deadline.hpp>      // For timed send and receive
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <cstdint>           // For uint64_t
+#include <netinet/in.h>      // For sockaddr_in
+#include <string>            // For std::string
+#include <unordered_map>     // For sequence tracking per sender
+
+namespace ipc {
+
+/*!
+ * @brief Implements the IIPCTransport interface as a one-way UDP datagram
+ * channel, unicast or multicast.
+ *
+ * Meant for loss-tolerant fan-out such as telemetry: nothing is
+ * retransmitted, and a slow reader loses messages instead of slowing the
+ * writer. The creating process is the writer and sends to the address it
+ * was initialized with. Readers attach with `create = false` and bind the
+ * port; if the address is a multicast group they join it, so any number of
+ * readers can follow one writer.
+ *
+ * Every message travels in its own datagram: the writer's 64-bit sequence
+ * number (8 little-endian bytes) followed by the message frame. Readers
+ * track the sequence of each writer they hear from, count the messages
+ * that never arrived in `dropped()` and late or duplicate ones in
+ * `reordered()`, and still deliver the latter.
+ */
+class UDPSocketTransport : public IIPCTransport {
+public:
+  /*! @brief Bytes in front of the frame in each datagram. */
+  static constexpr size_t SEQUENCE_SIZE = 8;
+
+  /*! @brief Largest datagram the transport sends. */
+  static constexpr size_t MAX_DATAGRAM_SIZE = SEQUENCE_SIZE + MAX_FRAME_SIZE;
+
+  /*! @brief Most datagrams passed to one `sendmmsg()` or `recvmmsg()`. */
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /*! @brief Receive buffer size readers ask for, to ride out bursts. */
+  static constexpr int RECEIVE_BUFFER_SIZE = 4 << 20;
+
+  /*! @brief Constructs a new UDPSocketTransport object. */
+  UDPSocketTransport() = default;
+
+  /*! @brief Destroys the UDPSocketTransport object, closing its socket. */
+  ~UDPSocketTransport() override;
+
+  /*!
+   * @brief Initializes the writer or a reader.
+   *
+   * @param name The destination as "ip:port": a unicast address the reader
+   * binds, or a multicast group (224.0.0.0/4) the readers join.
+   * @param create True for the writer, false for a reader.
+   * @return True if the socket is ready, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends `msg` as one datagram. Only the writer can send.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if the datagram was handed to the kernel, which does not
+   * mean it will arrive.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next message. Only readers can receive.
+   *
+   * Datagrams that are not well-formed are skipped.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message was received, false on failure.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends `msg`, waiting at most `timeout` for socket buffer space.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives the next message, waiting at most `timeout`.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with one `sendmmsg()` per BATCH_SIZE
+   * datagrams.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Receives up to `max` messages, waiting for the first one and
+   * collecting the datagrams already queued with `recvmmsg()`.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*! @brief Returns the socket, or -1 before initialization. */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Selects the local interface multicast traffic is sent from and
+   * received on, by its IPv4 address, e.g. "127.0.0.1" to stay on the
+   * loopback device. The default lets the routing table decide.
+   *
+   * Must be called before `initialize()` to take effect.
+   *
+   * @return False if `ip` is not an IPv4 address.
+   */
+  bool set_multicast_interface(const std::string &ip);
+
+  /*!
+   * @brief Returns how many messages the reader missed, judging by gaps in
+   * the writers' sequence numbers.
+   */
+  uint64_t dropped() const;
+
+  /*! @brief Returns how many messages arrived late or twice. */
+  uint64_t reordered() const;
+
+  /*! @brief Closes the socket, leaving any multicast group. */
+  void cleanup() override;
+
+private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Encodes `msg` with `sequence` into `out`.
+   *
+   * Callers advance `next_sequence` only for datagrams the kernel took, so
+   * a failed send does not show up as a gap at the reader.
+   */
+  static size_t encode_datagram(const IPCMessage &msg, uint64_t sequence,
+                                char *out);
+
+  /*!
+   * @brief Decodes a received datagram and updates the gap counters.
+   *
+   * @return False if the datagram is not well-formed.
+   */
+  bool accept_datagram(const char *datagram, size_t size,
+                       const sockaddr_in &from, IPCMessage &msg);
+
+  /*! @brief The socket, or -1. */
+  int socket_fd = -1;
+
+  /*! @brief True for the writer. */
+  bool is_writer = false;
+
+  /*! @brief Local interface for multicast, or INADDR_ANY. */
+  in_addr multicast_interface{};
+
+  /*! @brief Sequence number of the next datagram the writer sends. */
+  uint64_t next_sequence = 0;
+
+  /*! @brief Next expected sequence number per writer address and port. */
+  std::unordered_map<uint64_t, uint64_t> expected;
+
+  /*! @brief Messages lost according to sequence gaps. */
+  uint64_t dropped_count = 0;
+
+  /*! @brief Messages that arrived behind their successors. */
+  uint64_t reordered_count = 0;
+};
+} // namespace ipc
+
+#endif // UDP_SOCKET_TRANSPORT_HPP
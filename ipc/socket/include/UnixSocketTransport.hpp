@@ -0,0 +1,197 @@
+#ifndef UNIX_SOCKET_TRANSPORT_HPP
+#define UNIX_SOCKET_TRANSPORT_HPP
+
+#include <Deadline.hpp>      // For timed send and receive
+#include <IIPCTransport.hpp> // Include the base IPC transport interface
+#include <WireFormat.hpp>    // For the framing used on the wire
+#include <string>            // For std::string
+#include <sys/socket.h>      // For ucred and SO_PEERCRED
+
+namespace ipc {
+
+/*!
+ * @brief The socket types a UnixSocketTransport can use.
+ */
+enum class UnixSocketType {
+  SeqPacket, /*!< SOCK_SEQPACKET: every message is one record, so the kernel
+                keeps message boundaries and no stream reassembly is needed. */
+  Stream     /*!< SOCK_STREAM: frames share one byte stream, which suits bulk
+                transfers of many small messages. */
+};
+
+/*!
+ * @brief Implements the IIPCTransport interface using Unix domain sockets.
+ *
+ * Same-host traffic stays in the AF_UNIX layer instead of going through the
+ * loopback TCP/IP stack. Peers meet at an address in the Linux abstract
+ * namespace, so nothing is created in the file system and the name goes
+ * away with the last socket. Messages travel in the frames of WireFormat.hpp:
+ * one record per frame with UnixSocketType::SeqPacket, back to back with
+ * UnixSocketType::Stream.
+ */
+class UnixSocketTransport : public IIPCTransport {
+public:
+  /*!
+   * @brief Constructs a new UnixSocketTransport object.
+   *
+   * @param type The socket type. Both peers must use the same one.
+   */
+  explicit UnixSocketTransport(UnixSocketType type = UnixSocketType::SeqPacket)
+      : type(type) {}
+
+  /*!
+   * @brief How long a client keeps retrying while the server is not
+   * listening yet, in milliseconds.
+   */
+  static constexpr int CONNECT_TIMEOUT_MS = 5000;
+
+  /*! @brief Most messages passed to one `sendmmsg()` or `recvmmsg()`. */
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /*!
+   * @brief Destroys the UnixSocketTransport object, closing the connection.
+   */
+  ~UnixSocketTransport() override;
+
+  /*!
+   * @brief Initializes the Unix domain socket transport.
+   *
+   * If `create` is true, this instance binds the abstract address `name`,
+   * waits for one peer to connect and then stops listening, which frees the
+   * name again. Otherwise it connects to `name`, retrying for up to
+   * CONNECT_TIMEOUT_MS while the server is not listening yet.
+   *
+   * @param name The abstract socket name, at most 107 bytes. It is placed in
+   * the abstract namespace as given (without a leading NUL).
+   * @param create True for the listening side, false for the connecting side.
+   * @return True if the connection was established, false otherwise.
+   */
+  bool initialize(const std::string &name, bool create) override;
+
+  /*!
+   * @brief Sends an IPCMessage as one frame.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @return True if the message is successfully sent, false otherwise.
+   */
+  bool send_message(const IPCMessage &msg) override;
+
+  /*!
+   * @brief Receives the next IPCMessage, blocking until one arrives.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @return True if a message is successfully received, false if the peer
+   * closed the connection or an error occurred.
+   */
+  bool receive_message(IPCMessage &msg) override;
+
+  /*!
+   * @brief Sends an IPCMessage, waiting at most `timeout` for the
+   * socket to accept it.
+   *
+   * @param msg A constant reference to the IPCMessage to be sent.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus send_for(const IPCMessage &msg,
+                     std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Receives an IPCMessage, waiting at most `timeout` for a
+   * complete frame.
+   *
+   * @param msg A reference to an IPCMessage object where the received data will
+   * be stored.
+   * @param timeout How long to wait. Zero makes a single attempt.
+   * @return IPCStatus::Ok, IPCStatus::Timeout or IPCStatus::Error.
+   */
+  IPCStatus receive_for(IPCMessage &msg,
+                        std::chrono::nanoseconds timeout) override;
+
+  /*!
+   * @brief Sends several messages with as few system calls as possible.
+   *
+   * SeqPacket sockets pass up to BATCH_SIZE records to each `sendmmsg()`;
+   * stream sockets gather frames into one `writev()` per FrameBatch. Either
+   * way payloads are referenced straight from `msgs`.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @return The number of messages sent; less than `count` only on failure.
+   */
+  size_t send_batch(const IPCMessage *msgs, size_t count) override;
+
+  /*!
+   * @brief Receives up to `max` messages.
+   *
+   * Waits for the first message, then collects what is already queued:
+   * SeqPacket sockets with one non-blocking `recvmmsg()`, stream sockets by
+   * decoding the buffered bytes plus one more non-blocking read. Truncated
+   * or malformed SeqPacket records among those are skipped.
+   *
+   * @param msgs Pointer to storage for at least `max` messages.
+   * @param max The maximum number of messages to receive.
+   * @return The number of messages received; 0 on failure.
+   */
+  size_t receive_batch(IPCMessage *msgs, size_t max) override;
+
+  /*!
+   * @brief Returns the connected socket, or -1 before a connection exists.
+   *
+   * With UnixSocketType::Stream, frames already buffered by
+   * receive_batch() do not make it readable; drain with try_receive()
+   * before polling.
+   */
+  int readiness_fd() override;
+
+  /*!
+   * @brief Reads the credentials of the connected peer.
+   *
+   * The kernel records the peer's process, user and group IDs when the
+   * connection is made, so they cannot be forged by the peer.
+   *
+   * @param cred Receives the peer's pid, uid and gid.
+   * @return True on success, false if not connected or the query failed.
+   */
+  bool peer_credentials(ucred &cred) const;
+
+  /*!
+   * @brief Returns the socket type chosen at construction.
+   */
+  UnixSocketType get_type() const;
+
+  /*!
+   * @brief Closes the connection.
+   */
+  void cleanup() override;
+
+private:
+  /*! @brief Sends `msg`, giving up at `deadline`. */
+  IPCStatus send_until(const IPCMessage &msg, const Deadline &deadline);
+
+  /*! @brief Receives into `msg`, giving up at `deadline`. */
+  IPCStatus receive_until(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Sends all `length` bytes of `buffer`, retrying partial sends.
+   *
+   * @return True if everything was sent, false otherwise.
+   */
+  bool send_all(const char *buffer, size_t length);
+
+  /*! @brief Returns the SOCK_* constant for `type`. */
+  int socket_type() const;
+
+  /*! @brief The socket type chosen at construction. */
+  UnixSocketType type;
+
+  /*! @brief The connected socket, or -1. */
+  int socket_fd = -1;
+
+  /*! @brief Reassembles frames on stream sockets. */
+  FrameReader reader;
+};
+} // namespace ipc
+
+#endif // UNIX_SOCKET_TRANSPORT_HPP
@@ -0,0 +1,380 @@
+#include <TCPServerTransport.hpp>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+ipc::TCPServerTransport::~TCPServerTransport() { cleanup(); }
+
+bool ipc::TCPServerTransport::initialize(const std::string &name,
+                                         bool create) {
+  cleanup();
+  if (!create) {
+    std::cerr << "TCPServerTransport only serves; connect with "
+                 "TCPSocketTransport\n";
+    return false;
+  }
+
+  // name format: "ip:port", e.g. "127.0.0.1:12345"
+  size_t colon_pos = name.find(':');
+  if (colon_pos == std::string::npos) {
+    std::cerr << "Invalid address format, expected ip:port\n";
+    return false;
+  }
+  std::string ip = name.substr(0, colon_pos);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(std::stoi(name.substr(colon_pos + 1)));
+  if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) <= 0) {
+    std::cerr << "Invalid IP address\n";
+    return false;
+  }
+
+  listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd < 0) {
+    perror("socket");
+    return false;
+  }
+  int opt = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  if (reuse_port &&
+      setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+    perror("setsockopt(SO_REUSEPORT)");
+    cleanup();
+    return false;
+  }
+  if (bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+    perror("bind");
+    cleanup();
+    return false;
+  }
+  if (listen(listen_fd, SOMAXCONN) < 0) {
+    perror("listen");
+    cleanup();
+    return false;
+  }
+  socklen_t length = sizeof(addr);
+  getsockname(listen_fd, (sockaddr *)&addr, &length);
+  port = ntohs(addr.sin_port);
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1) {
+    perror("epoll_create1");
+    cleanup();
+    return false;
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = NO_CLIENT;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == -1) {
+    perror("epoll_ctl");
+    cleanup();
+    return false;
+  }
+  return true;
+}
+
+bool ipc::TCPServerTransport::send_message(const IPCMessage &msg) {
+  return send_until(last_client, msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::TCPServerTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::TCPServerTransport::send_for(const IPCMessage &msg,
+                                  std::chrono::nanoseconds timeout) {
+  return send_until(last_client, msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::TCPServerTransport::receive_for(IPCMessage &msg,
+                                     std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::TCPServerTransport::send_to(ClientId client,
+                                                const IPCMessage &msg) {
+  return send_until(client, msg, Deadline::never());
+}
+
+ipc::IPCStatus ipc::TCPServerTransport::send_to(
+    ClientId client, const IPCMessage &msg, std::chrono::nanoseconds timeout) {
+  return send_until(client, msg, Deadline(timeout));
+}
+
+size_t ipc::TCPServerTransport::broadcast(const IPCMessage &msg) {
+  // Collect the IDs first: a failed send drops its client.
+  std::vector<ClientId> targets;
+  targets.reserve(clients.size());
+  for (const auto &entry : clients)
+    targets.push_back(entry.first);
+
+  size_t sent = 0;
+  for (ClientId client : targets) {
+    const IPCStatus status =
+        send_until(client, msg, Deadline(broadcast_timeout));
+    if (status == IPCStatus::Ok)
+      ++sent;
+    else if (status == IPCStatus::Timeout)
+      drop(client); // Too slow to keep up with the others
+  }
+  return sent;
+}
+
+void ipc::TCPServerTransport::set_broadcast_timeout(
+    std::chrono::nanoseconds timeout) {
+  broadcast_timeout = timeout;
+}
+
+ipc::TCPServerTransport::ClientId
+ipc::TCPServerTransport::last_sender() const {
+  return last_client;
+}
+
+size_t ipc::TCPServerTransport::client_count() const { return clients.size(); }
+
+int ipc::TCPServerTransport::get_port() const { return port; }
+
+int ipc::TCPServerTransport::readiness_fd() { return epoll_fd; }
+
+void ipc::TCPServerTransport::cleanup() {
+  for (auto &entry : clients)
+    close(entry.second->fd);
+  clients.clear();
+  ready.clear();
+  last_client = NO_CLIENT;
+  port = 0;
+  if (epoll_fd != -1) {
+    close(epoll_fd);
+    epoll_fd = -1;
+  }
+  if (listen_fd != -1) {
+    close(listen_fd);
+    listen_fd = -1;
+  }
+}
+
+ipc::IPCStatus
+ipc::TCPServerTransport::receive_until(IPCMessage &msg,
+                                       const Deadline &deadline) {
+  if (epoll_fd == -1)
+    return IPCStatus::Error;
+
+  for (;;) {
+    // Serve one message from the client at the head of the queue, then move
+    // it to the back, so that clients with pending data take turns.
+    while (!ready.empty()) {
+      const ClientId id = ready.front();
+      ready.pop_front();
+      auto it = clients.find(id);
+      if (it == clients.end())
+        continue;
+      Client &client = *it->second;
+
+      bool drained = false;
+      const bool received =
+          client.reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+            ssize_t recvd;
+            while ((recvd = recv(client.fd, buffer, length, MSG_DONTWAIT)) <
+                       0 &&
+                   errno == EINTR) {
+            }
+            if (recvd < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+              drained = true;
+            return recvd;
+          });
+      if (received) {
+        ready.push_back(id);
+        last_client = id;
+        return IPCStatus::Ok;
+      }
+      if (drained) {
+        // Nothing more for now; epoll reports the client when data arrives.
+        client.queued = false;
+        continue;
+      }
+      // End of stream, an error or a malformed frame.
+      drop(id);
+    }
+
+    int timeout_ms = -1;
+    if (!deadline.is_never()) {
+      // Round up so that the wait does not end just before the deadline.
+      const auto left_ms = (deadline.remaining().count() + 999999) / 1000000;
+      timeout_ms = static_cast<int>(
+          std::min<decltype(left_ms)>(left_ms, std::numeric_limits<int>::max()));
+    }
+    if (!poll_events(timeout_ms))
+      return IPCStatus::Error;
+    if (ready.empty() && deadline.expired())
+      return IPCStatus::Timeout;
+  }
+}
+
+ipc::IPCStatus
+ipc::TCPServerTransport::send_until(ClientId client, const IPCMessage &msg,
+                                    const Deadline &deadline) {
+  auto it = clients.find(client);
+  if (it == clients.end())
+    return IPCStatus::Error;
+  Client &target = *it->second;
+
+  IPCStatus status = flush_unsent(client, target, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char frame[MAX_FRAME_SIZE];
+  const size_t length = encode_frame(msg, frame);
+  size_t written = 0;
+  status = write_until(target, frame, length, deadline, written);
+  if (status == IPCStatus::Timeout && written > 0) {
+    // The peer would take the rest of the frame as the start of the next,
+    // so it has to go out first; the message counts as sent.
+    target.unsent.assign(frame + written, length - written);
+    watch_room(client, target, true);
+    return IPCStatus::Ok;
+  }
+  if (status == IPCStatus::Error)
+    drop(client);
+  return status;
+}
+
+ipc::IPCStatus ipc::TCPServerTransport::write_until(const Client &client,
+                                                    const char *data,
+                                                    size_t length,
+                                                    const Deadline &deadline,
+                                                    size_t &written) {
+  written = 0;
+  while (written < length) {
+    const ssize_t sent =
+        send(client.fd, data + written, length - written, MSG_NOSIGNAL);
+    if (sent > 0) {
+      written += static_cast<size_t>(sent);
+      continue;
+    }
+    if (sent < 0 && errno == EINTR)
+      continue; // interrupted, retry
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      const IPCStatus status = wait_fd(client.fd, POLLOUT, deadline);
+      if (status != IPCStatus::Ok)
+        return status;
+      continue;
+    }
+    perror("send");
+    return IPCStatus::Error;
+  }
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::TCPServerTransport::flush_unsent(ClientId id,
+                                                     Client &client,
+                                                     const Deadline &deadline) {
+  if (client.unsent.empty())
+    return IPCStatus::Ok;
+
+  size_t written = 0;
+  const IPCStatus status = write_until(client, client.unsent.data(),
+                                       client.unsent.size(), deadline, written);
+  if (status == IPCStatus::Error) {
+    drop(id);
+    return status;
+  }
+  client.unsent.erase(0, written);
+  if (client.unsent.empty())
+    watch_room(id, client, false);
+  return status;
+}
+
+void ipc::TCPServerTransport::watch_room(ClientId id, const Client &client,
+                                         bool watch) {
+  epoll_event event{};
+  event.events = EPOLLIN | EPOLLRDHUP | (watch ? EPOLLOUT : 0);
+  event.data.u64 = id;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client.fd, &event) == -1)
+    perror("epoll_ctl");
+}
+
+bool ipc::TCPServerTransport::poll_events(int timeout_ms) {
+  epoll_event events[MAX_EVENTS];
+  int count;
+  while ((count = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms)) ==
+             -1 &&
+         errno == EINTR) {
+  }
+  if (count == -1) {
+    perror("epoll_wait");
+    return false;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    const ClientId id = events[i].data.u64;
+    if (id == NO_CLIENT) {
+      accept_clients();
+      continue;
+    }
+    auto it = clients.find(id);
+    if (it == clients.end())
+      continue;
+    if ((events[i].events & EPOLLOUT) &&
+        flush_unsent(id, *it->second, Deadline(std::chrono::nanoseconds(0))) ==
+            IPCStatus::Error)
+      continue;
+    if (it->second->queued || events[i].events == EPOLLOUT)
+      continue;
+    it->second->queued = true;
+    ready.push_back(id);
+  }
+  return true;
+}
+
+void ipc::TCPServerTransport::accept_clients() {
+  for (;;) {
+    // Sends wait for room with their own deadline, so nothing blocks.
+    const int fd =
+        accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        perror("accept");
+      return;
+    }
+
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    const ClientId id = next_id++;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u64 = id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1) {
+      perror("epoll_ctl");
+      close(fd);
+      continue;
+    }
+    auto client = std::make_unique<Client>();
+    client->fd = fd;
+    clients.emplace(id, std::move(client));
+  }
+}
+
+void ipc::TCPServerTransport::drop(ClientId client) {
+  auto it = clients.find(client);
+  if (it == clients.end())
+    return;
+  // Closing the descriptor also removes it from the epoll set.
+  close(it->second->fd);
+  clients.erase(it);
+  if (last_client == client)
+    last_client = NO_CLIENT;
+}
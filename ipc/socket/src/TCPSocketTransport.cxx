@@ -1,7 +1,13 @@
 #include <TCPSocketTransport.hpp>
 #include <arpa/inet.h>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
+#include <linux/errqueue.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
 #include <string>
 #include <unistd.h>
 
@@ -14,6 +20,8 @@ bool ipc::TCPSocketTransport::initialize(const std::string &name, bool create) {
     std::cerr << "Invalid address format, expected ip:port\n";
     return false;
   }
+  reader.reset();
+  stats = ZeroCopyStats{};
   std::string ip = name.substr(0, colon_pos);
   int port = std::stoi(name.substr(colon_pos + 1));
 
@@ -61,35 +69,196 @@ bool ipc::TCPSocketTransport::initialize(const std::string &name, bool create) {
   } else {
     // Client
     is_server = false;
-    socket_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (socket_fd < 0) {
-      perror("socket");
-      return false;
-    }
+    for (int waited = 0;; waited += 10) {
+      socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+      if (socket_fd < 0) {
+        perror("socket");
+        return false;
+      }
 
-    if (connect(socket_fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
-      perror("connect");
-      cleanup();
-      return false;
+      if (connect(socket_fd, (sockaddr *)&addr, sizeof(addr)) == 0)
+        break;
+
+      // The server may not be listening yet; retry on a fresh socket.
+      const int error = errno;
+      close(socket_fd);
+      socket_fd = -1;
+      if (error != ECONNREFUSED || waited >= CONNECT_TIMEOUT_MS) {
+        errno = error;
+        perror("connect");
+        return false;
+      }
+      usleep(10 * 1000);
     }
 
     std::cout << "[Client] Connected to server\n";
   }
 
+  // Coalescing replaces Nagle's algorithm, so flushes go out at once.
+  if (coalescer.enabled())
+    set_no_delay(true);
+
+  if (backend == IOBackend::IoUring) {
+    const int fd = is_server ? client_fd : socket_fd;
+    stream = std::make_unique<UringStream>();
+    if (!stream->open(fd, fd, true)) {
+      cleanup();
+      return false;
+    }
+  }
   return true;
 }
 
 bool ipc::TCPSocketTransport::send_message(const IPCMessage &msg) {
-  int fd = is_server ? client_fd : socket_fd;
-  return send_all(fd, reinterpret_cast<const char *>(&msg), sizeof(IPCMessage));
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
 }
 
 bool ipc::TCPSocketTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::TCPSocketTransport::send_for(const IPCMessage &msg,
+                                  std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::TCPSocketTransport::receive_for(IPCMessage &msg,
+                                     std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::TCPSocketTransport::send_until(const IPCMessage &msg,
+                                                   const Deadline &deadline) {
+  int fd = is_server ? client_fd : socket_fd;
+  if (fd == -1)
+    return IPCStatus::Error;
+  if (coalescer.enabled()) {
+    return coalescer.add(msg) ? IPCStatus::Ok : IPCStatus::Error;
+  }
+  if (stream) {
+    size_t sent;
+    return stream->send(&msg, 1, deadline, sent);
+  }
+
+  // Once the send buffer has room a frame fits; the deadline is not applied
+  // to the remainder of a frame that was partially accepted.
+  const IPCStatus status = wait_fd(fd, POLLOUT, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char frame[MAX_FRAME_SIZE];
+  return send_all(fd, frame, encode_frame(msg, frame)) ? IPCStatus::Ok
+                                                       : IPCStatus::Error;
+}
+
+ipc::IPCStatus ipc::TCPSocketTransport::receive_until(IPCMessage &msg,
+                                                      const Deadline &deadline) {
+  int fd = is_server ? client_fd : socket_fd;
+  if (fd == -1)
+    return IPCStatus::Error;
+  // The peer may be waiting for a held back message before it answers.
+  if (!flush())
+    return IPCStatus::Error;
+  if (stream)
+    return stream->receive(msg, deadline);
+
+  IPCStatus status = IPCStatus::Ok;
+  const bool received =
+      reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+        status = wait_fd(fd, POLLIN, deadline);
+        if (status != IPCStatus::Ok)
+          return -1;
+        ssize_t recvd;
+        while ((recvd = recv(fd, buffer, length, 0)) < 0 && errno == EINTR) {
+        }
+        if (recvd < 0)
+          perror("recv");
+        if (recvd <= 0)
+          status = IPCStatus::Error;
+        return recvd;
+      });
+  if (received)
+    return IPCStatus::Ok;
+  return status == IPCStatus::Ok ? IPCStatus::Error : status;
+}
+
+size_t ipc::TCPSocketTransport::send_batch(const IPCMessage *msgs,
+                                           size_t count) {
+  if (!flush())
+    return 0;
+  return write_batch(msgs, count);
+}
+
+bool ipc::TCPSocketTransport::set_coalescing(const CoalescingPolicy &policy) {
+  const bool flushed = flush();
+  coalescer.set_policy(policy);
+  if (policy.enabled() && (is_server ? client_fd : socket_fd) != -1)
+    set_no_delay(true);
+  return flushed;
+}
+
+bool ipc::TCPSocketTransport::set_no_delay(bool enable) {
+  return set_tcp_option(TCP_NODELAY, enable);
+}
+
+bool ipc::TCPSocketTransport::set_cork(bool enable) {
+  return set_tcp_option(TCP_CORK, enable);
+}
+
+bool ipc::TCPSocketTransport::flush() { return coalescer.flush(); }
+
+size_t ipc::TCPSocketTransport::write_batch(const IPCMessage *msgs,
+                                            size_t count) {
   int fd = is_server ? client_fd : socket_fd;
-  return recv_all(fd, reinterpret_cast<char *>(&msg), sizeof(IPCMessage));
+  size_t sent = 0;
+  if (stream) {
+    stream->send(msgs, count, Deadline::never(), sent);
+    return sent;
+  }
+
+  FrameBatch batch;
+  while (sent < count) {
+    const size_t added = batch.add(msgs + sent, count - sent);
+    if (!batch.write_all(fd)) {
+      perror("writev");
+      break;
+    }
+    sent += added;
+  }
+  return sent;
+}
+
+size_t ipc::TCPSocketTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+  if (stream)
+    return 1 + stream->receive_ready(msgs + 1, max - 1);
+
+  // Top up the buffer only with data that is already queued.
+  int fd = is_server ? client_fd : socket_fd;
+  size_t received = 1;
+  while (received < max &&
+         reader.next(msgs[received], [fd](char *buffer, size_t length) {
+           return recv(fd, buffer, length, MSG_DONTWAIT);
+         }))
+    ++received;
+  return received;
+}
+
+int ipc::TCPSocketTransport::readiness_fd() {
+  if (stream)
+    return stream->fd();
+  return is_server ? client_fd : socket_fd;
 }
 
 void ipc::TCPSocketTransport::cleanup() {
+  // Messages still held back are dropped; flush() first to deliver them.
+  coalescer.clear();
+  // The stream must let go of the socket before it is closed.
+  stream.reset();
+  zerocopy_enabled = false;
   if (client_fd != -1) {
     close(client_fd);
     client_fd = -1;
@@ -100,34 +269,184 @@ void ipc::TCPSocketTransport::cleanup() {
   }
 }
 
-bool ipc::TCPSocketTransport::send_all(int fd, const char *buffer,
-                                       size_t length) {
-  size_t total_sent = 0;
-  while (total_sent < length) {
-    ssize_t sent = send(fd, buffer + total_sent, length - total_sent, 0);
+bool ipc::TCPSocketTransport::send(const void *data, size_t size) {
+  const int fd = is_server ? client_fd : socket_fd;
+  if (fd == -1 || stream || !flush())
+    return false;
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  encode_payload_prefix(size, prefix);
+  const char *bytes = static_cast<const char *>(data);
+  if (size < zerocopy_threshold)
+    return send_all(fd, prefix, sizeof(prefix), MSG_MORE | MSG_NOSIGNAL) &&
+           send_all(fd, bytes, size, MSG_NOSIGNAL);
+  return send_all(fd, prefix, sizeof(prefix), MSG_MORE | MSG_NOSIGNAL) &&
+         send_zerocopy(fd, bytes, size);
+}
+
+bool ipc::TCPSocketTransport::send_file(int file_fd, off_t offset,
+                                        size_t size) {
+  const int fd = is_server ? client_fd : socket_fd;
+  if (fd == -1 || stream || !flush())
+    return false;
+
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  encode_payload_prefix(size, prefix);
+  if (!send_all(fd, prefix, sizeof(prefix), MSG_MORE | MSG_NOSIGNAL))
+    return false;
+
+  size_t remaining = size;
+  while (remaining > 0) {
+    const ssize_t sent = sendfile(fd, file_fd, &offset, remaining);
     if (sent <= 0) {
       if (sent < 0 && errno == EINTR)
-        continue; // interrupted, retry
-      perror("send");
+        continue;
+      // Zero means the file ended early; the frame cannot be completed.
+      perror("sendfile");
       return false;
     }
-    total_sent += sent;
+    remaining -= static_cast<size_t>(sent);
   }
   return true;
 }
 
-bool ipc::TCPSocketTransport::recv_all(int fd, char *buffer, size_t length) {
-  size_t total_received = 0;
-  while (total_received < length) {
-    ssize_t recvd =
-        recv(fd, buffer + total_received, length - total_received, 0);
-    if (recvd <= 0) {
-      if (recvd < 0 && errno == EINTR)
-        continue; // interrupted, retry
+bool ipc::TCPSocketTransport::receive(std::vector<char> &out) {
+  const int fd = is_server ? client_fd : socket_fd;
+  if (fd == -1 || stream || !flush())
+    return false;
+
+  auto read_some = [fd](char *buffer, size_t length) -> ssize_t {
+    ssize_t recvd;
+    while ((recvd = recv(fd, buffer, length, 0)) < 0 && errno == EINTR) {
+    }
+    if (recvd < 0)
       perror("recv");
+    return recvd;
+  };
+  char prefix[PAYLOAD_PREFIX_SIZE];
+  uint64_t size = 0;
+  if (!reader.read(prefix, sizeof(prefix), read_some) ||
+      !decode_payload_prefix(prefix, size) || size > MAX_PAYLOAD_SIZE)
+    return false;
+  out.resize(size);
+  return reader.read(out.data(), size, read_some);
+}
+
+void ipc::TCPSocketTransport::set_zerocopy_threshold(size_t bytes) {
+  zerocopy_threshold = bytes;
+}
+
+const ipc::ZeroCopyStats &ipc::TCPSocketTransport::zerocopy_stats() const {
+  return stats;
+}
+
+bool ipc::TCPSocketTransport::send_zerocopy(int fd, const char *data,
+                                            size_t size) {
+  if (!zerocopy_enabled) {
+    const int one = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0)
+      return send_all(fd, data, size, MSG_NOSIGNAL);
+    zerocopy_enabled = true;
+  }
+
+  size_t done = 0;
+  while (done < size) {
+    const ssize_t sent =
+        ::send(fd, data + done, size - done, MSG_ZEROCOPY | MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR)
+        continue;
+      // Every pending notification uses socket option memory; once it runs
+      // out, wait for the outstanding ones, or copy if there are none.
+      if (errno == ENOBUFS && stats.completed < stats.sends) {
+        if (!reap_zerocopy(fd, true))
+          return false;
+        continue;
+      }
+      if (errno == ENOBUFS)
+        return send_all(fd, data + done, size - done, MSG_NOSIGNAL);
+      perror("send(MSG_ZEROCOPY)");
+      return false;
+    }
+    ++stats.sends;
+    done += static_cast<size_t>(sent);
+    if (!reap_zerocopy(fd, false))
+      return false;
+  }
+  // The caller may reuse the buffer only once the kernel has let go of it.
+  return reap_zerocopy(fd, true);
+}
+
+bool ipc::TCPSocketTransport::reap_zerocopy(int fd, bool wait) {
+  while (stats.completed < stats.sends) {
+    char control[128];
+    msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &msg, MSG_ERRQUEUE) < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        perror("recvmsg(MSG_ERRQUEUE)");
+        return false;
+      }
+      if (!wait)
+        return true;
+      // A queued completion makes the socket report POLLERR.
+      pollfd pfd{fd, 0, 0};
+      if (poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+        perror("poll");
+        return false;
+      }
+      if (pfd.revents & POLLHUP)
+        return false;
+      continue;
+    }
+
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+        continue;
+      const auto *error =
+          reinterpret_cast<const sock_extended_err *>(CMSG_DATA(cmsg));
+      if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        continue;
+      // One notification covers the range of send calls [ee_info, ee_data].
+      const uint64_t count = error->ee_data - error->ee_info + 1;
+      stats.completed += count;
+      if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        stats.copied += count;
+    }
+  }
+  return true;
+}
+
+bool ipc::TCPSocketTransport::set_tcp_option(int option, bool enable) {
+  const int fd = is_server ? client_fd : socket_fd;
+  const int value = enable ? 1 : 0;
+  if (fd == -1)
+    return false;
+  if (setsockopt(fd, IPPROTO_TCP, option, &value, sizeof(value)) < 0) {
+    perror("setsockopt");
+    return false;
+  }
+  return true;
+}
+
+bool ipc::TCPSocketTransport::send_all(int fd, const char *buffer,
+                                       size_t length, int flags) {
+  size_t total_sent = 0;
+  while (total_sent < length) {
+    ssize_t sent =
+        ::send(fd, buffer + total_sent, length - total_sent, flags);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR)
+        continue; // interrupted, retry
+      perror("send");
       return false;
     }
-    total_received += recvd;
+    total_sent += sent;
   }
   return true;
 }
@@ -0,0 +1,297 @@
+#include <UDPSocketTransport.hpp>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+ipc::UDPSocketTransport::~UDPSocketTransport() { cleanup(); }
+
+bool ipc::UDPSocketTransport::initialize(const std::string &name,
+                                         bool create) {
+  cleanup();
+
+  // name format: "ip:port", e.g. "239.255.0.1:12345"
+  size_t colon_pos = name.find(':');
+  if (colon_pos == std::string::npos) {
+    std::cerr << "Invalid address format, expected ip:port\n";
+    return false;
+  }
+  std::string ip = name.substr(0, colon_pos);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(std::stoi(name.substr(colon_pos + 1)));
+  if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) <= 0) {
+    std::cerr << "Invalid IP address\n";
+    return false;
+  }
+  const bool multicast = IN_MULTICAST(ntohl(addr.sin_addr.s_addr));
+
+  socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (socket_fd < 0) {
+    perror("socket");
+    return false;
+  }
+  is_writer = create;
+  next_sequence = 0;
+  expected.clear();
+  dropped_count = 0;
+  reordered_count = 0;
+
+  if (create) {
+    if (multicast) {
+      const unsigned char loop = 1;
+      setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+                 sizeof(loop));
+      if (multicast_interface.s_addr != htonl(INADDR_ANY) &&
+          setsockopt(socket_fd, IPPROTO_IP, IP_MULTICAST_IF,
+                     &multicast_interface, sizeof(multicast_interface)) < 0) {
+        perror("setsockopt(IP_MULTICAST_IF)");
+        cleanup();
+        return false;
+      }
+    }
+    // A connected datagram socket needs no address per send.
+    if (connect(socket_fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+      perror("connect");
+      cleanup();
+      return false;
+    }
+    return true;
+  }
+
+  // Several readers on one host may follow the same group.
+  int opt = 1;
+  setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  const int buffer_size = RECEIVE_BUFFER_SIZE;
+  setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUF, &buffer_size,
+             sizeof(buffer_size));
+
+  sockaddr_in local = addr;
+  if (multicast)
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(socket_fd, (sockaddr *)&local, sizeof(local)) < 0) {
+    perror("bind");
+    cleanup();
+    return false;
+  }
+  if (multicast) {
+    ip_mreq membership{};
+    membership.imr_multiaddr = addr.sin_addr;
+    membership.imr_interface = multicast_interface;
+    if (setsockopt(socket_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership,
+                   sizeof(membership)) < 0) {
+      perror("setsockopt(IP_ADD_MEMBERSHIP)");
+      cleanup();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ipc::UDPSocketTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::UDPSocketTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::UDPSocketTransport::send_for(const IPCMessage &msg,
+                                  std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::UDPSocketTransport::receive_for(IPCMessage &msg,
+                                     std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::UDPSocketTransport::send_until(const IPCMessage &msg,
+                                                   const Deadline &deadline) {
+  if (socket_fd == -1 || !is_writer)
+    return IPCStatus::Error;
+
+  const IPCStatus status = wait_fd(socket_fd, POLLOUT, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char datagram[MAX_DATAGRAM_SIZE];
+  const size_t length = encode_datagram(msg, next_sequence, datagram);
+  // Without a reader, a unicast send may report the ICMP error of an
+  // earlier datagram instead of sending; the error is cleared, so retry.
+  ssize_t sent;
+  while ((sent = send(socket_fd, datagram, length, 0)) < 0 &&
+         (errno == EINTR || errno == ECONNREFUSED)) {
+  }
+  if (sent < 0) {
+    perror("send");
+    return IPCStatus::Error;
+  }
+  ++next_sequence;
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::UDPSocketTransport::receive_until(IPCMessage &msg,
+                                                      const Deadline &deadline) {
+  if (socket_fd == -1 || is_writer)
+    return IPCStatus::Error;
+
+  // Blocking calls block in recvfrom(); timed calls poll first.
+  const int flags = deadline.is_never() ? 0 : MSG_DONTWAIT;
+  for (;;) {
+    const IPCStatus status = wait_fd(socket_fd, POLLIN, deadline);
+    if (status != IPCStatus::Ok)
+      return status;
+
+    char datagram[MAX_DATAGRAM_SIZE];
+    sockaddr_in from{};
+    socklen_t from_length = sizeof(from);
+    const ssize_t recvd =
+        recvfrom(socket_fd, datagram, sizeof(datagram), flags | MSG_TRUNC,
+                 (sockaddr *)&from, &from_length);
+    if (recvd < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+        continue;
+      perror("recvfrom");
+      return IPCStatus::Error;
+    }
+    if (accept_datagram(datagram, static_cast<size_t>(recvd), from, msg))
+      return IPCStatus::Ok;
+  }
+}
+
+size_t ipc::UDPSocketTransport::send_batch(const IPCMessage *msgs,
+                                           size_t count) {
+  size_t sent = 0;
+  if (socket_fd == -1 || !is_writer)
+    return sent;
+
+  char datagrams[BATCH_SIZE][MAX_DATAGRAM_SIZE];
+  iovec iov[BATCH_SIZE];
+  mmsghdr headers[BATCH_SIZE];
+  while (sent < count) {
+    const size_t n = std::min(BATCH_SIZE, count - sent);
+    for (size_t i = 0; i < n; ++i) {
+      iov[i] = {datagrams[i], encode_datagram(msgs[sent + i],
+                                              next_sequence + i, datagrams[i])};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_iov = &iov[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t done = 0;
+    while (done < n) {
+      const int result = sendmmsg(socket_fd, headers + done,
+                                  static_cast<unsigned>(n - done), 0);
+      if (result < 0) {
+        if (errno == EINTR || errno == ECONNREFUSED)
+          continue;
+        perror("sendmmsg");
+        next_sequence += done;
+        return sent + done;
+      }
+      done += static_cast<size_t>(result);
+    }
+    next_sequence += n;
+    sent += n;
+  }
+  return sent;
+}
+
+size_t ipc::UDPSocketTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+
+  char datagrams[BATCH_SIZE][MAX_DATAGRAM_SIZE];
+  iovec iov[BATCH_SIZE];
+  sockaddr_in from[BATCH_SIZE];
+  mmsghdr headers[BATCH_SIZE];
+  size_t received = 1;
+  while (received < max) {
+    const size_t n = std::min(BATCH_SIZE, max - received);
+    for (size_t i = 0; i < n; ++i) {
+      iov[i] = {datagrams[i], MAX_DATAGRAM_SIZE};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_iov = &iov[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+      headers[i].msg_hdr.msg_name = &from[i];
+      headers[i].msg_hdr.msg_namelen = sizeof(from[i]);
+    }
+    const int result = recvmmsg(socket_fd, headers, static_cast<unsigned>(n),
+                                MSG_DONTWAIT, nullptr);
+    if (result <= 0)
+      break;
+    for (int i = 0; i < result; ++i) {
+      const size_t size = (headers[i].msg_hdr.msg_flags & MSG_TRUNC)
+                              ? MAX_DATAGRAM_SIZE + 1
+                              : headers[i].msg_len;
+      if (accept_datagram(datagrams[i], size, from[i], msgs[received]))
+        ++received;
+    }
+    if (static_cast<size_t>(result) < n)
+      break;
+  }
+  return received;
+}
+
+int ipc::UDPSocketTransport::readiness_fd() { return socket_fd; }
+
+bool ipc::UDPSocketTransport::set_multicast_interface(const std::string &ip) {
+  return inet_pton(AF_INET, ip.c_str(), &multicast_interface) == 1;
+}
+
+uint64_t ipc::UDPSocketTransport::dropped() const { return dropped_count; }
+
+uint64_t ipc::UDPSocketTransport::reordered() const { return reordered_count; }
+
+void ipc::UDPSocketTransport::cleanup() {
+  // Closing the socket also leaves its multicast groups.
+  if (socket_fd != -1) {
+    close(socket_fd);
+    socket_fd = -1;
+  }
+}
+
+size_t ipc::UDPSocketTransport::encode_datagram(const IPCMessage &msg,
+                                                uint64_t sequence, char *out) {
+  unsigned char *bytes = reinterpret_cast<unsigned char *>(out);
+  for (size_t i = 0; i < SEQUENCE_SIZE; ++i)
+    bytes[i] = static_cast<unsigned char>(sequence >> (8 * i));
+  return SEQUENCE_SIZE + encode_frame(msg, out + SEQUENCE_SIZE);
+}
+
+bool ipc::UDPSocketTransport::accept_datagram(const char *datagram,
+                                              size_t size,
+                                              const sockaddr_in &from,
+                                              IPCMessage &msg) {
+  if (size < SEQUENCE_SIZE || size > MAX_DATAGRAM_SIZE ||
+      !decode_frame(datagram + SEQUENCE_SIZE, size - SEQUENCE_SIZE, msg))
+    return false;
+
+  const unsigned char *bytes =
+      reinterpret_cast<const unsigned char *>(datagram);
+  uint64_t sequence = 0;
+  for (size_t i = 0; i < SEQUENCE_SIZE; ++i)
+    sequence |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+
+  // A writer is told apart by its address and port.
+  const uint64_t writer =
+      static_cast<uint64_t>(ntohl(from.sin_addr.s_addr)) << 16 |
+      ntohs(from.sin_port);
+  auto it = expected.find(writer);
+  if (it == expected.end()) {
+    // Messages sent before this reader first heard the writer do not count.
+    expected.emplace(writer, sequence + 1);
+  } else if (sequence >= it->second) {
+    dropped_count += sequence - it->second;
+    it->second = sequence + 1;
+  } else {
+    ++reordered_count;
+  }
+  return true;
+}
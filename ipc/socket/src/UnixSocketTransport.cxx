@@ -0,0 +1,296 @@
+#include <FdPassing.hpp>
+#include <UnixSocketTransport.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <string>
+#include <unistd.h>
+
+ipc::UnixSocketTransport::~UnixSocketTransport() { cleanup(); }
+
+bool ipc::UnixSocketTransport::initialize(const std::string &name,
+                                          bool create) {
+  cleanup();
+  reader.reset();
+
+  sockaddr_un address{};
+  socklen_t length = 0;
+  if (!make_abstract_address(name, address, length))
+    return false;
+
+  if (create) {
+    const int listen_fd = socket(AF_UNIX, socket_type() | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+      perror("socket");
+      return false;
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), length) < 0 ||
+        listen(listen_fd, 1) < 0) {
+      perror("bind/listen");
+      close(listen_fd);
+      return false;
+    }
+
+    while ((socket_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC)) <
+               0 &&
+           errno == EINTR) {
+    }
+    const int error = errno;
+    // Only one peer is served; closing the listener frees the name.
+    close(listen_fd);
+    if (socket_fd < 0) {
+      errno = error;
+      perror("accept");
+      return false;
+    }
+    return true;
+  }
+
+  for (int waited = 0;; waited += 10) {
+    socket_fd = socket(AF_UNIX, socket_type() | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0) {
+      perror("socket");
+      return false;
+    }
+    if (connect(socket_fd, reinterpret_cast<sockaddr *>(&address), length) ==
+        0)
+      return true;
+
+    // The server may not be listening yet; retry on a fresh socket.
+    const int error = errno;
+    close(socket_fd);
+    socket_fd = -1;
+    if ((error != ECONNREFUSED && error != EAGAIN) ||
+        waited >= CONNECT_TIMEOUT_MS) {
+      errno = error;
+      perror("connect");
+      return false;
+    }
+    usleep(10 * 1000);
+  }
+}
+
+bool ipc::UnixSocketTransport::send_message(const IPCMessage &msg) {
+  return send_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+bool ipc::UnixSocketTransport::receive_message(IPCMessage &msg) {
+  return receive_until(msg, Deadline::never()) == IPCStatus::Ok;
+}
+
+ipc::IPCStatus
+ipc::UnixSocketTransport::send_for(const IPCMessage &msg,
+                                   std::chrono::nanoseconds timeout) {
+  return send_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus
+ipc::UnixSocketTransport::receive_for(IPCMessage &msg,
+                                      std::chrono::nanoseconds timeout) {
+  return receive_until(msg, Deadline(timeout));
+}
+
+ipc::IPCStatus ipc::UnixSocketTransport::send_until(const IPCMessage &msg,
+                                                    const Deadline &deadline) {
+  if (socket_fd == -1)
+    return IPCStatus::Error;
+
+  // A record is accepted whole; on a stream the deadline is not applied to
+  // the remainder of a frame that was partially accepted.
+  const IPCStatus status = wait_fd(socket_fd, POLLOUT, deadline);
+  if (status != IPCStatus::Ok)
+    return status;
+
+  char frame[MAX_FRAME_SIZE];
+  return send_all(frame, encode_frame(msg, frame)) ? IPCStatus::Ok
+                                                   : IPCStatus::Error;
+}
+
+ipc::IPCStatus
+ipc::UnixSocketTransport::receive_until(IPCMessage &msg,
+                                        const Deadline &deadline) {
+  if (socket_fd == -1)
+    return IPCStatus::Error;
+
+  if (type == UnixSocketType::SeqPacket) {
+    const IPCStatus status = wait_fd(socket_fd, POLLIN, deadline);
+    if (status != IPCStatus::Ok)
+      return status;
+
+    char frame[MAX_FRAME_SIZE];
+    ssize_t recvd;
+    // MSG_TRUNC reports the full record length, so oversized records fail
+    // to decode instead of being silently cut.
+    while ((recvd = recv(socket_fd, frame, sizeof(frame), MSG_TRUNC)) < 0 &&
+           errno == EINTR) {
+    }
+    if (recvd < 0) {
+      perror("recv");
+      return IPCStatus::Error;
+    }
+    if (recvd == 0)
+      return IPCStatus::Error; // Peer closed the connection
+    return decode_frame(frame, static_cast<size_t>(recvd), msg)
+               ? IPCStatus::Ok
+               : IPCStatus::Error;
+  }
+
+  IPCStatus status = IPCStatus::Ok;
+  const bool received =
+      reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+        status = wait_fd(socket_fd, POLLIN, deadline);
+        if (status != IPCStatus::Ok)
+          return -1;
+        ssize_t recvd;
+        while ((recvd = recv(socket_fd, buffer, length, 0)) < 0 &&
+               errno == EINTR) {
+        }
+        if (recvd < 0)
+          perror("recv");
+        if (recvd <= 0)
+          status = IPCStatus::Error;
+        return recvd;
+      });
+  if (received)
+    return IPCStatus::Ok;
+  return status == IPCStatus::Ok ? IPCStatus::Error : status;
+}
+
+size_t ipc::UnixSocketTransport::send_batch(const IPCMessage *msgs,
+                                            size_t count) {
+  size_t sent = 0;
+  if (socket_fd == -1)
+    return sent;
+
+  if (type == UnixSocketType::Stream) {
+    FrameBatch batch;
+    while (sent < count) {
+      const size_t added = batch.add(msgs + sent, count - sent);
+      if (!batch.write_all(socket_fd)) {
+        perror("writev");
+        break;
+      }
+      sent += added;
+    }
+    return sent;
+  }
+
+  char headers[BATCH_SIZE][MAX_FRAME_HEADER_SIZE];
+  iovec iov[BATCH_SIZE][2];
+  mmsghdr records[BATCH_SIZE];
+  while (sent < count) {
+    const size_t n = std::min(BATCH_SIZE, count - sent);
+    for (size_t i = 0; i < n; ++i) {
+      const IPCMessage &msg = msgs[sent + i];
+      const FrameHeader header = message_frame_header(msg);
+      encode_frame_header(header, headers[i]);
+      iov[i][0] = {headers[i], frame_header_size(header)};
+      iov[i][1] = {const_cast<char *>(msg.data), header.length};
+      records[i] = {};
+      records[i].msg_hdr.msg_iov = iov[i];
+      records[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    // A blocking sendmmsg() may still stop early, e.g. on a signal.
+    size_t done = 0;
+    while (done < n) {
+      const int result = sendmmsg(socket_fd, records + done,
+                                  static_cast<unsigned>(n - done), MSG_NOSIGNAL);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        perror("sendmmsg");
+        return sent + done;
+      }
+      done += static_cast<size_t>(result);
+    }
+    sent += n;
+  }
+  return sent;
+}
+
+size_t ipc::UnixSocketTransport::receive_batch(IPCMessage *msgs, size_t max) {
+  if (max == 0 || !receive_message(msgs[0]))
+    return 0;
+  size_t received = 1;
+
+  if (type == UnixSocketType::Stream) {
+    // Top up the buffer only with data that is already queued.
+    const int fd = socket_fd;
+    while (received < max &&
+           reader.next(msgs[received], [fd](char *buffer, size_t length) {
+             return recv(fd, buffer, length, MSG_DONTWAIT);
+           }))
+      ++received;
+    return received;
+  }
+
+  char frames[BATCH_SIZE][MAX_FRAME_SIZE];
+  iovec iov[BATCH_SIZE];
+  mmsghdr records[BATCH_SIZE];
+  while (received < max) {
+    const size_t n = std::min(BATCH_SIZE, max - received);
+    for (size_t i = 0; i < n; ++i) {
+      iov[i] = {frames[i], MAX_FRAME_SIZE};
+      records[i] = {};
+      records[i].msg_hdr.msg_iov = &iov[i];
+      records[i].msg_hdr.msg_iovlen = 1;
+    }
+    const int result = recvmmsg(socket_fd, records, static_cast<unsigned>(n),
+                                MSG_DONTWAIT, nullptr);
+    if (result <= 0)
+      break;
+    for (int i = 0; i < result; ++i) {
+      // The records after a truncated or malformed one are already taken
+      // off the socket, so skip only the bad one.
+      if ((records[i].msg_hdr.msg_flags & MSG_TRUNC) ||
+          !decode_frame(frames[i], records[i].msg_len, msgs[received]))
+        continue;
+      ++received;
+    }
+    if (static_cast<size_t>(result) < n)
+      break;
+  }
+  return received;
+}
+
+int ipc::UnixSocketTransport::readiness_fd() { return socket_fd; }
+
+bool ipc::UnixSocketTransport::peer_credentials(ucred &cred) const {
+  if (socket_fd == -1)
+    return false;
+  socklen_t length = sizeof(cred);
+  if (getsockopt(socket_fd, SOL_SOCKET, SO_PEERCRED, &cred, &length) < 0) {
+    perror("getsockopt(SO_PEERCRED)");
+    return false;
+  }
+  return true;
+}
+
+ipc::UnixSocketType ipc::UnixSocketTransport::get_type() const { return type; }
+
+void ipc::UnixSocketTransport::cleanup() {
+  if (socket_fd != -1) {
+    close(socket_fd);
+    socket_fd = -1;
+  }
+}
+
+bool ipc::UnixSocketTransport::send_all(const char *buffer, size_t length) {
+  size_t total_sent = 0;
+  while (total_sent < length) {
+    ssize_t sent = send(socket_fd, buffer + total_sent, length - total_sent,
+                        MSG_NOSIGNAL);
+    if (sent <= 0) {
+      if (sent < 0 && errno == EINTR)
+        continue; // interrupted, retry
+      perror("send");
+      return false;
+    }
+    total_sent += sent;
+  }
+  return true;
+}
+
+int ipc::UnixSocketTransport::socket_type() const {
+  return type == UnixSocketType::SeqPacket ? SOCK_SEQPACKET : SOCK_STREAM;
+}
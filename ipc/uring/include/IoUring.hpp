@@ -0,0 +1,136 @@
+#ifndef IPC_IO_URING_HPP
+#define IPC_IO_URING_HPP
+
+#include <cstddef>          // For size_t
+#include <cstdint>          // For fixed-width integer types
+#include <linux/io_uring.h> // For the io_uring ABI
+#include <sys/uio.h>        // For iovec
+#include <time.h>           // For timespec
+
+namespace ipc {
+
+/*!
+ * @brief A minimal io_uring instance driven through the raw system calls.
+ *
+ * Maps the submission and completion rings and exposes just what the
+ * transports need: taking submission entries, submitting them (optionally
+ * waiting for completions in the same call) and reaping completions straight
+ * from the shared ring without a system call. Not thread-safe.
+ */
+class IoUring {
+public:
+  /*! @brief Constructs a closed instance. */
+  IoUring() = default;
+
+  /*! @brief Calls `close()`. */
+  ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  /*!
+   * @brief Creates the instance and maps its rings.
+   *
+   * @param entries Submission ring size; the kernel rounds it up to a power
+   * of two.
+   * @return True on success, false otherwise.
+   */
+  bool setup(unsigned entries);
+
+  /*! @brief Unmaps the rings and closes the instance. */
+  void close();
+
+  /*! @brief Returns the ring descriptor, which polls readable while
+   * completions are pending, or -1. */
+  int fd() const { return ring_fd; }
+
+  /*!
+   * @brief Returns a zeroed submission entry, or nullptr if the submission
+   * ring is full. The entry is sent to the kernel by the next `submit()`.
+   */
+  io_uring_sqe *get_sqe();
+
+  /*!
+   * @brief Submits the prepared entries and optionally waits.
+   *
+   * @param wait_nr Completions to wait for; 0 returns at once.
+   * @param timeout Relative limit on the wait, or nullptr for none.
+   * @return The number of entries submitted, or a negated errno value;
+   * -ETIME if the timeout passed, -EINTR if a signal interrupted the wait.
+   */
+  int submit(unsigned wait_nr = 0, const timespec *timeout = nullptr);
+
+  /*! @brief Returns true if entries are prepared but not submitted. */
+  bool has_unsubmitted() const { return sqe_tail != sqe_head; }
+
+  /*! @brief Returns the oldest completion, or nullptr if there is none. */
+  io_uring_cqe *peek_cqe();
+
+  /*! @brief Retires the completion returned by `peek_cqe()`. */
+  void cqe_seen();
+
+  /*!
+   * @brief Registers `count` fixed buffers for the `*_FIXED` opcodes.
+   *
+   * @return True on success, false otherwise.
+   */
+  bool register_buffers(const iovec *buffers, unsigned count);
+
+  /*!
+   * @brief Registers a provided buffer ring for buffer group `group`.
+   *
+   * @param ring Page-aligned memory for `entries` io_uring_buf entries.
+   * @param entries Number of entries, a power of two.
+   * @return True on success, false otherwise.
+   */
+  bool register_buffer_ring(io_uring_buf_ring *ring, unsigned entries,
+                            uint16_t group);
+
+private:
+  /*! @brief The io_uring descriptor. */
+  int ring_fd = -1;
+
+  /*! @brief Mapping holding the submission ring indices and array. */
+  void *sq_map = nullptr;
+
+  /*! @brief Size of `sq_map`. */
+  size_t sq_map_size = 0;
+
+  /*! @brief Mapping holding the completion ring, or nullptr if it shares
+   * `sq_map`. */
+  void *cq_map = nullptr;
+
+  /*! @brief Size of `cq_map`. */
+  size_t cq_map_size = 0;
+
+  /*! @brief The submission entries. */
+  io_uring_sqe *sqes = nullptr;
+
+  /*! @brief Size of the `sqes` mapping. */
+  size_t sqes_size = 0;
+
+  /*! @brief Submission ring fields shared with the kernel. */
+  unsigned *sq_head = nullptr, *sq_tail = nullptr, *sq_array = nullptr;
+
+  /*! @brief Submission ring mask and size. */
+  unsigned sq_mask = 0, sq_entries = 0;
+
+  /*! @brief Completion ring fields shared with the kernel. */
+  unsigned *cq_head = nullptr, *cq_tail = nullptr;
+
+  /*! @brief Completion ring mask. */
+  unsigned cq_mask = 0;
+
+  /*! @brief The completion entries. */
+  io_uring_cqe *cqes = nullptr;
+
+  /*! @brief Entries handed out by `get_sqe()` and not yet published. */
+  unsigned sqe_tail = 0;
+
+  /*! @brief Entries published to the kernel. */
+  unsigned sqe_head = 0;
+};
+
+} // namespace ipc
+
+#endif // IPC_IO_URING_HPP
@@ -0,0 +1,194 @@
+#ifndef IPC_URING_STREAM_HPP
+#define IPC_URING_STREAM_HPP
+
+#include <Deadline.hpp>   // For timed operations
+#include <IoUring.hpp>    // For the io_uring instance
+#include <WireFormat.hpp> // For the framing used on the wire
+#include <cstdint>        // For fixed-width integer types
+#include <deque>          // For the received chunks
+
+namespace ipc {
+
+/*!
+ * @brief Selects how a stream transport performs its I/O.
+ */
+enum class IOBackend {
+  Syscalls, /*!< One read/write (or recv/send) system call per transfer. */
+  IoUring   /*!< Receives and sends through an io_uring (see UringStream). */
+};
+
+/*!
+ * @brief Moves frames over a pipe pair or a connected stream socket with
+ * io_uring.
+ *
+ * A receive stays in flight at all times: a multishot recv on sockets, a
+ * re-armed read on pipes. The kernel completes it into a ring of
+ * BUFFER_COUNT provided buffers, so while data keeps arriving, received
+ * frames are reaped from the completion ring without any system call.
+ * Sends are encoded into one of two registered send buffers and submitted
+ * with a single `io_uring_enter()` per buffer. One send is in flight at a
+ * time, which keeps the byte stream in order; encoding the next buffer
+ * overlaps with it.
+ */
+class UringStream {
+public:
+  /*! @brief Submission ring size. */
+  static constexpr unsigned RING_ENTRIES = 64;
+
+  /*! @brief Number of provided receive buffers, a power of two. */
+  static constexpr unsigned BUFFER_COUNT = 64;
+
+  /*! @brief Size of each provided receive buffer. */
+  static constexpr size_t BUFFER_SIZE = 4096;
+
+  /*! @brief Size of each of the two send buffers. */
+  static constexpr size_t SEND_BUFFER_SIZE = 64 * MAX_FRAME_SIZE;
+
+  /*! @brief Constructs a closed stream. */
+  UringStream() = default;
+
+  /*! @brief Calls `close()`. */
+  ~UringStream();
+
+  UringStream(const UringStream &) = delete;
+  UringStream &operator=(const UringStream &) = delete;
+
+  /*!
+   * @brief Sets up the ring and buffers and arms the first receive.
+   *
+   * The descriptors stay owned by the caller and must stay open until
+   * `close()`.
+   *
+   * @param read_fd Descriptor frames are received from.
+   * @param write_fd Descriptor frames are sent to; may equal `read_fd`.
+   * @param socket True for a stream socket, false for pipes.
+   * @return True on success, false otherwise.
+   */
+  bool open(int read_fd, int write_fd, bool socket);
+
+  /*!
+   * @brief Waits briefly for in-flight operations, then releases the ring
+   * and buffers. Call before closing the descriptors.
+   */
+  void close();
+
+  /*! @brief Returns the ring descriptor for readiness polling, or -1. */
+  int fd() const { return ring.fd(); }
+
+  /*!
+   * @brief Encodes and submits messages, giving up at `deadline` while the
+   * previous send has not completed.
+   *
+   * A successful return means the frames were submitted; a failed send is
+   * reported by the next call.
+   *
+   * @param msgs Pointer to the first message to send.
+   * @param count The number of messages to send.
+   * @param deadline When to give up waiting for a send buffer.
+   * @param sent Receives the number of messages submitted.
+   * @return IPCStatus::Ok if all were submitted, otherwise the reason
+   * sending stopped.
+   */
+  IPCStatus send(const IPCMessage *msgs, size_t count,
+                 const Deadline &deadline, size_t &sent);
+
+  /*!
+   * @brief Receives the next message, giving up at `deadline`.
+   *
+   * @return IPCStatus::Ok, IPCStatus::Timeout, or IPCStatus::Error at end of
+   * stream or on failure.
+   */
+  IPCStatus receive(IPCMessage &msg, const Deadline &deadline);
+
+  /*!
+   * @brief Receives up to `max` messages that are available without
+   * waiting.
+   *
+   * @return The number of messages received.
+   */
+  size_t receive_ready(IPCMessage *msgs, size_t max);
+
+private:
+  /*! @brief A completed receive not yet consumed by `reader`. */
+  struct Chunk {
+    uint16_t buffer;
+    uint32_t length;
+    uint32_t offset;
+  };
+
+  /*! @brief Submits the receive if none is in flight. */
+  void arm_receive();
+
+  /*! @brief Queues a send of the unsent part of the buffer in flight. */
+  void queue_send();
+
+  /*! @brief Returns provided buffer `id` to the kernel. */
+  void recycle(uint16_t id);
+
+  /*!
+   * @brief Submits pending entries, then processes completions, waiting
+   * for at least one until `deadline`.
+   *
+   * @return IPCStatus::Ok if any completion was processed.
+   */
+  IPCStatus poll_completions(const Deadline &deadline);
+
+  /*! @brief Processes every completion already posted. */
+  size_t reap();
+
+  /*! @brief The io_uring instance. */
+  IoUring ring;
+
+  /*! @brief Descriptors frames are received from and sent to. */
+  int read_fd = -1, write_fd = -1;
+
+  /*! @brief True for a stream socket, false for pipes. */
+  bool socket = false;
+
+  /*! @brief Provided buffer ring registered with the kernel. */
+  io_uring_buf_ring *buffer_ring = nullptr;
+
+  /*! @brief Memory of the provided receive buffers. */
+  char *receive_buffers = nullptr;
+
+  /*! @brief Memory of the two registered send buffers. */
+  char *send_buffers = nullptr;
+
+  /*! @brief Local tail of `buffer_ring`. */
+  uint16_t buffer_tail = 0;
+
+  /*! @brief Completed receives in stream order. */
+  std::deque<Chunk> chunks;
+
+  /*! @brief True while a receive is in flight. */
+  bool receive_armed = false;
+
+  /*! @brief Send buffer the next frames are encoded into. */
+  int next_send_buffer = 0;
+
+  /*! @brief Send buffer in flight. */
+  int send_buffer = 0;
+
+  /*! @brief Bytes of the send buffer in flight already written. */
+  size_t send_offset = 0;
+
+  /*! @brief Bytes of the send buffer in flight not yet written, or 0 if no
+   * send is in flight. */
+  size_t send_remaining = 0;
+
+  /*! @brief Set by `close()` so that no new receive is armed. */
+  bool closing = false;
+
+  /*! @brief Set at end of stream. */
+  bool end_of_stream = false;
+
+  /*! @brief Set when a receive or send failed. */
+  bool failed = false;
+
+  /*! @brief Reassembles frames from the completed receives. */
+  FrameReader reader;
+};
+
+} // namespace ipc
+
+#endif // IPC_URING_STREAM_HPP
@@ -0,0 +1,188 @@
+#include <IoUring.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+int io_uring_setup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                   unsigned flags, const void *arg, size_t arg_size) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, arg, arg_size));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void *arg,
+                      unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T> T *at(void *base, unsigned offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+} // namespace
+
+ipc::IoUring::~IoUring() { close(); }
+
+bool ipc::IoUring::setup(unsigned entries) {
+  close();
+
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CLAMP;
+  ring_fd = io_uring_setup(entries, &params);
+  if (ring_fd < 0) {
+    ring_fd = -1;
+    perror("io_uring_setup");
+    return false;
+  }
+  if (!(params.features & IORING_FEAT_EXT_ARG)) {
+    fprintf(stderr, "io_uring lacks IORING_FEAT_EXT_ARG\n");
+    close();
+    return false;
+  }
+
+  sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  const size_t cq_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap && cq_size > sq_map_size)
+    sq_map_size = cq_size;
+
+  sq_map = mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_map == MAP_FAILED) {
+    sq_map = nullptr;
+    perror("mmap io_uring");
+    close();
+    return false;
+  }
+  void *cq_base = sq_map;
+  if (!single_mmap) {
+    cq_map_size = cq_size;
+    cq_map = mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (cq_map == MAP_FAILED) {
+      cq_map = nullptr;
+      perror("mmap io_uring");
+      close();
+      return false;
+    }
+    cq_base = cq_map;
+  }
+
+  sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqe_map = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (sqe_map == MAP_FAILED) {
+    perror("mmap io_uring");
+    close();
+    return false;
+  }
+  sqes = static_cast<io_uring_sqe *>(sqe_map);
+
+  sq_head = at<unsigned>(sq_map, params.sq_off.head);
+  sq_tail = at<unsigned>(sq_map, params.sq_off.tail);
+  sq_array = at<unsigned>(sq_map, params.sq_off.array);
+  sq_mask = *at<unsigned>(sq_map, params.sq_off.ring_mask);
+  sq_entries = *at<unsigned>(sq_map, params.sq_off.ring_entries);
+  cq_head = at<unsigned>(cq_base, params.cq_off.head);
+  cq_tail = at<unsigned>(cq_base, params.cq_off.tail);
+  cq_mask = *at<unsigned>(cq_base, params.cq_off.ring_mask);
+  cqes = at<io_uring_cqe>(cq_base, params.cq_off.cqes);
+  sqe_tail = sqe_head = *sq_tail;
+  return true;
+}
+
+void ipc::IoUring::close() {
+  if (sqes)
+    munmap(sqes, sqes_size);
+  if (cq_map)
+    munmap(cq_map, cq_map_size);
+  if (sq_map)
+    munmap(sq_map, sq_map_size);
+  if (ring_fd != -1)
+    ::close(ring_fd);
+  sqes = nullptr;
+  cq_map = sq_map = nullptr;
+  ring_fd = -1;
+  sqe_tail = sqe_head = 0;
+}
+
+io_uring_sqe *ipc::IoUring::get_sqe() {
+  const unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+  if (sqe_tail - head >= sq_entries)
+    return nullptr;
+  io_uring_sqe *sqe = &sqes[sqe_tail & sq_mask];
+  memset(sqe, 0, sizeof(*sqe));
+  ++sqe_tail;
+  return sqe;
+}
+
+int ipc::IoUring::submit(unsigned wait_nr, const timespec *timeout) {
+  // Publish the new entries; the array maps ring slots to entries 1:1.
+  for (unsigned i = sqe_head; i != sqe_tail; ++i)
+    sq_array[i & sq_mask] = i & sq_mask;
+  __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+  const unsigned to_submit = sqe_tail - sqe_head;
+
+  unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+  io_uring_getevents_arg arg{};
+  __kernel_timespec ts{};
+  if (timeout) {
+    ts.tv_sec = timeout->tv_sec;
+    ts.tv_nsec = timeout->tv_nsec;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+    flags |= IORING_ENTER_EXT_ARG;
+  }
+  const int submitted =
+      io_uring_enter(ring_fd, to_submit, wait_nr, flags,
+                     timeout ? static_cast<const void *>(&arg) : nullptr,
+                     timeout ? sizeof(arg) : 0);
+  if (submitted < 0)
+    return -errno;
+  sqe_head += static_cast<unsigned>(submitted);
+  return submitted;
+}
+
+io_uring_cqe *ipc::IoUring::peek_cqe() {
+  const unsigned head = *cq_head;
+  if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+    return nullptr;
+  return &cqes[head & cq_mask];
+}
+
+void ipc::IoUring::cqe_seen() {
+  __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+}
+
+bool ipc::IoUring::register_buffers(const iovec *buffers,
+                                    unsigned count) {
+  if (io_uring_register(ring_fd, IORING_REGISTER_BUFFERS, buffers, count) <
+      0) {
+    perror("io_uring_register buffers");
+    return false;
+  }
+  return true;
+}
+
+bool ipc::IoUring::register_buffer_ring(io_uring_buf_ring *ring,
+                                        unsigned entries, uint16_t group) {
+  io_uring_buf_reg reg{};
+  reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+  reg.ring_entries = entries;
+  reg.bgid = group;
+  if (io_uring_register(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+    perror("io_uring_register buffer ring");
+    return false;
+  }
+  return true;
+}
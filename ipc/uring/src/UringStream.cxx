@@ -0,0 +1,344 @@
+#include <UringStream.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace {
+
+/*! @brief user_data values identifying what a completion belongs to. */
+constexpr uint64_t RECEIVE_TAG = 1;
+constexpr uint64_t SEND_TAG = 2;
+constexpr uint64_t CANCEL_TAG = 3;
+
+/*! @brief Provided buffer group of the receive buffers. */
+constexpr uint16_t BUFFER_GROUP = 0;
+
+/*! @brief Size of the provided buffer ring. */
+constexpr size_t BUFFER_RING_SIZE =
+    ipc::UringStream::BUFFER_COUNT * sizeof(io_uring_buf);
+
+/*! @brief Size of the receive buffer memory. */
+constexpr size_t RECEIVE_MEMORY_SIZE =
+    ipc::UringStream::BUFFER_COUNT * ipc::UringStream::BUFFER_SIZE;
+
+/*! @brief Size of the send buffer memory. */
+constexpr size_t SEND_MEMORY_SIZE = 2 * ipc::UringStream::SEND_BUFFER_SIZE;
+
+/*! @brief Maps zeroed, page-aligned private memory. */
+void *map_memory(size_t size) {
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    perror("mmap");
+    return nullptr;
+  }
+  return memory;
+}
+
+} // namespace
+
+ipc::UringStream::~UringStream() { close(); }
+
+bool ipc::UringStream::open(int read_descriptor, int write_descriptor,
+                            bool is_socket) {
+  close();
+  read_fd = read_descriptor;
+  write_fd = write_descriptor;
+  socket = is_socket;
+  closing = end_of_stream = failed = false;
+
+  if (!ring.setup(RING_ENTRIES))
+    return false;
+
+  buffer_ring = static_cast<io_uring_buf_ring *>(map_memory(BUFFER_RING_SIZE));
+  receive_buffers = static_cast<char *>(map_memory(RECEIVE_MEMORY_SIZE));
+  send_buffers = static_cast<char *>(map_memory(SEND_MEMORY_SIZE));
+  if (!buffer_ring || !receive_buffers || !send_buffers ||
+      !ring.register_buffer_ring(buffer_ring, BUFFER_COUNT, BUFFER_GROUP)) {
+    close();
+    return false;
+  }
+  for (unsigned id = 0; id < BUFFER_COUNT; ++id)
+    recycle(static_cast<uint16_t>(id));
+
+  const iovec send_iov[2] = {{send_buffers, SEND_BUFFER_SIZE},
+                             {send_buffers + SEND_BUFFER_SIZE,
+                              SEND_BUFFER_SIZE}};
+  if (!ring.register_buffers(send_iov, 2)) {
+    close();
+    return false;
+  }
+
+  arm_receive();
+  const int submitted = ring.submit();
+  if (submitted < 0) {
+    errno = -submitted;
+    perror("io_uring_enter");
+    close();
+    return false;
+  }
+  return true;
+}
+
+void ipc::UringStream::close() {
+  bool quiet = true;
+  if (ring.fd() != -1) {
+    closing = true;
+    if (receive_armed) {
+      if (io_uring_sqe *sqe = ring.get_sqe()) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = RECEIVE_TAG;
+        sqe->user_data = CANCEL_TAG;
+      }
+    }
+    // The kernel writes into the receive buffers and reads the send
+    // buffers until the operations complete, so wait for them.
+    const Deadline limit(std::chrono::seconds(1));
+    while ((receive_armed || send_remaining > 0) &&
+           poll_completions(limit) == IPCStatus::Ok) {
+    }
+    quiet = !receive_armed && send_remaining == 0;
+    ring.close();
+  }
+
+  // Memory the kernel may still touch is leaked rather than unmapped.
+  if (quiet) {
+    if (buffer_ring)
+      munmap(buffer_ring, BUFFER_RING_SIZE);
+    if (receive_buffers)
+      munmap(receive_buffers, RECEIVE_MEMORY_SIZE);
+    if (send_buffers)
+      munmap(send_buffers, SEND_MEMORY_SIZE);
+  }
+  buffer_ring = nullptr;
+  receive_buffers = send_buffers = nullptr;
+  buffer_tail = 0;
+  chunks.clear();
+  reader.reset();
+  receive_armed = false;
+  next_send_buffer = send_buffer = 0;
+  send_offset = send_remaining = 0;
+}
+
+ipc::IPCStatus ipc::UringStream::send(const IPCMessage *msgs, size_t count,
+                                      const Deadline &deadline, size_t &sent) {
+  sent = 0;
+  if (ring.fd() == -1 || failed)
+    return IPCStatus::Error;
+
+  while (sent < count) {
+    char *buffer = send_buffers + next_send_buffer * SEND_BUFFER_SIZE;
+    size_t length = 0;
+    size_t encoded = 0;
+    while (sent + encoded < count &&
+           length + MAX_FRAME_SIZE <= SEND_BUFFER_SIZE)
+      length += encode_frame(msgs[sent + encoded++], buffer + length);
+
+    // One send at a time keeps the byte stream in order.
+    while (send_remaining > 0) {
+      const IPCStatus status = poll_completions(deadline);
+      if (status != IPCStatus::Ok)
+        return status;
+    }
+    if (failed)
+      return IPCStatus::Error;
+
+    send_buffer = next_send_buffer;
+    send_offset = 0;
+    send_remaining = length;
+    next_send_buffer ^= 1;
+    queue_send();
+    const int submitted = ring.submit();
+    if (submitted < 0 && submitted != -EINTR) {
+      errno = -submitted;
+      perror("io_uring_enter");
+      failed = true;
+      return IPCStatus::Error;
+    }
+    sent += encoded;
+  }
+  return IPCStatus::Ok;
+}
+
+ipc::IPCStatus ipc::UringStream::receive(IPCMessage &msg,
+                                         const Deadline &deadline) {
+  if (ring.fd() == -1)
+    return IPCStatus::Error;
+
+  IPCStatus status = IPCStatus::Ok;
+  const bool received =
+      reader.next(msg, [&](char *buffer, size_t length) -> ssize_t {
+        for (;;) {
+          if (!chunks.empty()) {
+            Chunk &chunk = chunks.front();
+            const size_t copied =
+                std::min<size_t>(length, chunk.length - chunk.offset);
+            memcpy(buffer,
+                   receive_buffers + chunk.buffer * BUFFER_SIZE + chunk.offset,
+                   copied);
+            chunk.offset += static_cast<uint32_t>(copied);
+            if (chunk.offset == chunk.length) {
+              recycle(chunk.buffer);
+              chunks.pop_front();
+            }
+            return static_cast<ssize_t>(copied);
+          }
+          if (end_of_stream || failed) {
+            status = IPCStatus::Error;
+            return 0;
+          }
+          status = poll_completions(deadline);
+          if (status != IPCStatus::Ok)
+            return -1;
+        }
+      });
+  if (received)
+    return IPCStatus::Ok;
+  return status == IPCStatus::Ok ? IPCStatus::Error : status;
+}
+
+size_t ipc::UringStream::receive_ready(IPCMessage *msgs, size_t max) {
+  const Deadline now(std::chrono::nanoseconds::zero());
+  size_t received = 0;
+  while (received < max && receive(msgs[received], now) == IPCStatus::Ok)
+    ++received;
+  return received;
+}
+
+void ipc::UringStream::arm_receive() {
+  if (receive_armed || closing || end_of_stream || failed)
+    return;
+  io_uring_sqe *sqe = ring.get_sqe();
+  if (!sqe)
+    return;
+
+  if (socket) {
+    // One multishot recv keeps completing until the buffers run out.
+    sqe->opcode = IORING_OP_RECV;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+  } else {
+    sqe->opcode = IORING_OP_READ;
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->len = BUFFER_SIZE;
+  }
+  sqe->fd = read_fd;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BUFFER_GROUP;
+  sqe->user_data = RECEIVE_TAG;
+  receive_armed = true;
+}
+
+void ipc::UringStream::queue_send() {
+  io_uring_sqe *sqe = ring.get_sqe();
+  if (!sqe) {
+    failed = true;
+    return;
+  }
+  char *data = send_buffers + send_buffer * SEND_BUFFER_SIZE + send_offset;
+  if (socket) {
+    sqe->opcode = IORING_OP_SEND;
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+  } else {
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->buf_index = static_cast<uint16_t>(send_buffer);
+  }
+  sqe->fd = write_fd;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = static_cast<uint32_t>(send_remaining);
+  sqe->user_data = SEND_TAG;
+}
+
+void ipc::UringStream::recycle(uint16_t id) {
+  // The entries start at the ring itself; `bufs` is misplaced in C++, where
+  // the kernel header's flexible array member gains an empty struct. Fields
+  // are set one by one because the first entry's `resv` is the ring tail.
+  io_uring_buf &entry = reinterpret_cast<io_uring_buf *>(
+      buffer_ring)[buffer_tail & (BUFFER_COUNT - 1)];
+  entry.addr = reinterpret_cast<uint64_t>(receive_buffers + id * BUFFER_SIZE);
+  entry.len = BUFFER_SIZE;
+  entry.bid = id;
+  ++buffer_tail;
+  __atomic_store_n(&buffer_ring->tail, buffer_tail, __ATOMIC_RELEASE);
+}
+
+ipc::IPCStatus ipc::UringStream::poll_completions(const Deadline &deadline) {
+  arm_receive();
+  if (reap() > 0) {
+    if (ring.has_unsubmitted())
+      ring.submit();
+    return IPCStatus::Ok;
+  }
+
+  for (;;) {
+    const bool wait = !deadline.expired();
+    if (!wait && !ring.has_unsubmitted())
+      return reap() > 0 ? IPCStatus::Ok : IPCStatus::Timeout;
+
+    timespec timeout{};
+    if (wait && !deadline.is_never())
+      timeout = deadline.remaining_timespec();
+    const int result =
+        ring.submit(wait ? 1 : 0,
+                    wait && !deadline.is_never() ? &timeout : nullptr);
+    if (result < 0 && result != -ETIME && result != -EINTR &&
+        result != -EBUSY) {
+      errno = -result;
+      perror("io_uring_enter");
+      failed = true;
+      return IPCStatus::Error;
+    }
+    if (reap() > 0) {
+      if (ring.has_unsubmitted())
+        ring.submit();
+      return IPCStatus::Ok;
+    }
+    if (!wait || result == -ETIME)
+      return IPCStatus::Timeout;
+  }
+}
+
+size_t ipc::UringStream::reap() {
+  size_t reaped = 0;
+  while (io_uring_cqe *cqe = ring.peek_cqe()) {
+    const uint64_t tag = cqe->user_data;
+    const int result = cqe->res;
+    const unsigned flags = cqe->flags;
+    ring.cqe_seen();
+    ++reaped;
+
+    if (tag == RECEIVE_TAG) {
+      if (!(flags & IORING_CQE_F_MORE))
+        receive_armed = false;
+      if (result > 0) {
+        chunks.push_back({static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT),
+                          static_cast<uint32_t>(result), 0});
+      } else if (result == 0) {
+        end_of_stream = true;
+      } else if (result != -ENOBUFS && result != -ECANCELED) {
+        // Running out of buffers only stops the receive until the queued
+        // chunks are consumed and it is re-armed.
+        errno = -result;
+        perror("io_uring receive");
+        failed = true;
+      }
+    } else if (tag == SEND_TAG) {
+      if (result <= 0) {
+        errno = result < 0 ? -result : EPIPE;
+        perror("io_uring send");
+        failed = true;
+        send_remaining = 0;
+      } else {
+        send_offset += static_cast<size_t>(result);
+        send_remaining -= static_cast<size_t>(result);
+        if (send_remaining > 0)
+          queue_send();
+      }
+    }
+  }
+  return reaped;
+}
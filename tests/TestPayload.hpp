@@ -0,0 +1,20 @@
+#ifndef IPC_TEST_PAYLOAD_HPP
+#define IPC_TEST_PAYLOAD_HPP
+
+#include <cstddef> // For size_t
+#include <vector>  // For std::vector
+
+/*! @brief Byte expected at `index` of a test payload of `size` bytes. */
+inline char pattern_byte(size_t size, size_t index) {
+  return static_cast<char>((size * 31 + index * 7) & 0xff);
+}
+
+/*! @brief Returns a test payload of `size` bytes, see pattern_byte(). */
+inline std::vector<char> make_payload(size_t size) {
+  std::vector<char> payload(size);
+  for (size_t i = 0; i < size; ++i)
+    payload[i] = pattern_byte(size, i);
+  return payload;
+}
+
+#endif // IPC_TEST_PAYLOAD_HPP
@@ -0,0 +1,172 @@
+#include <IIPCTransport.hpp>
+#include <IPCTransportFactory.hpp>
+#include <PipeTransport.hpp>
+#include <SharedMemoryTransport.hpp>
+#include <TCPSocketTransport.hpp>
+#include <UnixSocketTransport.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <memory>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using TransportMaker = std::function<std::unique_ptr<ipc::IIPCTransport>()>;
+
+/*!
+ * @brief Streams `total` messages from parent to child in batches; the
+ * child checks their order and content and answers with the count.
+ */
+void run_batch_exchange(const TransportMaker &make, const std::string &name) {
+  const uint32_t total = 5000;
+  const size_t batch = 64;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: drain in batches, then report how many arrived. The
+    // parent may not have created a shared memory segment yet.
+    auto transport = make();
+    for (int tries = 0; !transport->initialize(name, false); ++tries) {
+      if (tries == 500)
+        _exit(1);
+      usleep(10 * 1000);
+    }
+
+    std::vector<ipc::IPCMessage> msgs(batch);
+    uint32_t expected = 0;
+    while (expected < total) {
+      const size_t n = transport->receive_batch(msgs.data(), msgs.size());
+      if (n == 0)
+        _exit(2);
+      for (size_t i = 0; i < n; ++i, ++expected)
+        if (msgs[i].counter != expected ||
+            strlen(msgs[i].data) != expected % 32)
+          _exit(3);
+    }
+
+    ipc::IPCMessage done{};
+    done.counter = expected;
+    done.finished = true;
+    _exit(transport->send_message(done) ? 0 : 4);
+  }
+
+  // Parent process: send everything in batches of `batch`
+  auto transport = make();
+  ASSERT_TRUE(transport->initialize(name, true));
+
+  std::vector<ipc::IPCMessage> msgs(total);
+  for (uint32_t i = 0; i < total; ++i) {
+    msgs[i].counter = i;
+    memset(msgs[i].data, 'a' + i % 26, i % 32);
+  }
+  for (uint32_t sent = 0; sent < total; sent += batch) {
+    const size_t n = std::min<size_t>(batch, total - sent);
+    ASSERT_EQ(transport->send_batch(msgs.data() + sent, n), n);
+  }
+
+  ipc::IPCMessage done{};
+  ASSERT_TRUE(transport->receive_message(done));
+  ASSERT_TRUE(done.finished);
+  ASSERT_EQ(done.counter, total);
+  std::cout << "[Parent] Child received " << done.counter
+            << " messages in batches" << std::endl;
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  transport->cleanup();
+}
+
+} // namespace
+
+TEST(IPC_Batch, Pipe) {
+  run_batch_exchange(
+      [] { return IPCTransportFactory::create_transport(IPCType::Pipe); },
+      "test_batch_pipe");
+}
+
+TEST(IPC_Batch, TCPSocket) {
+  run_batch_exchange(
+      [] { return IPCTransportFactory::create_transport(IPCType::Socket); },
+      "127.0.0.1:54322");
+}
+
+TEST(IPC_Batch, UnixSocket) {
+  run_batch_exchange(
+      [] { return IPCTransportFactory::create_transport(IPCType::UnixSocket); },
+      "test_batch_unix");
+}
+
+TEST(IPC_Batch, UnixSocketSkipsBadRecords) {
+  const std::string name = "test_batch_unix_bad";
+  ipc::UnixSocketTransport sender;
+  std::thread peer([&] { ASSERT_TRUE(sender.initialize(name, false)); });
+  ipc::UnixSocketTransport receiver;
+  ASSERT_TRUE(receiver.initialize(name, true));
+  peer.join();
+
+  // Good records around a malformed one and an oversized one
+  ipc::IPCMessage msg{};
+  ASSERT_TRUE(sender.send_message(msg));
+  msg.counter = 1;
+  ASSERT_TRUE(sender.send_message(msg));
+  const int fd = sender.readiness_fd();
+  ASSERT_EQ(send(fd, "junk", 4, 0), 4);
+  msg.counter = 2;
+  ASSERT_TRUE(sender.send_message(msg));
+  std::vector<char> oversized(2 * ipc::MAX_FRAME_SIZE, 'x');
+  ASSERT_EQ(send(fd, oversized.data(), oversized.size(), 0),
+            static_cast<ssize_t>(oversized.size()));
+  msg.counter = 3;
+  ASSERT_TRUE(sender.send_message(msg));
+
+  std::vector<ipc::IPCMessage> msgs(8);
+  ASSERT_EQ(receiver.receive_batch(msgs.data(), msgs.size()), 4u);
+  for (uint32_t i = 0; i < 4; ++i)
+    ASSERT_EQ(msgs[i].counter, i);
+}
+
+TEST(IPC_Batch, UnixStreamSocket) {
+  run_batch_exchange(
+      [] {
+        return std::make_unique<ipc::UnixSocketTransport>(
+            ipc::UnixSocketType::Stream);
+      },
+      "test_batch_unix_stream");
+}
+
+TEST(IPC_Batch, SharedMemoryRing) {
+  run_batch_exchange(
+      [] {
+        return std::make_unique<ipc::SharedMemoryTransport>(
+            ipc::SharedMemoryMode::Ring, 128);
+      },
+      "test_batch_shm_ring");
+}
+
+TEST(IPC_Batch, PipeIoUring) {
+  run_batch_exchange(
+      [] {
+        return std::make_unique<ipc::PipeTransport>(ipc::IOBackend::IoUring);
+      },
+      "test_batch_pipe_uring");
+}
+
+TEST(IPC_Batch, TCPSocketIoUring) {
+  run_batch_exchange(
+      [] {
+        return std::make_unique<ipc::TCPSocketTransport>(
+            ipc::IOBackend::IoUring);
+      },
+      "127.0.0.1:54323");
+}
@@ -0,0 +1,88 @@
+#include <BroadcastTransport.hpp>
+#include <IIPCTransport.hpp>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+TEST(IPC_FanOut, Broadcast) {
+  const std::string channel_name = "test_ipc_broadcast";
+  const uint32_t readers = 3;
+  const uint32_t messages = 2000;
+
+  // The ring holds every message, so replaying readers never get overrun
+  ipc::BroadcastTransport writer(4096);
+  ASSERT_TRUE(writer.initialize(channel_name, true));
+
+  std::vector<pid_t> children;
+  for (uint32_t r = 0; r < readers; ++r) {
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+      // Child process: every reader sees every message, in order
+      ipc::BroadcastTransport reader(0, ipc::WaitStrategy::Futex, true);
+      if (!reader.initialize(channel_name, false))
+        _exit(1);
+
+      ipc::IPCMessage msg{};
+      for (uint32_t i = 0; i < messages; ++i) {
+        if (!reader.receive_message(msg) || msg.counter != i)
+          _exit(2);
+      }
+      _exit(reader.dropped() == 0 ? 0 : 3);
+    }
+    children.push_back(pid);
+  }
+
+  // Parent process: publish without waiting for any reader
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < messages; ++i) {
+    msg.counter = i;
+    snprintf(msg.data, sizeof(msg.data), "Broadcast %u", i);
+    ASSERT_TRUE(writer.send_message(msg));
+  }
+  std::cout << "[Parent] Published " << messages << " messages to " << readers
+            << " readers" << std::endl;
+
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+  writer.cleanup();
+}
+
+TEST(IPC_FanOut, BroadcastOverrun) {
+  const std::string channel_name = "test_ipc_broadcast_overrun";
+
+  ipc::BroadcastTransport writer(8);
+  ASSERT_TRUE(writer.initialize(channel_name, true));
+  ipc::BroadcastTransport reader(0, ipc::WaitStrategy::Spin);
+  ASSERT_TRUE(reader.initialize(channel_name, false));
+
+  // Roles are fixed: the writer cannot receive, the reader cannot send
+  ipc::IPCMessage msg{};
+  EXPECT_FALSE(reader.send_message(msg));
+  EXPECT_FALSE(writer.receive_message(msg));
+
+  // Lap the reader: only the last 8 of 20 messages are still in the ring
+  for (uint32_t i = 0; i < 20; ++i) {
+    msg.counter = i;
+    ASSERT_TRUE(writer.send_message(msg));
+  }
+
+  ASSERT_TRUE(reader.receive_message(msg));
+  EXPECT_EQ(msg.counter, 12u);
+  EXPECT_EQ(reader.dropped(), 12u);
+  for (uint32_t i = 13; i < 20; ++i) {
+    ASSERT_TRUE(reader.receive_message(msg));
+    EXPECT_EQ(msg.counter, i);
+  }
+  EXPECT_EQ(reader.cursor(), 20u);
+
+  reader.cleanup();
+  writer.cleanup();
+}
@@ -0,0 +1,117 @@
+#include <PipeTransport.hpp>
+#include <SendCoalescer.hpp>
+#include <TCPSocketTransport.hpp>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/*!
+ * @brief Checks when a coalescing `sender` writes to `receiver`: not before
+ * a flush, at the byte threshold, at the delay budget, and before the
+ * sender receives.
+ */
+template <typename Transport>
+void run_coalescing(Transport &sender, Transport &receiver) {
+  ipc::IPCMessage msg{};
+  uint32_t next = 0;
+  auto expect_received = [&](uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+      ASSERT_EQ(receiver.receive_for(msg, 1s), ipc::IPCStatus::Ok);
+      ASSERT_EQ(msg.counter, next++);
+    }
+    ASSERT_EQ(receiver.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  };
+  uint32_t counter = 0;
+  auto send = [&] {
+    ipc::IPCMessage out{};
+    out.counter = counter++;
+    memset(out.data, 'x', 100); // 108 bytes per frame
+    ASSERT_TRUE(sender.send_message(out));
+  };
+
+  // Held back until flushed.
+  ipc::CoalescingPolicy policy;
+  policy.max_bytes = 1000;
+  policy.max_delay = std::chrono::hours(1);
+  ASSERT_TRUE(sender.set_coalescing(policy));
+  for (int i = 0; i < 5; ++i)
+    send();
+  ASSERT_EQ(receiver.receive_for(msg, 20ms), ipc::IPCStatus::Timeout);
+  ASSERT_TRUE(sender.flush());
+  expect_received(5);
+
+  // Written as soon as 1000 bytes are pending, i.e. with the tenth message.
+  for (int i = 0; i < 9; ++i)
+    send();
+  ASSERT_EQ(receiver.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  send();
+  expect_received(10);
+
+  // Written once the oldest message has waited out the delay budget, even
+  // if nothing else is sent.
+  policy.max_bytes = 1 << 20;
+  policy.max_delay = 50ms;
+  ASSERT_TRUE(sender.set_coalescing(policy));
+  const auto start = std::chrono::steady_clock::now();
+  send();
+  send();
+  ASSERT_EQ(receiver.receive_for(msg, 5ms), ipc::IPCStatus::Timeout);
+  for (uint32_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(receiver.receive_for(msg, 1s), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, next++);
+  }
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 50ms);
+  send();
+  expect_received(1);
+
+  // Without a delay budget nothing is held back.
+  policy.max_delay = std::chrono::microseconds::zero();
+  ASSERT_TRUE(sender.set_coalescing(policy));
+  send();
+  expect_received(1);
+
+  // Written before the sender waits for an answer.
+  policy.max_delay = std::chrono::hours(1);
+  ASSERT_TRUE(sender.set_coalescing(policy));
+  send();
+  ASSERT_EQ(sender.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  expect_received(1);
+
+  // Disabling coalescing writes every message at once.
+  ASSERT_TRUE(sender.set_coalescing(ipc::CoalescingPolicy{}));
+  send();
+  expect_received(1);
+}
+
+} // namespace
+
+TEST(IPC_Coalescing, Pipe) {
+  ipc::PipeTransport opener;
+  std::thread peer(
+      [&] { ASSERT_TRUE(opener.initialize("test_coalesce", false)); });
+  ipc::PipeTransport creator;
+  ASSERT_TRUE(creator.initialize("test_coalesce", true));
+  peer.join();
+
+  run_coalescing(creator, opener);
+  creator.cleanup();
+  opener.cleanup();
+}
+
+TEST(IPC_Coalescing, TCPSocket) {
+  const std::string addr = "127.0.0.1:54326";
+  ipc::TCPSocketTransport client;
+  std::thread peer([&] { ASSERT_TRUE(client.initialize(addr, false)); });
+  ipc::TCPSocketTransport server;
+  ASSERT_TRUE(server.initialize(addr, true));
+  peer.join();
+
+  run_coalescing(client, server);
+  client.cleanup();
+  server.cleanup();
+}
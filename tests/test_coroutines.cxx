@@ -0,0 +1,150 @@
+#include <AsyncTransport.hpp>
+#include <PipeTransport.hpp>
+#include <Scheduler.hpp>
+#include <SharedMemoryTransport.hpp>
+#include <Task.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+ipc::Task<int> add_later(ipc::Scheduler &scheduler, int a, int b) {
+  co_await scheduler.yield();
+  co_return a + b;
+}
+
+ipc::Task<int> fail_later(ipc::Scheduler &scheduler) {
+  co_await scheduler.yield();
+  throw std::runtime_error("failed");
+}
+
+/*! @brief Answers `rounds` requests with the counter plus one. */
+ipc::Task<> echo(ipc::AsyncTransport &channel, uint32_t rounds) {
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < rounds; ++i) {
+    if (co_await channel.async_receive(msg) != ipc::IPCStatus::Ok)
+      co_return;
+    msg.counter++;
+    if (co_await channel.async_send(msg) != ipc::IPCStatus::Ok)
+      co_return;
+  }
+}
+
+/*! @brief Sends `rounds` requests and counts the correct answers. */
+ipc::Task<> ask(ipc::AsyncTransport &channel, uint32_t rounds,
+                uint32_t &answered) {
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < rounds; ++i) {
+    msg.counter = 2 * i;
+    if (co_await channel.async_send(msg) != ipc::IPCStatus::Ok)
+      co_return;
+    if (co_await channel.async_receive(msg) != ipc::IPCStatus::Ok)
+      co_return;
+    if (msg.counter == 2 * i + 1)
+      ++answered;
+  }
+}
+
+} // namespace
+
+TEST(IPC_Coroutines, NestedTasks) {
+  ipc::Scheduler scheduler;
+  ASSERT_TRUE(scheduler.initialize());
+
+  int sum = 0;
+  bool caught = false;
+  scheduler.spawn([&]() -> ipc::Task<> {
+    sum = co_await add_later(scheduler, 2, 3);
+    try {
+      co_await fail_later(scheduler);
+    } catch (const std::runtime_error &) {
+      caught = true;
+    }
+  }());
+  ASSERT_EQ(scheduler.size(), 1u);
+  ASSERT_TRUE(scheduler.run());
+  ASSERT_EQ(sum, 5);
+  ASSERT_TRUE(caught);
+  ASSERT_EQ(scheduler.size(), 0u);
+}
+
+TEST(IPC_Coroutines, ManyConversationsOneThread) {
+  constexpr int CONVERSATIONS = 32;
+  constexpr uint32_t ROUNDS = 200;
+
+  ipc::Scheduler scheduler;
+  ASSERT_TRUE(scheduler.initialize());
+
+  std::vector<std::unique_ptr<ipc::SharedMemoryTransport>> transports;
+  std::vector<std::unique_ptr<ipc::AsyncTransport>> channels;
+  std::vector<uint32_t> answered(CONVERSATIONS, 0);
+  for (int i = 0; i < CONVERSATIONS; ++i) {
+    const std::string name = "test_ipc_coro_" + std::to_string(i);
+    auto client = std::make_unique<ipc::SharedMemoryTransport>(
+        ipc::SharedMemoryMode::Ring, 16, ipc::WaitStrategy::Spin);
+    ASSERT_TRUE(client->initialize(name, true));
+    auto server = std::make_unique<ipc::SharedMemoryTransport>(
+        ipc::SharedMemoryMode::Ring, 16, ipc::WaitStrategy::Spin);
+    ASSERT_TRUE(server->initialize(name, false));
+
+    channels.push_back(
+        std::make_unique<ipc::AsyncTransport>(scheduler, *client));
+    scheduler.spawn(ask(*channels.back(), ROUNDS, answered[i]));
+    channels.push_back(
+        std::make_unique<ipc::AsyncTransport>(scheduler, *server));
+    scheduler.spawn(echo(*channels.back(), ROUNDS));
+
+    transports.push_back(std::move(client));
+    transports.push_back(std::move(server));
+  }
+
+  ASSERT_TRUE(scheduler.run());
+  for (int i = 0; i < CONVERSATIONS; ++i)
+    ASSERT_EQ(answered[i], ROUNDS);
+}
+
+TEST(IPC_Coroutines, PipeAcrossProcesses) {
+  const std::string ipc_name = "test_ipc_coro_pipe";
+  constexpr uint32_t ROUNDS = 100;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: a plain blocking echo server
+    ipc::PipeTransport transport;
+    if (!transport.initialize(ipc_name, false))
+      _exit(1);
+    ipc::IPCMessage msg{};
+    for (uint32_t i = 0; i < ROUNDS; ++i) {
+      if (!transport.receive_message(msg))
+        _exit(2);
+      msg.counter++;
+      if (!transport.send_message(msg))
+        _exit(3);
+    }
+    _exit(0);
+  }
+
+  ipc::PipeTransport transport;
+  ASSERT_TRUE(transport.initialize(ipc_name, true));
+  ipc::Scheduler scheduler;
+  ASSERT_TRUE(scheduler.initialize());
+  ipc::AsyncTransport channel(scheduler, transport);
+
+  uint32_t answered = 0;
+  scheduler.spawn(ask(channel, ROUNDS, answered));
+  ASSERT_TRUE(scheduler.run());
+  ASSERT_EQ(answered, ROUNDS);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  transport.cleanup();
+}
@@ -0,0 +1,112 @@
+#include <IPCTransportFactory.hpp>
+#include <UDPSocketTransport.hpp>
+#include <WireFormat.hpp>
+#include <arpa/inet.h>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/*! @brief Receives `count` messages in batches and checks their order. */
+void expect_in_order(ipc::IIPCTransport &reader, uint32_t count) {
+  std::vector<ipc::IPCMessage> msgs(32);
+  for (uint32_t next = 0; next < count;) {
+    const size_t n = reader.receive_batch(msgs.data(), msgs.size());
+    ASSERT_GT(n, 0u);
+    for (size_t i = 0; i < n; ++i, ++next)
+      ASSERT_EQ(msgs[i].counter, next);
+  }
+}
+
+} // namespace
+
+TEST(IPC_Datagram, UnicastBatches) {
+  const std::string addr = "127.0.0.1:54330";
+  auto reader = IPCTransportFactory::create_transport(IPCType::Datagram);
+  ASSERT_TRUE(reader->initialize(addr, false));
+  auto writer = IPCTransportFactory::create_transport(IPCType::Datagram);
+  ASSERT_TRUE(writer->initialize(addr, true));
+
+  // Only the writer sends and only the reader receives
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(writer->try_receive(msg), ipc::IPCStatus::Error);
+  ASSERT_FALSE(reader->send_message(msg));
+
+  std::vector<ipc::IPCMessage> msgs(200);
+  for (uint32_t i = 0; i < msgs.size(); ++i) {
+    msgs[i].counter = i;
+    snprintf(msgs[i].data, sizeof(msgs[i].data), "sample %u", i);
+  }
+  ASSERT_EQ(writer->send_batch(msgs.data(), msgs.size()), msgs.size());
+  expect_in_order(*reader, msgs.size());
+  ASSERT_EQ(reader->receive_for(msg, 10ms), ipc::IPCStatus::Timeout);
+
+  auto &udp = static_cast<ipc::UDPSocketTransport &>(*reader);
+  ASSERT_EQ(udp.dropped(), 0u);
+  ASSERT_EQ(udp.reordered(), 0u);
+}
+
+TEST(IPC_Datagram, MulticastFanOut) {
+  const std::string group = "239.255.0.1:54331";
+  std::vector<std::unique_ptr<ipc::UDPSocketTransport>> readers;
+  for (int i = 0; i < 3; ++i) {
+    readers.push_back(std::make_unique<ipc::UDPSocketTransport>());
+    ASSERT_TRUE(readers.back()->set_multicast_interface("127.0.0.1"));
+    ASSERT_TRUE(readers.back()->initialize(group, false));
+  }
+  ipc::UDPSocketTransport writer;
+  ASSERT_TRUE(writer.set_multicast_interface("127.0.0.1"));
+  ASSERT_TRUE(writer.initialize(group, true));
+
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < 50; ++i) {
+    msg.counter = i;
+    ASSERT_TRUE(writer.send_message(msg));
+  }
+  for (auto &reader : readers) {
+    expect_in_order(*reader, 50);
+    ASSERT_EQ(reader->dropped(), 0u);
+  }
+}
+
+TEST(IPC_Datagram, SequenceGaps) {
+  const std::string addr = "127.0.0.1:54332";
+  ipc::UDPSocketTransport reader;
+  ASSERT_TRUE(reader.initialize(addr, false));
+
+  // Hand-made datagrams with the sequence numbers 0, 1, 5, 3 and 6
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  ASSERT_NE(fd, -1);
+  sockaddr_in to{};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(54332);
+  inet_pton(AF_INET, "127.0.0.1", &to.sin_addr);
+  for (uint64_t sequence : {0, 1, 5, 3, 6}) {
+    char datagram[ipc::UDPSocketTransport::MAX_DATAGRAM_SIZE] = {};
+    for (size_t i = 0; i < ipc::UDPSocketTransport::SEQUENCE_SIZE; ++i)
+      datagram[i] = static_cast<char>(sequence >> (8 * i));
+    ipc::IPCMessage msg{};
+    msg.counter = static_cast<uint32_t>(sequence);
+    const size_t prefix = ipc::UDPSocketTransport::SEQUENCE_SIZE;
+    const size_t length = prefix + ipc::encode_frame(msg, datagram + prefix);
+    ASSERT_EQ(sendto(fd, datagram, length, 0, (sockaddr *)&to, sizeof(to)),
+              static_cast<ssize_t>(length));
+  }
+  // A datagram that is not a frame is skipped
+  ASSERT_EQ(sendto(fd, "junk", 4, 0, (sockaddr *)&to, sizeof(to)), 4);
+  close(fd);
+
+  ipc::IPCMessage msg{};
+  for (uint32_t expected : {0, 1, 5, 3, 6}) {
+    ASSERT_EQ(reader.receive_for(msg, 1s), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, expected);
+  }
+  ASSERT_EQ(reader.receive_for(msg, 10ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(reader.dropped(), 3u); // 2, 3 and 4 were missing at 5
+  ASSERT_EQ(reader.reordered(), 1u); // 3 came after all
+}
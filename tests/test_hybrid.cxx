@@ -0,0 +1,145 @@
+#include "TestPayload.hpp"
+#include <HybridTransport.hpp>
+#include <IIPCTransport.hpp>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+TEST(IPC_PingPong, Hybrid) {
+  const std::string name = "test_ipc_hybrid";
+  const size_t sizes[] = {0, 100, 8191, 8192, 100000, 3u << 20};
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: verify each payload in place, reply with its length
+    ipc::HybridTransport childTransport;
+    if (!childTransport.initialize(name, false))
+      _exit(1);
+
+    for (size_t expected : sizes) {
+      size_t size = 0;
+      const char *data =
+          static_cast<const char *>(childTransport.receive_buffer(size));
+      if (!data || size != expected)
+        _exit(2);
+      for (size_t i = 0; i < size; ++i)
+        if (data[i] != pattern_byte(size, i))
+          _exit(3);
+      childTransport.release_buffer(data);
+
+      const uint64_t reply = size;
+      if (!childTransport.send(&reply, sizeof(reply)))
+        _exit(4);
+    }
+
+    // Messages share the stream with the payloads
+    ipc::IPCMessage msg{};
+    if (!childTransport.receive_message(msg))
+      _exit(5);
+    msg.counter++;
+    _exit(childTransport.send_message(msg) ? 0 : 6);
+  }
+
+  // Parent process: send the large payloads through a 16 MiB pool
+  ipc::HybridTransport parentTransport(16u << 20);
+  ASSERT_TRUE(parentTransport.initialize(name, true));
+  ASSERT_GE(parentTransport.max_payload_size(), size_t(3u << 20));
+  ASSERT_EQ(parentTransport.allocate(32u << 20), nullptr);
+  ASSERT_FALSE(parentTransport.send(nullptr, 32u << 20));
+
+  std::vector<char> reply;
+  for (size_t size : sizes) {
+    const std::vector<char> payload = make_payload(size);
+    if (size < (1u << 20)) {
+      ASSERT_TRUE(parentTransport.send(payload.data(), size));
+    } else {
+      // Write the largest payload straight into the pool
+      void *buffer = parentTransport.allocate(size);
+      ASSERT_NE(buffer, nullptr);
+      memcpy(buffer, payload.data(), size);
+      ASSERT_TRUE(parentTransport.send_buffer(buffer, size));
+    }
+
+    ASSERT_TRUE(parentTransport.receive(reply));
+    ASSERT_EQ(reply.size(), sizeof(uint64_t));
+    uint64_t echoed = 0;
+    memcpy(&echoed, reply.data(), sizeof(echoed));
+    ASSERT_EQ(echoed, size);
+    std::cout << "[Parent] Child verified " << size << " bytes" << std::endl;
+  }
+
+  // Only payloads from the inline threshold upward went through the pool
+  ASSERT_EQ(parentTransport.stats().inline_payloads, 3u);
+  ASSERT_EQ(parentTransport.stats().shared_payloads, 3u);
+
+  ipc::IPCMessage msg{};
+  msg.counter = 41;
+  ASSERT_TRUE(parentTransport.send_message(msg));
+  ASSERT_TRUE(parentTransport.receive_message(msg));
+  ASSERT_EQ(msg.counter, 42u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Hybrid, PoolIsRecycled) {
+  const std::string name = "test_ipc_hybrid_recycle";
+  const size_t size = 1u << 20;
+  const uint32_t count = 64;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: release every payload after checking it
+    ipc::HybridTransport childTransport;
+    if (!childTransport.initialize(name, false))
+      _exit(1);
+    const std::vector<char> expected = make_payload(size);
+    std::vector<char> payload;
+    for (uint32_t i = 0; i < count; ++i)
+      if (!childTransport.receive(payload) || payload != expected)
+        _exit(2);
+
+    ipc::IPCMessage done{};
+    done.counter = count;
+    done.finished = true;
+    _exit(childTransport.send_message(done) ? 0 : 3);
+  }
+
+  // Parent process: far more data than the 4 MiB pool holds at once, so
+  // sends wait for the child to return blocks.
+  ipc::HybridTransport parentTransport(4u << 20);
+  ASSERT_TRUE(parentTransport.initialize(name, true));
+  const std::vector<char> payload = make_payload(size);
+  for (uint32_t i = 0; i < count; ++i)
+    ASSERT_TRUE(parentTransport.send(payload.data(), payload.size()));
+  ASSERT_EQ(parentTransport.stats().shared_payloads, count);
+
+  ipc::IPCMessage done{};
+  ASSERT_TRUE(parentTransport.receive_message(done));
+  ASSERT_TRUE(done.finished);
+  ASSERT_EQ(done.counter, count);
+
+  // The released blocks merged back, and a full pool times out
+  ASSERT_NE(parentTransport.allocate(parentTransport.max_payload_size(),
+                                     std::chrono::nanoseconds::zero()),
+            nullptr);
+  ASSERT_EQ(parentTransport.allocate(size, std::chrono::milliseconds(10)),
+            nullptr);
+  ASSERT_FALSE(parentTransport.send(payload.data(), payload.size(),
+                                    std::chrono::milliseconds(10)));
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
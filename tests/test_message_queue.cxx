@@ -90,6 +90,7 @@ TEST(IPC_PingPong, MessageQueue) {
           msg_send.counter = -1;
           transport->send_message(msg_send);
           std::cout << "[Child] Sent: termination" << std::endl;
+          break;
         }
       }
       
@@ -135,13 +136,16 @@ TEST(IPC_PingPong, MessageQueue) {
             msg_send.counter = -1;
             transport->send_message(msg_send);
             std::cout << "[Parent] Sent: termination" << std::endl;
+            break;
           }
         }
       }
     }
 
 
-    // wait(nullptr);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
   }
 
   mq_unlink((QUEUE_BASE_NAME + "_ctp").c_str());
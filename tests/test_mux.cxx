@@ -0,0 +1,220 @@
+#include <Multiplexer.hpp>
+#include <MuxChannel.hpp>
+#include <UnixSocketTransport.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/*! @brief Fills `msg` with `counter` and the channel name as data. */
+ipc::IPCMessage channel_message(uint32_t channel, uint32_t counter) {
+  ipc::IPCMessage msg{};
+  msg.counter = counter;
+  snprintf(msg.data, sizeof(msg.data), "channel %u", channel);
+  return msg;
+}
+
+} // namespace
+
+TEST(IPC_Mux, ChannelsShareOneConnection) {
+  const std::string name = "test_mux_channels";
+  const uint32_t channels = 8;
+  const uint32_t per_channel = 200;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: interleave every channel's messages on the link
+    ipc::UnixSocketTransport link(ipc::UnixSocketType::Stream);
+    if (!link.initialize(name, false))
+      _exit(1);
+    ipc::Multiplexer mux(link);
+    std::vector<std::unique_ptr<ipc::MuxChannel>> open;
+    for (uint32_t id = 1; id <= channels; ++id)
+      open.push_back(mux.open_channel(id));
+    for (uint32_t i = 0; i < per_channel; ++i)
+      for (auto &channel : open)
+        if (!channel->send_message(channel_message(channel->get_id(), i)))
+          _exit(2);
+
+    // The channel ID travels outside the data, so all of it is usable
+    ipc::IPCMessage full{};
+    memset(full.data, 'z', sizeof(full.data));
+    if (!open[0]->send_message(full))
+      _exit(3);
+
+    auto control = mux.open_channel(0);
+    ipc::IPCMessage done{};
+    if (!control->receive_message(done) || !done.finished)
+      _exit(5);
+    _exit(0);
+  }
+
+  // Parent process: drain the channels in reverse order, so the messages
+  // of the others have to wait in their queues.
+  ipc::UnixSocketTransport link(ipc::UnixSocketType::Stream);
+  ASSERT_TRUE(link.initialize(name, true));
+  ipc::Multiplexer mux(link);
+  std::vector<std::unique_ptr<ipc::MuxChannel>> open;
+  for (uint32_t id = 1; id <= channels; ++id)
+    open.push_back(mux.open_channel(id));
+  ASSERT_EQ(mux.open_channel(1), nullptr);
+  ASSERT_EQ(mux.channel_count(), channels);
+
+  std::vector<ipc::IPCMessage> msgs(32);
+  for (uint32_t id = channels; id >= 1; --id) {
+    ipc::MuxChannel &channel = *open[id - 1];
+    const ipc::IPCMessage expected = channel_message(id, 0);
+    for (uint32_t next = 0; next < per_channel;) {
+      const size_t n = channel.receive_batch(
+          msgs.data(), std::min<size_t>(msgs.size(), per_channel - next));
+      ASSERT_GT(n, 0u);
+      for (size_t i = 0; i < n; ++i, ++next) {
+        ASSERT_EQ(msgs[i].counter, next);
+        ASSERT_STREQ(msgs[i].data, expected.data);
+      }
+    }
+  }
+
+  ipc::IPCMessage full{};
+  ASSERT_TRUE(open[0]->receive_message(full));
+  ASSERT_EQ(full.channel, 1u);
+  ASSERT_EQ(std::count(full.data, full.data + sizeof(full.data), 'z'),
+            static_cast<long>(sizeof(full.data)));
+  ASSERT_EQ(open[0]->receive_for(full, 10ms), ipc::IPCStatus::Timeout);
+
+  // A closed channel fails and its ID can be opened again
+  open[1]->cleanup();
+  ASSERT_FALSE(open[1]->send_message(full));
+  ASSERT_NE(mux.open_channel(2), nullptr);
+
+  auto control = mux.open_channel(0);
+  ipc::IPCMessage done{};
+  done.finished = true;
+  ASSERT_TRUE(control->send_message(done));
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  // Once the peer is gone every channel fails
+  ASSERT_FALSE(open[0]->receive_message(full));
+  ASSERT_TRUE(mux.failed());
+}
+
+TEST(IPC_Mux, ConcurrentReceivers) {
+  const std::string name = "test_mux_concurrent";
+  const uint32_t per_channel = 2000;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: alternate two channels, one of them in batches
+    ipc::UnixSocketTransport link(ipc::UnixSocketType::Stream);
+    if (!link.initialize(name, false))
+      _exit(1);
+    ipc::Multiplexer mux(link);
+    auto first = mux.open_channel(1);
+    auto second = mux.open_channel(2);
+    std::vector<ipc::IPCMessage> batch(100);
+    for (uint32_t i = 0; i < per_channel; i += batch.size()) {
+      for (uint32_t j = 0; j < batch.size(); ++j) {
+        if (!first->send_message(channel_message(1, i + j)))
+          _exit(2);
+        batch[j] = channel_message(2, i + j);
+      }
+      if (second->send_batch(batch.data(), batch.size()) != batch.size())
+        _exit(3);
+    }
+    ipc::IPCMessage done{};
+    _exit(first->receive_message(done) && done.finished ? 0 : 4);
+  }
+
+  // Parent process: one thread per channel, each waiting for its own
+  ipc::UnixSocketTransport link(ipc::UnixSocketType::Stream);
+  ASSERT_TRUE(link.initialize(name, true));
+  ipc::Multiplexer mux(link);
+  auto first = mux.open_channel(1);
+  auto second = mux.open_channel(2);
+
+  auto drain = [per_channel](ipc::MuxChannel &channel, uint32_t &received) {
+    const ipc::IPCMessage expected = channel_message(channel.get_id(), 0);
+    ipc::IPCMessage msg{};
+    while (received < per_channel &&
+           channel.receive_for(msg, 5s) == ipc::IPCStatus::Ok &&
+           msg.counter == received && strcmp(msg.data, expected.data) == 0)
+      ++received;
+  };
+  uint32_t first_received = 0;
+  uint32_t second_received = 0;
+  std::thread first_thread(drain, std::ref(*first), std::ref(first_received));
+  std::thread second_thread(drain, std::ref(*second),
+                            std::ref(second_received));
+  first_thread.join();
+  second_thread.join();
+  ASSERT_EQ(first_received, per_channel);
+  ASSERT_EQ(second_received, per_channel);
+
+  ipc::IPCMessage done{};
+  done.finished = true;
+  ASSERT_TRUE(first->send_message(done));
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Mux, FullChannelHoldsBackTheLink) {
+  const std::string name = "test_mux_backpressure";
+  ipc::UnixSocketTransport opener(ipc::UnixSocketType::Stream);
+  std::thread peer([&] { ASSERT_TRUE(opener.initialize(name, false)); });
+  ipc::UnixSocketTransport creator(ipc::UnixSocketType::Stream);
+  ASSERT_TRUE(creator.initialize(name, true));
+  peer.join();
+
+  // The receiver has no channel 3 and holds at most 10 messages per channel
+  ipc::Multiplexer sender(opener);
+  ipc::Multiplexer receiver(creator, 10);
+  std::vector<std::unique_ptr<ipc::MuxChannel>> out;
+  for (uint32_t id = 1; id <= 3; ++id)
+    out.push_back(sender.open_channel(id));
+  auto first = receiver.open_channel(1);
+  auto second = receiver.open_channel(2);
+
+  for (uint32_t i = 0; i < 5; ++i)
+    ASSERT_TRUE(out[2]->send_message(channel_message(3, i)));
+  for (uint32_t i = 0; i < 20; ++i)
+    ASSERT_TRUE(out[1]->send_message(channel_message(2, i)));
+  ASSERT_TRUE(out[0]->send_message(channel_message(1, 0)));
+
+  // Channel 3's messages are dropped, but channel 2 fills up after ten and
+  // holds back the rest, including channel 1's message behind them
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(first->receive_for(msg, 100ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(receiver.stats().unopened_drops, 5u);
+  ASSERT_EQ(receiver.stats().backpressure_stalls, 1u);
+
+  // Draining channel 2 lets everything through, nothing lost or reordered
+  for (uint32_t i = 0; i < 20; ++i) {
+    ASSERT_EQ(second->receive_for(msg, 1s), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, i);
+    ASSERT_EQ(msg.channel, 2u);
+  }
+  ASSERT_EQ(second->receive_for(msg, 10ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(first->receive_for(msg, 1s), ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 0u);
+}
@@ -1,9 +1,12 @@
+#include "TestPayload.hpp"
 #include <IIPCTransport.hpp>
 #include <IPCTransportFactory.hpp>
 #include <PipeTransport.hpp>
 #include <gtest/gtest.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <vector>
 
 using namespace std;
 
@@ -70,3 +73,81 @@ TEST(IPC_PingPong, Pipe) {
     ASSERT_EQ(WEXITSTATUS(status), 0);
   }
 }
+
+TEST(IPC_Pipe, GiftAndSplicePayloads) {
+  const std::string ipc_name = "test_pipe_splice";
+  const size_t small = 1000;
+  const size_t large = 4u << 20;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1) << "fork failed";
+
+  if (pid == 0) {
+    // Child process: copy the small payload, splice the large one to a file
+    ipc::PipeTransport transport;
+    transport.set_pipe_size(1u << 20);
+    if (!transport.initialize(ipc_name, false))
+      _exit(1);
+    if (transport.pipe_capacity() < (1u << 20))
+      _exit(2);
+
+    std::vector<char> payload;
+    if (!transport.receive(payload) || payload.size() != small)
+      _exit(3);
+    for (size_t i = 0; i < small; ++i)
+      if (payload[i] != pattern_byte(small, i))
+        _exit(4);
+
+    FILE *file = tmpfile();
+    uint64_t size = 0;
+    if (!file || !transport.receive_to_fd(fileno(file), size) ||
+        size != large)
+      _exit(5);
+    payload.resize(large);
+    if (pread(fileno(file), payload.data(), large, 0) !=
+        static_cast<ssize_t>(large))
+      _exit(6);
+    for (size_t i = 0; i < large; ++i)
+      if (payload[i] != pattern_byte(large, i))
+        _exit(7);
+    fclose(file);
+
+    // Messages share the stream with the payloads
+    ipc::IPCMessage msg{};
+    if (!transport.receive_message(msg))
+      _exit(8);
+    msg.counter++;
+    _exit(transport.send_message(msg) ? 0 : 9);
+  }
+
+  // Parent process: grow the pipe once open, then gift the large payload
+  ipc::PipeTransport transport;
+  ASSERT_TRUE(transport.initialize(ipc_name, true));
+  ASSERT_GT(transport.pipe_capacity(), 0u);
+  ASSERT_TRUE(transport.set_pipe_size(1u << 20));
+  ASSERT_GE(transport.pipe_capacity(), size_t(1u << 20));
+
+  std::vector<char> payload(small);
+  for (size_t i = 0; i < small; ++i)
+    payload[i] = pattern_byte(small, i);
+  ASSERT_TRUE(transport.send(payload.data(), payload.size()));
+
+  void *pages = mmap(nullptr, large, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(pages, MAP_FAILED);
+  for (size_t i = 0; i < large; ++i)
+    static_cast<char *>(pages)[i] = pattern_byte(large, i);
+  ASSERT_TRUE(transport.send_gift(pages, large));
+  munmap(pages, large);
+
+  ipc::IPCMessage msg{};
+  msg.counter = 41;
+  ASSERT_TRUE(transport.send_message(msg));
+  ASSERT_TRUE(transport.receive_message(msg));
+  ASSERT_EQ(msg.counter, 42u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
@@ -0,0 +1,200 @@
+#include <IPCTransportFactory.hpp>
+#include <Reactor.hpp>
+#include <SharedMemoryTransport.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sys/wait.h>
+#include <unistd.h>
+
+TEST(IPC_Reactor, SharedMemoryRings) {
+  constexpr int CHANNELS = 4;
+  constexpr uint32_t MESSAGES = 3000;
+  std::unique_ptr<ipc::SharedMemoryTransport> senders[CHANNELS];
+  std::unique_ptr<ipc::SharedMemoryTransport> receivers[CHANNELS];
+  for (int i = 0; i < CHANNELS; ++i) {
+    const std::string name = "test_ipc_reactor_" + std::to_string(i);
+    senders[i] = std::make_unique<ipc::SharedMemoryTransport>(
+        ipc::SharedMemoryMode::Ring, 4096);
+    ASSERT_TRUE(senders[i]->initialize(name, true));
+    receivers[i] = std::make_unique<ipc::SharedMemoryTransport>(
+        ipc::SharedMemoryMode::Ring, 4096);
+    ASSERT_TRUE(receivers[i]->initialize(name, false));
+  }
+
+  ipc::Reactor reactor;
+  ASSERT_TRUE(reactor.initialize());
+
+  // Each channel must deliver its messages in order
+  uint32_t next[CHANNELS] = {};
+  size_t largest_batch = 0;
+  for (int i = 0; i < CHANNELS; ++i) {
+    ASSERT_TRUE(reactor.add(*receivers[i], [&, i](ipc::IIPCTransport &,
+                                                   const ipc::IPCMessage *msgs,
+                                                   size_t count) {
+      ASSERT_GT(count, 0u);
+      largest_batch = std::max(largest_batch, count);
+      for (size_t m = 0; m < count; ++m)
+        ASSERT_EQ(msgs[m].counter, next[i]++);
+    }));
+  }
+  ASSERT_FALSE(reactor.add(*receivers[0], nullptr));
+  ASSERT_EQ(reactor.size(), static_cast<size_t>(CHANNELS));
+
+  // Nothing queued yet: the first round drains every channel and arms them
+  ASSERT_EQ(reactor.run_once(0), 0);
+
+  ipc::IPCMessage msg{};
+  for (uint32_t m = 0; m < MESSAGES; ++m) {
+    msg.counter = m;
+    for (int i = 0; i < CHANNELS; ++i)
+      ASSERT_TRUE(senders[i]->send_message(msg));
+  }
+
+  long total = 0;
+  while (total < static_cast<long>(CHANNELS * MESSAGES)) {
+    const long dispatched = reactor.run_once(1000);
+    ASSERT_GT(dispatched, 0);
+    total += dispatched;
+  }
+  for (int i = 0; i < CHANNELS; ++i)
+    ASSERT_EQ(next[i], MESSAGES);
+  ASSERT_EQ(largest_batch, ipc::Reactor::BATCH_SIZE);
+  ASSERT_EQ(reactor.run_once(0), 0);
+
+  ASSERT_TRUE(reactor.remove(*receivers[1]));
+  ASSERT_FALSE(reactor.remove(*receivers[1]));
+  ASSERT_TRUE(senders[1]->send_message(msg));
+  ASSERT_EQ(reactor.run_once(0), 0);
+}
+
+namespace {
+
+/*! @brief A transport that offers no readiness descriptor. */
+class UnpollableTransport : public ipc::SharedMemoryTransport {
+public:
+  int readiness_fd() override { return -1; }
+};
+
+} // namespace
+
+TEST(IPC_Reactor, FactorySharedMemory) {
+  const std::string ipc_name = "test_ipc_reactor_factory";
+  constexpr uint32_t MESSAGES = 200;
+
+  auto transport = IPCTransportFactory::create_transport(IPCType::SharedMemory);
+  ASSERT_TRUE(transport->initialize(ipc_name, true));
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: hand messages through the single slot
+    auto sender = IPCTransportFactory::create_transport(IPCType::SharedMemory);
+    if (!sender->initialize(ipc_name, false))
+      _exit(1);
+    ipc::IPCMessage msg{};
+    for (uint32_t m = 0; m < MESSAGES; ++m) {
+      msg.counter = m;
+      if (!sender->send_message(msg))
+        _exit(2);
+    }
+    _exit(0);
+  }
+
+  ipc::Reactor reactor;
+  ASSERT_TRUE(reactor.initialize());
+  uint32_t received = 0;
+  ASSERT_TRUE(reactor.add(*transport, [&](ipc::IIPCTransport &,
+                                          const ipc::IPCMessage *msgs,
+                                          size_t count) {
+    for (size_t m = 0; m < count; ++m)
+      ASSERT_EQ(msgs[m].counter, received++);
+  }));
+  while (received < MESSAGES)
+    ASSERT_GE(reactor.run_once(5000), 0);
+  ASSERT_EQ(received, MESSAGES);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Reactor, TransportWithoutDescriptor) {
+  const std::string ipc_name = "test_ipc_reactor_polled";
+  ipc::SharedMemoryTransport sender;
+  ASSERT_TRUE(sender.initialize(ipc_name, true));
+  UnpollableTransport receiver;
+  ASSERT_TRUE(receiver.initialize(ipc_name, false));
+
+  ipc::Reactor reactor;
+  ASSERT_TRUE(reactor.initialize());
+  uint32_t received = 0;
+  ASSERT_TRUE(reactor.add(receiver, [&](ipc::IIPCTransport &,
+                                        const ipc::IPCMessage *msgs,
+                                        size_t count) {
+    received += static_cast<uint32_t>(count);
+    ASSERT_EQ(msgs[0].counter, 9u);
+  }));
+
+  // Polled: an indefinite wait still returns to try the transport
+  ASSERT_EQ(reactor.run_once(-1), 0);
+  ipc::IPCMessage msg{};
+  msg.counter = 9;
+  ASSERT_TRUE(sender.send_message(msg));
+  ASSERT_EQ(reactor.run_once(-1), 1);
+  ASSERT_EQ(received, 1u);
+  ASSERT_TRUE(reactor.remove(receiver));
+  ASSERT_EQ(reactor.size(), 0u);
+}
+
+TEST(IPC_Reactor, PipePeerExit) {
+  const std::string ipc_name = "test_ipc_reactor_pipe";
+  constexpr uint32_t MESSAGES = 500;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: send a stream of messages, then hang up
+    auto transport = IPCTransportFactory::create_transport(IPCType::Pipe);
+    if (!transport->initialize(ipc_name, false))
+      _exit(1);
+    ipc::IPCMessage msg{};
+    for (uint32_t m = 0; m < MESSAGES; ++m) {
+      msg.counter = m;
+      if (!transport->send_message(msg))
+        _exit(2);
+    }
+    transport->cleanup();
+    _exit(0);
+  }
+
+  auto transport = IPCTransportFactory::create_transport(IPCType::Pipe);
+  ASSERT_TRUE(transport->initialize(ipc_name, true));
+
+  ipc::Reactor reactor;
+  ASSERT_TRUE(reactor.initialize());
+  uint32_t received = 0;
+  bool closed = false;
+  ASSERT_TRUE(reactor.add(*transport, [&](ipc::IIPCTransport &,
+                                          const ipc::IPCMessage *msgs,
+                                          size_t count) {
+    if (count == 0) {
+      closed = true;
+      reactor.stop();
+    }
+    for (size_t m = 0; m < count; ++m)
+      ASSERT_EQ(msgs[m].counter, received++);
+  }));
+  ASSERT_TRUE(reactor.run());
+  ASSERT_TRUE(closed);
+  ASSERT_EQ(received, MESSAGES);
+  ASSERT_EQ(reactor.size(), 0u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  transport->cleanup();
+}
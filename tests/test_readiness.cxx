@@ -0,0 +1,317 @@
+#include <BroadcastTransport.hpp>
+#include <Doorbell.hpp>
+#include <IIPCTransport.hpp>
+#include <PipeTransport.hpp>
+#include <SharedMemoryTransport.hpp>
+#include <ShmArenaTransport.hpp>
+#include <ShmQueueTransport.hpp>
+#include <SnapshotTransport.hpp>
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/*! @brief Returns true if `fd` polls readable within `timeout_ms`. */
+bool readable(int fd, int timeout_ms) {
+  pollfd pfd{fd, POLLIN, 0};
+  return poll(&pfd, 1, timeout_ms) == 1 && (pfd.revents & POLLIN);
+}
+
+} // namespace
+
+TEST(IPC_Readiness, SharedMemoryRing) {
+  const std::string ring_name = "test_ipc_readiness_ring";
+  ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 8);
+  ASSERT_TRUE(creator.initialize(ring_name, true));
+  ipc::SharedMemoryTransport opener(ipc::SharedMemoryMode::Ring, 8);
+  ASSERT_TRUE(opener.initialize(ring_name, false));
+
+  // The doorbell FIFO only appears once a consumer asks for it
+  const std::string path = ipc::Doorbell::path_for(ring_name, 0);
+  ASSERT_NE(access(path.c_str(), F_OK), 0);
+  const int fd = opener.readiness_fd();
+  ASSERT_NE(fd, -1);
+  ASSERT_EQ(access(path.c_str(), F_OK), 0);
+
+  // An empty receive arms the doorbell; the next send rings it once
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_FALSE(readable(fd, 0));
+  for (uint32_t i = 0; i < 3; ++i) {
+    msg.counter = i;
+    ASSERT_TRUE(creator.send_message(msg));
+  }
+  ASSERT_TRUE(readable(fd, 0));
+  ASSERT_NE(access(path.c_str(), F_OK), 0); // unlinked once both opened it
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, i);
+  }
+  ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_FALSE(readable(fd, 0));
+
+  // Without an empty receive in between the producer does not ring again
+  ASSERT_TRUE(creator.send_message(msg));
+  ASSERT_TRUE(creator.send_message(msg));
+  ASSERT_TRUE(readable(fd, 0));
+  ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::Ok);
+}
+
+TEST(IPC_Readiness, SharedMemoryRingAcrossProcesses) {
+  const std::string ring_name = "test_ipc_readiness_fork";
+  ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 8);
+  ASSERT_TRUE(creator.initialize(ring_name, true));
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: send after the parent has started polling
+    ipc::SharedMemoryTransport transport(ipc::SharedMemoryMode::Ring, 8);
+    if (!transport.initialize(ring_name, false))
+      _exit(1);
+    usleep(20 * 1000);
+    ipc::IPCMessage msg{};
+    msg.counter = 42;
+    _exit(transport.send_message(msg) ? 0 : 2);
+  }
+
+  const int fd = creator.readiness_fd();
+  ASSERT_NE(fd, -1);
+  ipc::IPCMessage msg{};
+  while (creator.try_receive(msg) == ipc::IPCStatus::WouldBlock)
+    ASSERT_TRUE(readable(fd, 5000));
+  ASSERT_EQ(msg.counter, 42u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Readiness, SharedMemoryRingMemfd) {
+  const std::string ring_name = "test_ipc_readiness_memfd";
+  ipc::ShmSegmentOptions options;
+  options.memfd = true;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: send after the parent has started polling
+    ipc::SharedMemoryTransport transport(ipc::SharedMemoryMode::Ring, 8);
+    transport.set_segment_options(options);
+    if (!transport.initialize(ring_name, false))
+      _exit(1);
+    usleep(20 * 1000);
+    ipc::IPCMessage msg{};
+    msg.counter = 42;
+    _exit(transport.send_message(msg) ? 0 : 2);
+  }
+
+  // The doorbells are eventfds passed with the segment, not FIFOs
+  ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 8);
+  creator.set_segment_options(options);
+  ASSERT_TRUE(creator.initialize(ring_name, true));
+  const int fd = creator.readiness_fd();
+  ASSERT_NE(fd, -1);
+  for (int index = 0; index < 2; ++index)
+    ASSERT_NE(access(ipc::Doorbell::path_for(ring_name, index).c_str(), F_OK),
+              0);
+
+  ipc::IPCMessage msg{};
+  while (creator.try_receive(msg) == ipc::IPCStatus::WouldBlock)
+    ASSERT_TRUE(readable(fd, 5000));
+  ASSERT_EQ(msg.counter, 42u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Readiness, SharedMemorySingleSlot) {
+  const std::string slot_name = "test_ipc_readiness_slot";
+  ipc::SharedMemoryTransport creator;
+  ASSERT_TRUE(creator.initialize(slot_name, true));
+  ipc::SharedMemoryTransport opener;
+  ASSERT_TRUE(opener.initialize(slot_name, false));
+
+  const int fd = opener.readiness_fd();
+  ASSERT_NE(fd, -1);
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+    ASSERT_FALSE(readable(fd, 0));
+    msg.counter = i;
+    ASSERT_TRUE(creator.send_message(msg));
+    ASSERT_TRUE(readable(fd, 0));
+    ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, i);
+  }
+}
+
+TEST(IPC_Readiness, ShmArena) {
+  const std::string arena_name = "test_ipc_readiness_arena";
+  ipc::ShmArenaTransport creator(1 << 16, 8);
+  ASSERT_TRUE(creator.initialize(arena_name, true));
+  ipc::ShmArenaTransport opener;
+  ASSERT_TRUE(opener.initialize(arena_name, false));
+
+  const int fd = opener.readiness_fd();
+  ASSERT_NE(fd, -1);
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_FALSE(readable(fd, 0));
+  ASSERT_TRUE(creator.send("ping", 4));
+  ASSERT_TRUE(readable(fd, 0));
+  std::vector<char> payload;
+  ASSERT_TRUE(opener.receive(payload));
+  ASSERT_EQ(std::string(payload.begin(), payload.end()), "ping");
+}
+
+TEST(IPC_Readiness, ShmQueueRingsEveryConsumer) {
+  const std::string queue_name = "test_ipc_readiness_queue";
+  ipc::ShmQueueTransport producer(8);
+  ASSERT_TRUE(producer.initialize(queue_name, true));
+  ipc::ShmQueueTransport first, second;
+  ASSERT_TRUE(first.initialize(queue_name, false));
+  ASSERT_TRUE(second.initialize(queue_name, false));
+
+  const int first_fd = first.readiness_fd();
+  const int second_fd = second.readiness_fd();
+  ASSERT_NE(first_fd, -1);
+  ASSERT_NE(second_fd, -1);
+  ASSERT_NE(first_fd, second_fd);
+
+  // Only armed consumers are rung
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(first.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_TRUE(producer.send_message(msg));
+  ASSERT_TRUE(readable(first_fd, 0));
+  ASSERT_FALSE(readable(second_fd, 0));
+  ASSERT_EQ(second.try_receive(msg), ipc::IPCStatus::Ok);
+
+  // Both armed: one message wakes both, and the loser finds nothing
+  ASSERT_EQ(first.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_EQ(second.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_FALSE(readable(first_fd, 0));
+  ASSERT_TRUE(producer.send_message(msg));
+  ASSERT_TRUE(readable(first_fd, 0));
+  ASSERT_TRUE(readable(second_fd, 0));
+  ASSERT_EQ(first.try_receive(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(second.try_receive(msg), ipc::IPCStatus::WouldBlock);
+}
+
+TEST(IPC_Readiness, BroadcastAcrossProcesses) {
+  const std::string channel_name = "test_ipc_readiness_broadcast";
+  ipc::BroadcastTransport writer(16);
+  ASSERT_TRUE(writer.initialize(channel_name, true));
+  ASSERT_EQ(writer.readiness_fd(), -1);
+
+  int ready[2];
+  ASSERT_EQ(pipe(ready), 0);
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: a reader in an event loop
+    ipc::BroadcastTransport reader;
+    if (!reader.initialize(channel_name, false))
+      _exit(1);
+    const int fd = reader.readiness_fd();
+    if (fd == -1)
+      _exit(2);
+    ipc::IPCMessage msg{};
+    if (reader.try_receive(msg) != ipc::IPCStatus::WouldBlock)
+      _exit(3);
+    ssize_t ignored = write(ready[1], "r", 1);
+    (void)ignored;
+    if (!readable(fd, 5000))
+      _exit(4);
+    _exit(reader.try_receive(msg) == ipc::IPCStatus::Ok && msg.counter == 7
+              ? 0
+              : 5);
+  }
+
+  char byte;
+  ASSERT_EQ(read(ready[0], &byte, 1), 1);
+  ipc::IPCMessage msg{};
+  msg.counter = 7;
+  ASSERT_TRUE(writer.send_message(msg));
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  close(ready[0]);
+  close(ready[1]);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_Readiness, Snapshot) {
+  const std::string snapshot_name = "test_ipc_readiness_snapshot";
+  ipc::SnapshotTransport writer;
+  ASSERT_TRUE(writer.initialize(snapshot_name, true));
+  ipc::SnapshotTransport reader;
+  ASSERT_TRUE(reader.initialize(snapshot_name, false));
+
+  const int fd = reader.readiness_fd();
+  ASSERT_NE(fd, -1);
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(reader.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  msg.counter = 3;
+  ASSERT_TRUE(writer.send_message(msg));
+  ASSERT_TRUE(readable(fd, 0));
+  ASSERT_EQ(reader.try_receive(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 3u);
+  ASSERT_EQ(reader.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_FALSE(readable(fd, 0));
+}
+
+TEST(IPC_Readiness, Pipe) {
+  const std::string ipc_name = "test_ipc_readiness_pipe";
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: echo each message back after a delay
+    ipc::PipeTransport transport;
+    if (!transport.initialize(ipc_name, false))
+      _exit(1);
+    ipc::IPCMessage msg{};
+    for (int i = 0; i < 2; ++i) {
+      if (!transport.receive_message(msg))
+        _exit(2);
+      usleep(20 * 1000);
+      msg.counter++;
+      if (!transport.send_message(msg))
+        _exit(3);
+    }
+    _exit(0);
+  }
+
+  ipc::PipeTransport transport;
+  ASSERT_TRUE(transport.initialize(ipc_name, true));
+  const int fd = transport.readiness_fd();
+  ASSERT_NE(fd, -1);
+
+  ipc::IPCMessage msg{};
+  for (uint32_t round = 0; round < 2; ++round) {
+    msg.counter = 10 * round;
+    ASSERT_TRUE(transport.send_message(msg));
+    ASSERT_EQ(transport.try_receive(msg), ipc::IPCStatus::WouldBlock);
+    ASSERT_TRUE(readable(fd, 5000));
+    ASSERT_EQ(transport.try_receive(msg), ipc::IPCStatus::Ok);
+    ASSERT_EQ(msg.counter, 10 * round + 1);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  transport.cleanup();
+}
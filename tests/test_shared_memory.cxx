@@ -1,6 +1,10 @@
+#include <FdPassing.hpp>
 #include <IIPCTransport.hpp>
 #include <IPCTransportFactory.hpp>
+#include <NumaPlacement.hpp>
 #include <SharedMemoryTransport.hpp>
+#include <SignalTransport.hpp>
+#include <cstring>
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <semaphore.h>
@@ -99,4 +103,432 @@ TEST(IPC_PingPong, SharedMemory) {
     sem_unlink(SEM_PARENT);
     sem_unlink(SEM_CHILD);
   }
-}
\ No newline at end of file
+}
+
+TEST(IPC_PingPong, SharedMemoryRing) {
+  const std::string ring_name = "/test_ipc_shm_ring";
+  const uint32_t burst = 500;
+
+  ipc::SharedMemoryTransport parentTransport(ipc::SharedMemoryMode::Ring, 1024);
+  ASSERT_TRUE(parentTransport.initialize(ring_name, true));
+  ASSERT_EQ(parentTransport.get_shared_message(), nullptr);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: echo every message back with the counter incremented
+    ipc::SharedMemoryTransport childTransport(ipc::SharedMemoryMode::Ring);
+    if (!childTransport.initialize(ring_name, false))
+      _exit(1);
+
+    ipc::IPCMessage msg{};
+    for (uint32_t i = 0; i < burst; ++i) {
+      if (!childTransport.receive_message(msg) || msg.counter != i)
+        _exit(2);
+      msg.counter++;
+      snprintf(msg.data, sizeof(msg.data), "Child sent %u", msg.counter);
+      childTransport.send_message(msg);
+    }
+
+    childTransport.cleanup();
+    _exit(0);
+  } else {
+    // Parent process: run ahead of the child, then collect the replies
+    ipc::IPCMessage msg{};
+    for (uint32_t i = 0; i < burst; ++i) {
+      msg.counter = i;
+      snprintf(msg.data, sizeof(msg.data), "Parent sent %u", msg.counter);
+      ASSERT_TRUE(parentTransport.send_message(msg));
+    }
+    std::cout << "[Parent] Sent burst of " << burst << std::endl;
+
+    for (uint32_t i = 0; i < burst; ++i) {
+      ASSERT_TRUE(parentTransport.receive_message(msg));
+      ASSERT_EQ(msg.counter, i + 1);
+    }
+    std::cout << "[Parent] Received: " << msg.data << std::endl;
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    parentTransport.cleanup();
+  }
+}
+
+TEST(IPC_PingPong, SharedMemoryRingWaitStrategies) {
+  using ipc::WaitStrategy;
+  const std::pair<WaitStrategy, WaitStrategy> pairs[] = {
+      {WaitStrategy::Spin, WaitStrategy::Spin},
+      {WaitStrategy::Yield, WaitStrategy::Yield},
+      {WaitStrategy::Futex, WaitStrategy::Futex},
+      {WaitStrategy::CondVar, WaitStrategy::CondVar},
+      {WaitStrategy::Futex, WaitStrategy::CondVar},
+      {WaitStrategy::Spin, WaitStrategy::Futex},
+  };
+  const std::string ring_name = "/test_ipc_shm_ring_wait";
+  const uint32_t rounds = 100;
+
+  for (const auto &pair : pairs) {
+    ipc::SharedMemoryTransport parentTransport(ipc::SharedMemoryMode::Ring, 16,
+                                               pair.first);
+    ASSERT_TRUE(parentTransport.initialize(ring_name, true));
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+      // Child process: echo with the counter incremented
+      ipc::SharedMemoryTransport childTransport(ipc::SharedMemoryMode::Ring,
+                                                16, pair.second);
+      if (!childTransport.initialize(ring_name, false))
+        _exit(1);
+
+      ipc::IPCMessage msg{};
+      for (uint32_t i = 0; i < rounds; ++i) {
+        childTransport.receive_message(msg);
+        msg.counter++;
+        childTransport.send_message(msg);
+      }
+      _exit(0);
+    }
+
+    // Parent process: strict ping-pong so the peer has to park every round
+    ipc::IPCMessage msg{};
+    msg.counter = 0;
+    for (uint32_t i = 0; i < rounds; ++i) {
+      ASSERT_TRUE(parentTransport.send_message(msg));
+      ASSERT_TRUE(parentTransport.receive_message(msg));
+      ASSERT_EQ(msg.counter, i + 1);
+    }
+    std::cout << "[Parent] Strategies " << static_cast<int>(pair.first) << "/"
+              << static_cast<int>(pair.second) << " completed " << rounds
+              << " rounds" << std::endl;
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+TEST(IPC_PingPong, SharedMemoryRingLoan) {
+  const std::string ring_name = "/test_ipc_shm_ring_loan";
+  const uint32_t rounds = 10;
+
+  ipc::SharedMemoryTransport parentTransport(ipc::SharedMemoryMode::Ring, 8);
+  ASSERT_TRUE(parentTransport.initialize(ring_name, true));
+
+  // Misuse is reported instead of corrupting the ring
+  ASSERT_FALSE(parentTransport.commit());
+  ASSERT_FALSE(parentTransport.release());
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: read in place, reply by building in place
+    ipc::SharedMemoryTransport childTransport(ipc::SharedMemoryMode::Ring);
+    if (!childTransport.initialize(ring_name, false))
+      _exit(1);
+
+    for (uint32_t i = 0; i < rounds; ++i) {
+      const ipc::IPCMessage *in = childTransport.acquire();
+      if (!in || in->counter != i)
+        _exit(2);
+      const uint32_t next = in->counter + 1;
+      childTransport.release();
+
+      ipc::IPCMessage *out = childTransport.loan();
+      if (!out)
+        _exit(3);
+      out->counter = next;
+      snprintf(out->data, sizeof(out->data), "Child sent %u", next);
+      childTransport.commit();
+    }
+    _exit(0);
+  } else {
+    // Parent process
+    for (uint32_t i = 0; i < rounds; ++i) {
+      ipc::IPCMessage *out = parentTransport.loan();
+      ASSERT_NE(out, nullptr);
+      ASSERT_EQ(parentTransport.loan(), nullptr) << "second loan must fail";
+      out->counter = i;
+      snprintf(out->data, sizeof(out->data), "Parent sent %u", i);
+      ASSERT_TRUE(parentTransport.commit());
+
+      const ipc::IPCMessage *in = parentTransport.acquire();
+      ASSERT_NE(in, nullptr);
+      ASSERT_EQ(in->counter, i + 1);
+      std::cout << "[Parent] Received in place: " << in->data << std::endl;
+      ASSERT_TRUE(parentTransport.release());
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    // Timed loans and acquires give up instead of waiting forever
+    ASSERT_EQ(parentTransport.acquire_for(std::chrono::milliseconds(10)),
+              nullptr);
+    ASSERT_FALSE(parentTransport.release());
+    uint32_t loaned = 0;
+    while (parentTransport.loan_for(std::chrono::nanoseconds::zero())) {
+      ASSERT_TRUE(parentTransport.commit());
+      ++loaned;
+    }
+    ASSERT_EQ(loaned, 8u);
+    ASSERT_EQ(parentTransport.loan_for(std::chrono::milliseconds(10)), nullptr);
+    ASSERT_FALSE(parentTransport.commit());
+  }
+}
+
+TEST(IPC_SegmentOptions, QueueCapacity) {
+  static_assert(ipc::round_up_pow2(0) == 2, "minimum capacity");
+  static_assert(ipc::round_up_pow2(1000) == 1024, "rounded up");
+  static_assert(ipc::round_up_pow2(ipc::MAX_QUEUE_CAPACITY) ==
+                    ipc::MAX_QUEUE_CAPACITY,
+                "largest capacity");
+  static_assert(ipc::round_up_pow2(ipc::MAX_QUEUE_CAPACITY + 1) == 0,
+                "too large");
+
+  // A capacity that has no power of two in range is rejected up front
+  ipc::SharedMemoryTransport ring(ipc::SharedMemoryMode::Ring,
+                                  ipc::MAX_QUEUE_CAPACITY + 1);
+  ASSERT_FALSE(ring.initialize("test_ipc_shm_ring_capacity", true));
+}
+
+TEST(IPC_SegmentOptions, SharedMemoryRing) {
+  const std::string ring_name = "/test_ipc_shm_ring_options";
+
+  ipc::ShmSegmentOptions options;
+  options.huge_pages = true;
+  options.prefault = true;
+  options.lock = true;
+
+  ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 64);
+  creator.set_segment_options(options);
+  ASSERT_TRUE(creator.initialize(ring_name, true));
+
+  // Options are best effort; the report says what the kernel granted
+  const ipc::ShmSegmentReport &report = creator.segment_report();
+  ASSERT_GT(report.page_size, 0u);
+  ASSERT_GE(report.size, sizeof(ipc::SharedRingHeader) +
+                             2 * ipc::MessageRing::bytes_for(64));
+  ASSERT_EQ(report.size % report.page_size, 0u);
+  EXPECT_TRUE(!report.locked || report.prefaulted);
+  std::cout << "[Creator] huge_pages=" << report.huge_pages
+            << " prefaulted=" << report.prefaulted
+            << " locked=" << report.locked << " page_size=" << report.page_size
+            << std::endl;
+
+  // The opener finds the segment wherever the creator put it
+  ipc::ShmSegmentOptions thp;
+  thp.transparent_huge_pages = true;
+  thp.prefault = true;
+  ipc::SharedMemoryTransport opener(ipc::SharedMemoryMode::Ring);
+  opener.set_segment_options(thp);
+  ASSERT_TRUE(opener.initialize(ring_name, false));
+  ASSERT_EQ(opener.segment_report().huge_pages, report.huge_pages);
+  ASSERT_EQ(opener.segment_report().size, report.size);
+
+  ipc::IPCMessage msg{};
+  msg.counter = 7;
+  ASSERT_TRUE(creator.send_message(msg));
+  ASSERT_TRUE(opener.receive_message(msg));
+  ASSERT_EQ(msg.counter, 7u);
+}
+
+TEST(IPC_SegmentOptions, HugePagesFallBack) {
+  // Without reserved huge pages both backings fall back to ordinary pages
+  const size_t sys_page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  for (bool memfd : {false, true}) {
+    ipc::ShmSegmentOptions options;
+    options.huge_pages = true;
+    options.memfd = memfd;
+    ipc::ShmSegment segment;
+    segment.set_options(options);
+    ASSERT_TRUE(segment.create("test_ipc_shm_huge_fallback", 4096));
+    const ipc::ShmSegmentReport &report = segment.report();
+    ASSERT_EQ(report.page_size > sys_page, report.huge_pages);
+    memset(segment.data(), 1, segment.size());
+  }
+}
+
+TEST(IPC_SegmentOptions, StaleSegment) {
+  const std::string ring_name = "test_ipc_shm_ring_stale";
+
+  // Leftover contents are discarded when the segment is created again
+  ipc::ShmSegment stale;
+  ASSERT_TRUE(stale.create(ring_name, 4096));
+  memset(stale.data(), 0x5a, stale.size());
+  ipc::ShmSegment fresh;
+  ASSERT_TRUE(fresh.create(ring_name, 4096));
+  const char *bytes = static_cast<const char *>(fresh.data());
+  ASSERT_EQ(bytes[0], 0);
+  ASSERT_EQ(bytes[fresh.size() - 1], 0);
+
+  // A large enough but uninitialized segment is not mistaken for a ring
+  ipc::SharedMemoryTransport opener(ipc::SharedMemoryMode::Ring);
+  ASSERT_FALSE(opener.initialize(ring_name, false));
+}
+
+TEST(IPC_SegmentOptions, NumaNode) {
+  const std::string ring_name = "test_ipc_shm_ring_numa";
+  const int node = ipc::numa_nodes().back();
+
+  ipc::ShmSegmentOptions options;
+  options.numa_node = node;
+  options.prefault = true;
+
+  ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 64);
+  creator.set_segment_options(options);
+  ASSERT_TRUE(creator.initialize(ring_name, true));
+
+  // Binding may be refused (e.g. by a sandbox); when granted it must hold
+  const ipc::ShmSegmentReport &report = creator.segment_report();
+  std::cout << "[Creator] numa_bound=" << report.numa_bound
+            << " numa_node=" << report.numa_node << std::endl;
+  if (report.numa_bound) {
+    ASSERT_TRUE(report.prefaulted);
+    ASSERT_EQ(report.numa_node, node);
+  }
+
+  ipc::IPCMessage msg{};
+  msg.counter = 11;
+  ASSERT_TRUE(creator.send_message(msg));
+
+  // Consume next to the segment in a child, so that its CPU affinity and
+  // memory policy never leak into the test process
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    if (!ipc::bind_thread_to_node(node) || ipc::current_numa_node() != node)
+      _exit(1);
+    ipc::SharedMemoryTransport opener(ipc::SharedMemoryMode::Ring);
+    if (!opener.initialize(ring_name, false) ||
+        opener.segment_report().numa_node != report.numa_node)
+      _exit(2);
+    ipc::IPCMessage received{};
+    _exit(opener.receive_message(received) && received.counter == 11 ? 0 : 3);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_SegmentOptions, MemfdPublishTimeout) {
+  ipc::ShmSegmentOptions options;
+  options.memfd = true;
+  options.rendezvous_timeout_ms = 50;
+  ipc::ShmSegment segment;
+  segment.set_options(options);
+  ASSERT_TRUE(segment.create("test_ipc_shm_memfd_alone", 4096));
+
+  // Nobody opens the segment, so publishing gives up
+  const auto start = std::chrono::steady_clock::now();
+  ASSERT_FALSE(segment.publish());
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_GE(elapsed, std::chrono::milliseconds(50));
+  ASSERT_LT(elapsed, std::chrono::seconds(5));
+}
+
+TEST(IPC_SegmentOptions, AbstractNameTooLong) {
+  // A rendezvous name that does not fit is refused rather than truncated
+  sockaddr_un address{};
+  socklen_t length = 0;
+  const std::string longest(sizeof(address.sun_path) - 1, 'n');
+  ASSERT_TRUE(ipc::make_abstract_address(longest, address, length));
+  ASSERT_EQ(length, sizeof(address));
+  ASSERT_FALSE(ipc::make_abstract_address(longest + "n", address, length));
+  ASSERT_FALSE(ipc::make_abstract_address("", address, length));
+  ASSERT_EQ(ipc::listen_abstract(longest + "n"), -1);
+  ASSERT_EQ(ipc::connect_abstract(longest + "n", 0), -1);
+}
+
+TEST(IPC_SegmentOptions, SignalTransportMemfd) {
+  const std::string segment_name = "test_ipc_signal_memfd";
+  ipc::ShmSegmentOptions options;
+  options.memfd = true;
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: receives the segment from the creator's initialize
+    ipc::SignalTransport client;
+    client.set_segment_options(options);
+    if (!client.initialize(segment_name, false))
+      _exit(1);
+    _exit(client.segment_report().memfd ? 0 : 2);
+  }
+
+  ipc::SignalTransport server;
+  server.set_segment_options(options);
+  ASSERT_TRUE(server.initialize(segment_name, true));
+  ASSERT_TRUE(server.segment_report().memfd);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(IPC_PingPong, SharedMemoryMemfd) {
+  const std::string ring_name = "test_ipc_shm_memfd";
+  const uint32_t rounds = 10;
+
+  ipc::ShmSegmentOptions options;
+  options.memfd = true;
+
+  // The creator blocks until the opener has the descriptor, so fork first
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: receive the memfd, then echo with counter incremented
+    ipc::SharedMemoryTransport childTransport(ipc::SharedMemoryMode::Ring);
+    childTransport.set_segment_options(options);
+    if (!childTransport.initialize(ring_name, false))
+      _exit(1);
+    if (!childTransport.segment_report().memfd ||
+        !childTransport.segment_report().sealed)
+      _exit(2);
+
+    ipc::IPCMessage msg{};
+    for (uint32_t i = 0; i < rounds; ++i) {
+      childTransport.receive_message(msg);
+      msg.counter++;
+      childTransport.send_message(msg);
+    }
+    _exit(0);
+  } else {
+    // Parent process
+    ipc::SharedMemoryTransport parentTransport(ipc::SharedMemoryMode::Ring, 8);
+    parentTransport.set_segment_options(options);
+    ASSERT_TRUE(parentTransport.initialize(ring_name, true));
+    ASSERT_TRUE(parentTransport.segment_report().memfd);
+
+    // Nothing was created in the /dev/shm namespace
+    ASSERT_EQ(access(("/dev/shm/" + ring_name).c_str(), F_OK), -1);
+
+    ipc::IPCMessage msg{};
+    msg.counter = 0;
+    for (uint32_t i = 0; i < rounds; ++i) {
+      ASSERT_TRUE(parentTransport.send_message(msg));
+      ASSERT_TRUE(parentTransport.receive_message(msg));
+      ASSERT_EQ(msg.counter, i + 1);
+    }
+    std::cout << "[Parent] memfd ring completed " << rounds << " rounds"
+              << std::endl;
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
@@ -0,0 +1,155 @@
+#include "TestPayload.hpp"
+#include <IIPCTransport.hpp>
+#include <IPCTransportFactory.hpp>
+#include <ShmArenaTransport.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <new>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+TEST(IPC_PingPong, SharedMemoryArena) {
+  const std::string arena_name = "test_ipc_shm_arena";
+  const size_t sizes[] = {16, 300, 4096, 100000, 3u << 20};
+
+  ipc::ShmArenaTransport parentTransport(16u << 20, 64);
+  ASSERT_TRUE(parentTransport.initialize(arena_name, true));
+  ASSERT_GE(parentTransport.max_payload_size(), size_t(3u << 20));
+  ASSERT_EQ(parentTransport.allocate(32u << 20), nullptr);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: verify each payload in place, reply with its length
+    ipc::ShmArenaTransport childTransport;
+    if (!childTransport.initialize(arena_name, false))
+      _exit(1);
+
+    for (size_t expected : sizes) {
+      size_t size = 0;
+      const char *data =
+          static_cast<const char *>(childTransport.receive_buffer(size));
+      if (!data || size != expected)
+        _exit(2);
+      for (size_t i = 0; i < size; ++i)
+        if (data[i] != pattern_byte(size, i))
+          _exit(3);
+      childTransport.release_buffer(data);
+
+      uint64_t reply = size;
+      childTransport.send(&reply, sizeof(reply));
+    }
+
+    // The fixed-size API still works on top of the arena
+    ipc::IPCMessage msg{};
+    childTransport.receive_message(msg);
+    msg.counter++;
+    childTransport.send_message(msg);
+    _exit(0);
+  } else {
+    // Parent process: build each payload directly in the arena
+    std::vector<char> reply;
+    for (size_t size : sizes) {
+      char *buffer = static_cast<char *>(parentTransport.allocate(size));
+      ASSERT_NE(buffer, nullptr);
+      for (size_t i = 0; i < size; ++i)
+        buffer[i] = pattern_byte(size, i);
+      ASSERT_TRUE(parentTransport.send_buffer(buffer, size));
+
+      ASSERT_TRUE(parentTransport.receive(reply));
+      ASSERT_EQ(reply.size(), sizeof(uint64_t));
+      uint64_t echoed = 0;
+      memcpy(&echoed, reply.data(), sizeof(echoed));
+      ASSERT_EQ(echoed, size);
+      std::cout << "[Parent] Child verified " << size << " bytes" << std::endl;
+    }
+
+    ipc::IPCMessage msg{};
+    msg.counter = 41;
+    ASSERT_TRUE(parentTransport.send_message(msg));
+    ASSERT_TRUE(parentTransport.receive_message(msg));
+    ASSERT_EQ(msg.counter, 42u);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+TEST(IPC_ShmArena, FreedBlocksMerge) {
+  // Fill a pool that is not a power of two with the smallest blocks
+  const size_t pool_size = (1u << 20) + (64u << 10) + 64;
+  void *memory = std::aligned_alloc(ipc::CACHE_LINE_SIZE,
+                                    ipc::ShmArena::bytes_for(pool_size));
+  ASSERT_NE(memory, nullptr);
+  auto *arena = new (memory) ipc::ShmArena;
+  arena->init(pool_size);
+
+  std::vector<uint64_t> blocks;
+  for (uint64_t offset = arena->allocate(1); offset != ipc::ShmArena::NPOS;
+       offset = arena->allocate(1))
+    blocks.push_back(offset);
+  ASSERT_EQ(blocks.size(), pool_size >> ipc::ShmArena::MIN_BLOCK_SHIFT);
+  ASSERT_EQ(arena->allocate(4096), ipc::ShmArena::NPOS);
+
+  // Once they are all back, the whole largest block is available again
+  for (uint64_t offset : blocks)
+    arena->deallocate(offset);
+  const size_t largest = (1u << 20) - ipc::ShmArena::BLOCK_HEADER_SIZE;
+  const uint64_t large = arena->allocate(largest);
+  ASSERT_NE(large, ipc::ShmArena::NPOS);
+  ASSERT_EQ(arena->capacity_of(large), largest);
+  ASSERT_EQ(arena->allocate(largest), ipc::ShmArena::NPOS);
+  const uint64_t medium = arena->allocate(60000);
+  ASSERT_NE(medium, ipc::ShmArena::NPOS);
+  arena->deallocate(large);
+  arena->deallocate(medium);
+  std::free(memory);
+
+  // An exhausted transport arena gives up once the timeout expires
+  ipc::ShmArenaTransport transport(64u << 10, 64);
+  ASSERT_TRUE(transport.initialize("test_ipc_shm_arena_merge", true));
+  while (transport.allocate(100, std::chrono::nanoseconds::zero()))
+    ;
+  ASSERT_EQ(transport.allocate(transport.max_payload_size(),
+                               std::chrono::milliseconds(10)),
+            nullptr);
+}
+
+TEST(IPC_ShmArena, HolderDies) {
+  const size_t pool_size = 64u << 10;
+  ipc::ShmSegment segment;
+  ASSERT_TRUE(segment.create("test_ipc_shm_arena_robust",
+                             ipc::ShmArena::bytes_for(pool_size)));
+  auto *arena = new (segment.data()) ipc::ShmArena;
+  arena->init(pool_size);
+
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: die holding the lock, halfway through a list update
+    if (arena->allocate(1) == ipc::ShmArena::NPOS)
+      _exit(1);
+    pthread_mutex_lock(&arena->lock);
+    for (auto &head : arena->free_lists)
+      head = 0;
+    _exit(0);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  // The next caller repairs the lists; only the child's block is gone
+  size_t blocks = 0;
+  while (arena->allocate(1) != ipc::ShmArena::NPOS)
+    ++blocks;
+  ASSERT_EQ(blocks, (pool_size >> ipc::ShmArena::MIN_BLOCK_SHIFT) - 1);
+}
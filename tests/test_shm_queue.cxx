@@ -0,0 +1,63 @@
+#include <IIPCTransport.hpp>
+#include <IPCTransportFactory.hpp>
+#include <ShmQueueTransport.hpp>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+TEST(IPC_FanIn, SharedMemoryQueue) {
+  const std::string queue_name = "test_ipc_shm_queue";
+  const uint32_t producers = 4;
+  const uint32_t per_producer = 2000;
+
+  // A small queue forces producers to wait for the consumer
+  ipc::ShmQueueTransport consumer(256);
+  ASSERT_TRUE(consumer.initialize(queue_name, true));
+
+  std::vector<pid_t> children;
+  for (uint32_t p = 0; p < producers; ++p) {
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+      // Child process: attach by name through the factory and produce
+      auto producer =
+          IPCTransportFactory::create_transport(IPCType::SharedMemoryQueue);
+      if (!producer->initialize(queue_name, false))
+        _exit(1);
+
+      ipc::IPCMessage msg{};
+      for (uint32_t i = 0; i < per_producer; ++i) {
+        msg.counter = p * per_producer + i;
+        snprintf(msg.data, sizeof(msg.data), "Producer %u", p);
+        if (!producer->send_message(msg))
+          _exit(2);
+      }
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+
+  // Parent process: every message arrives once, in order per producer
+  std::vector<uint32_t> next(producers, 0);
+  ipc::IPCMessage msg{};
+  for (uint32_t n = 0; n < producers * per_producer; ++n) {
+    ASSERT_TRUE(consumer.receive_message(msg));
+    const uint32_t p = msg.counter / per_producer;
+    ASSERT_LT(p, producers);
+    ASSERT_EQ(msg.counter % per_producer, next[p]);
+    ++next[p];
+  }
+  std::cout << "[Parent] Received " << producers * per_producer
+            << " messages from " << producers << " producers" << std::endl;
+
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+  consumer.cleanup();
+}
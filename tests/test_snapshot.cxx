@@ -0,0 +1,83 @@
+#include <IIPCTransport.hpp>
+#include <IPCTransportFactory.hpp>
+#include <SnapshotTransport.hpp>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/*! @brief Returns true if every data byte matches the message counter. */
+bool is_consistent(const ipc::IPCMessage &msg) {
+  for (char byte : msg.data)
+    if (byte != static_cast<char>(msg.counter))
+      return false;
+  return true;
+}
+
+} // namespace
+
+TEST(IPC_Latest, Snapshot) {
+  const std::string channel_name = "test_ipc_snapshot";
+  const uint32_t readers = 3;
+  const uint32_t updates = 20000;
+
+  ipc::SnapshotTransport writer;
+  ASSERT_TRUE(writer.initialize(channel_name, true));
+
+  std::vector<pid_t> children;
+  for (uint32_t r = 0; r < readers; ++r) {
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+      // Child process: values are never torn and never go backwards
+      auto reader = IPCTransportFactory::create_transport(IPCType::Snapshot);
+      if (!reader->initialize(channel_name, false))
+        _exit(1);
+
+      ipc::IPCMessage msg{};
+      uint32_t last = 0;
+      do {
+        if (!reader->receive_message(msg))
+          _exit(2);
+        if (!is_consistent(msg) || msg.counter < last)
+          _exit(3);
+        last = msg.counter;
+      } while (!msg.finished);
+      _exit(last == updates ? 0 : 4);
+    }
+    children.push_back(pid);
+  }
+
+  // Parent process: overwrite the value without waiting for readers
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 1; i <= updates; ++i) {
+    msg.counter = i;
+    msg.finished = i == updates;
+    memset(msg.data, static_cast<char>(i), sizeof(msg.data));
+    ASSERT_TRUE(writer.send_message(msg));
+  }
+  std::cout << "[Parent] Published " << updates << " updates" << std::endl;
+
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  // A late reader sees only the newest value
+  ipc::SnapshotTransport late;
+  ASSERT_TRUE(late.initialize(channel_name, false));
+  ASSERT_TRUE(late.read_latest(msg));
+  EXPECT_EQ(msg.counter, updates);
+  EXPECT_EQ(late.version(), updates);
+  EXPECT_FALSE(late.send_message(msg));
+
+  late.cleanup();
+  writer.cleanup();
+}
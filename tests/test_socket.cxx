@@ -1,8 +1,17 @@
+#include "TestPayload.hpp"
 #include <IIPCTransport.hpp>
 #include <IPCTransportFactory.hpp>
+#include <TCPServerTransport.hpp>
 #include <TCPSocketTransport.hpp>
+#include <UnixSocketTransport.hpp>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -58,3 +67,285 @@ TEST(IPC_PingPong, TCPSocket) {
     ASSERT_TRUE(WIFEXITED(status)) << "Child did not exit normally";
   }
 }
+
+TEST(IPC_PingPong, UnixSocket) {
+  const std::string name = "test_ipc_unix_socket";
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0) << "fork failed";
+
+  if (pid == 0) {
+    // Child process - client
+    ipc::UnixSocketTransport client;
+    if (!client.initialize(name, false))
+      _exit(1);
+
+    ucred cred{};
+    if (!client.peer_credentials(cred) || cred.pid != getppid())
+      _exit(2);
+
+    ipc::IPCMessage msg{};
+    for (int i = 0; i < 5; ++i) {
+      if (!client.receive_message(msg))
+        _exit(3);
+      msg.counter++;
+      if (!client.send_message(msg))
+        _exit(4);
+    }
+    _exit(0);
+  }
+
+  // Parent process - server
+  ipc::UnixSocketTransport server;
+  ASSERT_TRUE(server.initialize(name, true));
+
+  ucred cred{};
+  ASSERT_TRUE(server.peer_credentials(cred));
+  ASSERT_EQ(cred.pid, pid);
+  ASSERT_EQ(cred.uid, getuid());
+
+  ipc::IPCMessage msg{};
+  for (int i = 0; i < 5; ++i) {
+    msg.counter += 1;
+    ASSERT_TRUE(server.send_message(msg));
+    ASSERT_TRUE(server.receive_message(msg));
+  }
+  ASSERT_EQ(msg.counter, 10u);
+
+  // The peer has exited: the next receive reports it instead of blocking.
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  ASSERT_FALSE(server.receive_message(msg));
+  server.cleanup();
+}
+
+namespace {
+
+/*!
+ * @brief Connects to `addr`, sends `count` messages and, if `replies` is
+ * set, expects each back incremented followed by a finishing broadcast.
+ * Runs in a forked child; the exit code reports the first failure.
+ */
+[[noreturn]] void run_tcp_client(const std::string &addr, uint32_t count,
+                                 bool replies) {
+  ipc::TCPSocketTransport client;
+  if (!client.initialize(addr, false))
+    _exit(1);
+
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < count; ++i) {
+    msg.counter = i;
+    snprintf(msg.data, sizeof(msg.data), "pid %d", static_cast<int>(getpid()));
+    if (!client.send_message(msg))
+      _exit(2);
+  }
+  if (!replies)
+    _exit(0);
+
+  for (uint32_t i = 0; i < count; ++i)
+    if (!client.receive_message(msg) || msg.counter != i + 1)
+      _exit(3);
+  if (!client.receive_message(msg) || !msg.finished)
+    _exit(4);
+  _exit(0);
+}
+
+} // namespace
+
+TEST(IPC_TCPServer, ManyClients) {
+  const std::string addr = "127.0.0.1:54324";
+  constexpr int CLIENTS = 8;
+  constexpr uint32_t MESSAGES = 50;
+
+  ipc::TCPServerTransport server;
+  ASSERT_TRUE(server.initialize(addr, true));
+  ASSERT_EQ(server.get_port(), 54324);
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < CLIENTS; ++i) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0) << "fork failed";
+    if (pid == 0)
+      run_tcp_client(addr, MESSAGES, true);
+    pids.push_back(pid);
+  }
+
+  // Every client's messages arrive in order; answer each one directly.
+  std::map<ipc::TCPServerTransport::ClientId, uint32_t> expected;
+  ipc::IPCMessage msg{};
+  for (uint32_t i = 0; i < CLIENTS * MESSAGES; ++i) {
+    ASSERT_TRUE(server.receive_message(msg));
+    const auto sender = server.last_sender();
+    ASSERT_NE(sender, ipc::TCPServerTransport::NO_CLIENT);
+    ASSERT_EQ(msg.counter, expected[sender]++);
+    msg.counter++;
+    ASSERT_TRUE(server.send_message(msg));
+  }
+  ASSERT_EQ(expected.size(), static_cast<size_t>(CLIENTS));
+  ASSERT_EQ(server.client_count(), static_cast<size_t>(CLIENTS));
+
+  ipc::IPCMessage done{};
+  done.finished = true;
+  ASSERT_EQ(server.broadcast(done), static_cast<size_t>(CLIENTS));
+
+  for (pid_t pid : pids) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  // The departed clients are noticed and dropped.
+  ASSERT_EQ(server.receive_for(msg, std::chrono::milliseconds(100)),
+            ipc::IPCStatus::Timeout);
+  ASSERT_EQ(server.client_count(), 0u);
+  server.cleanup();
+}
+
+TEST(IPC_TCPServer, ReusePortShards) {
+  const std::string addr = "127.0.0.1:54325";
+  constexpr int SHARDS = 2;
+  constexpr int CLIENTS = 8;
+  constexpr uint32_t MESSAGES = 20;
+
+  std::vector<std::unique_ptr<ipc::TCPServerTransport>> shards;
+  for (int i = 0; i < SHARDS; ++i) {
+    shards.push_back(std::make_unique<ipc::TCPServerTransport>(true));
+    ASSERT_TRUE(shards.back()->initialize(addr, true));
+  }
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < CLIENTS; ++i) {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0) << "fork failed";
+    if (pid == 0)
+      run_tcp_client(addr, MESSAGES, false);
+    pids.push_back(pid);
+  }
+
+  // Each shard collects on its own thread until all messages are in.
+  std::atomic<uint32_t> total{0};
+  std::vector<std::thread> threads;
+  for (auto &shard : shards)
+    threads.emplace_back([&total, &shard] {
+      ipc::IPCMessage msg{};
+      for (int idle = 0; total.load() < CLIENTS * MESSAGES && idle < 100;) {
+        if (shard->receive_for(msg, std::chrono::milliseconds(50)) ==
+            ipc::IPCStatus::Ok)
+          total++;
+        else
+          idle++;
+      }
+    });
+  for (auto &thread : threads)
+    thread.join();
+  ASSERT_EQ(total.load(), CLIENTS * MESSAGES);
+
+  for (pid_t pid : pids) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+  }
+}
+
+TEST(IPC_TCPServer, SlowClientIsDropped) {
+  ipc::TCPServerTransport server;
+  ASSERT_TRUE(server.initialize("127.0.0.1:0", true));
+  const std::string addr = "127.0.0.1:" + std::to_string(server.get_port());
+
+  // A client that never reads
+  ipc::TCPSocketTransport slow;
+  ASSERT_TRUE(slow.initialize(addr, false));
+  ipc::IPCMessage msg{};
+  ASSERT_TRUE(slow.send_message(msg));
+  ASSERT_EQ(server.receive_for(msg, std::chrono::seconds(1)),
+            ipc::IPCStatus::Ok);
+  const auto slow_id = server.last_sender();
+
+  // Timed sends give up once its socket buffers are full, keeping it
+  memset(msg.data, 'x', sizeof(msg.data));
+  ipc::IPCStatus status = ipc::IPCStatus::Ok;
+  for (int i = 0; i < 1000000 && status == ipc::IPCStatus::Ok; ++i)
+    status = server.send_to(slow_id, msg, std::chrono::nanoseconds::zero());
+  ASSERT_EQ(status, ipc::IPCStatus::Timeout);
+  ASSERT_EQ(server.client_count(), 1u);
+
+  // A broadcast drops it instead of waiting, and still reaches the others
+  ipc::TCPSocketTransport fast;
+  ASSERT_TRUE(fast.initialize(addr, false));
+  ASSERT_TRUE(fast.send_message(msg));
+  ASSERT_EQ(server.receive_for(msg, std::chrono::seconds(1)),
+            ipc::IPCStatus::Ok);
+  server.set_broadcast_timeout(std::chrono::milliseconds(50));
+  msg.counter = 7;
+  ASSERT_EQ(server.broadcast(msg), 1u);
+  ASSERT_EQ(server.client_count(), 1u);
+  ASSERT_EQ(fast.receive_for(msg, std::chrono::seconds(1)),
+            ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 7u);
+  ASSERT_EQ(server.send_to(slow_id, msg), ipc::IPCStatus::Error);
+}
+
+TEST(IPC_TCPPayload, CopyZeroCopyAndSendfile) {
+  const std::string addr = "127.0.0.1:54327";
+  const size_t small = 1000, large = 4 << 20, file_size = 1 << 20;
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0) << "fork failed";
+
+  if (pid == 0) {
+    // Child process - client: check each payload, then report
+    ipc::TCPSocketTransport client;
+    if (!client.initialize(addr, false))
+      _exit(1);
+    std::vector<char> payload;
+    if (!client.receive(payload) || payload != make_payload(small))
+      _exit(2);
+    if (!client.receive(payload) || payload != make_payload(large))
+      _exit(3);
+    if (!client.receive(payload) || payload != make_payload(file_size))
+      _exit(4);
+    ipc::IPCMessage done{};
+    done.finished = true;
+    _exit(client.send_message(done) ? 0 : 5);
+  }
+
+  // Parent process - server
+  ipc::TCPSocketTransport server;
+  ASSERT_TRUE(server.initialize(addr, true));
+
+  const auto small_payload = make_payload(small);
+  ASSERT_TRUE(server.send(small_payload.data(), small_payload.size()));
+  ASSERT_EQ(server.zerocopy_stats().sends, 0u);
+
+  const auto large_payload = make_payload(large);
+  ASSERT_TRUE(server.send(large_payload.data(), large_payload.size()));
+  const ipc::ZeroCopyStats &stats = server.zerocopy_stats();
+  std::cout << "[Parent] zero-copy sends: " << stats.sends
+            << ", copied by the kernel: " << stats.copied << std::endl;
+  ASSERT_EQ(stats.completed, stats.sends);
+
+  char path[] = "/tmp/test_ipc_sendfile_XXXXXX";
+  const int file_fd = mkstemp(path);
+  ASSERT_NE(file_fd, -1);
+  unlink(path);
+  const auto file_payload = make_payload(file_size);
+  ASSERT_EQ(write(file_fd, "head", 4), 4);
+  ASSERT_EQ(write(file_fd, file_payload.data(), file_size),
+            static_cast<ssize_t>(file_size));
+  ASSERT_TRUE(server.send_file(file_fd, 4, file_size));
+  close(file_fd);
+
+  ipc::IPCMessage done{};
+  ASSERT_TRUE(server.receive_message(done));
+  ASSERT_TRUE(done.finished);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  server.cleanup();
+}
@@ -0,0 +1,176 @@
+#include <Deadline.hpp>
+#include <IIPCTransport.hpp>
+#include <IPCTransportFactory.hpp>
+#include <PipeTransport.hpp>
+#include <SharedMemoryTransport.hpp>
+#include <ShmQueueTransport.hpp>
+#include <chrono>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <mqueue.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/*! @brief Returns how long `fn` took to run. */
+template <typename Fn> std::chrono::nanoseconds elapsed(Fn &&fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::steady_clock::now() - start;
+}
+
+} // namespace
+
+TEST(IPC_Timeouts, SharedMemoryRing) {
+  const ipc::WaitStrategy strategies[] = {
+      ipc::WaitStrategy::Spin, ipc::WaitStrategy::Yield,
+      ipc::WaitStrategy::Futex, ipc::WaitStrategy::CondVar};
+
+  for (ipc::WaitStrategy strategy : strategies) {
+    const std::string ring_name = "test_ipc_timeouts_ring";
+    ipc::SharedMemoryTransport creator(ipc::SharedMemoryMode::Ring, 4,
+                                       strategy);
+    ASSERT_TRUE(creator.initialize(ring_name, true));
+    ipc::SharedMemoryTransport opener(ipc::SharedMemoryMode::Ring, 4,
+                                      strategy);
+    ASSERT_TRUE(opener.initialize(ring_name, false));
+
+    // Nothing pending: try fails at once, the timed call waits its timeout
+    ipc::IPCMessage msg{};
+    ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+    ipc::IPCStatus status = ipc::IPCStatus::Ok;
+    const auto waited =
+        elapsed([&] { status = opener.receive_for(msg, 20ms); });
+    ASSERT_EQ(status, ipc::IPCStatus::Timeout);
+    ASSERT_GE(waited, 20ms);
+
+    // Fill the ring, then the next send would block
+    for (uint32_t i = 0; i < 4; ++i) {
+      msg.counter = i;
+      ASSERT_EQ(creator.try_send(msg), ipc::IPCStatus::Ok);
+    }
+    ASSERT_EQ(creator.try_send(msg), ipc::IPCStatus::WouldBlock);
+    ASSERT_EQ(creator.send_for(msg, 5ms), ipc::IPCStatus::Timeout);
+
+    for (uint32_t i = 0; i < 4; ++i) {
+      ASSERT_EQ(opener.receive_for(msg, 1s), ipc::IPCStatus::Ok);
+      ASSERT_EQ(msg.counter, i);
+    }
+  }
+}
+
+TEST(IPC_Timeouts, SharedMemorySingleSlot) {
+  const std::string shm_name = "test_ipc_timeouts_slot";
+  ipc::SharedMemoryTransport creator;
+  ASSERT_TRUE(creator.initialize(shm_name, true));
+  ipc::SharedMemoryTransport opener;
+  ASSERT_TRUE(opener.initialize(shm_name, false));
+
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(opener.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  msg.counter = 3;
+  ASSERT_EQ(creator.try_send(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(creator.send_for(msg, 5ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(opener.receive_for(msg, 1s), ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 3u);
+}
+
+TEST(IPC_Timeouts, ShmQueue) {
+  ipc::ShmQueueTransport queue(2);
+  ASSERT_TRUE(queue.initialize("test_ipc_timeouts_queue", true));
+
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(queue.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_EQ(queue.try_send(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(queue.try_send(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(queue.send_for(msg, 5ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(queue.try_receive(msg), ipc::IPCStatus::Ok);
+}
+
+TEST(IPC_Timeouts, MessageQueue) {
+  const std::string base = "/test_ipc_timeouts_mq";
+  mq_attr attr{};
+  attr.mq_maxmsg = 1;
+  attr.mq_msgsize = sizeof(ipc::IPCMessage);
+  for (const char *suffix : {"_ctp", "_ptc"}) {
+    mq_unlink((base + suffix).c_str());
+    mqd_t mq = mq_open((base + suffix).c_str(), O_CREAT | O_RDWR, 0666, &attr);
+    ASSERT_NE(mq, (mqd_t)-1);
+    mq_close(mq);
+  }
+
+  auto parent = IPCTransportFactory::create_transport(IPCType::MessageQueue);
+  ASSERT_TRUE(parent->initialize(base, true));
+  auto child = IPCTransportFactory::create_transport(IPCType::MessageQueue);
+  ASSERT_TRUE(child->initialize(base, false));
+
+  ipc::IPCMessage msg{};
+  ASSERT_EQ(child->try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_EQ(child->receive_for(msg, 10ms), ipc::IPCStatus::Timeout);
+  msg.counter = 9;
+  ASSERT_EQ(parent->try_send(msg), ipc::IPCStatus::Ok);
+  ASSERT_EQ(parent->send_for(msg, 5ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(child->receive_for(msg, 1s), ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 9u);
+}
+
+namespace {
+
+/*!
+ * @brief Checks try and timed receives on a pipe whose peer answers late.
+ */
+void run_pipe_timeouts(ipc::IOBackend backend, const std::string &ipc_name) {
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+
+  if (pid == 0) {
+    // Child process: answer after a delay longer than the first timeout
+    ipc::PipeTransport transport(backend);
+    if (!transport.initialize(ipc_name, false))
+      _exit(1);
+    ipc::IPCMessage msg{};
+    if (!transport.receive_message(msg))
+      _exit(2);
+    usleep(50 * 1000);
+    msg.counter++;
+    _exit(transport.send_message(msg) ? 0 : 3);
+  }
+
+  ipc::PipeTransport transport(backend);
+  ASSERT_TRUE(transport.initialize(ipc_name, true));
+
+  ipc::IPCMessage msg{};
+  msg.counter = 1;
+  ASSERT_TRUE(transport.send_message(msg));
+  ASSERT_EQ(transport.try_receive(msg), ipc::IPCStatus::WouldBlock);
+  ASSERT_EQ(transport.receive_for(msg, 5ms), ipc::IPCStatus::Timeout);
+  ASSERT_EQ(transport.receive_for(msg, 5s), ipc::IPCStatus::Ok);
+  ASSERT_EQ(msg.counter, 2u);
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+  transport.cleanup();
+}
+
+} // namespace
+
+TEST(IPC_Timeouts, Pipe) {
+  run_pipe_timeouts(ipc::IOBackend::Syscalls, "test_ipc_timeouts_pipe");
+}
+
+TEST(IPC_Timeouts, PipeIoUring) {
+  run_pipe_timeouts(ipc::IOBackend::IoUring, "test_ipc_timeouts_pipe_uring");
+}
+
+TEST(IPC_Timeouts, DeadlineSaturates) {
+  // Timeouts too large to add to the clock behave like never()
+  EXPECT_TRUE(ipc::Deadline(std::chrono::nanoseconds::max()).is_never());
+  EXPECT_FALSE(ipc::Deadline(1h).is_never());
+  EXPECT_FALSE(ipc::Deadline(1h).expired());
+  EXPECT_TRUE(ipc::Deadline(-1s).expired());
+}
@@ -0,0 +1,147 @@
+#include <WireFormat.hpp>
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+
+TEST(IPC_WireFormat, FrameRoundTrip) {
+  ipc::IPCMessage msg{};
+  msg.counter = 0xdeadbeef;
+  msg.finished = true;
+  strcpy(msg.data, "short payload");
+
+  // Bytes on the wire follow the payload, not sizeof(IPCMessage)
+  char frame[ipc::MAX_FRAME_SIZE];
+  const size_t length = ipc::encode_frame(msg, frame);
+  ASSERT_EQ(length, ipc::FRAME_HEADER_SIZE + strlen(msg.data));
+
+  ipc::IPCMessage decoded{};
+  memset(decoded.data, 'x', sizeof(decoded.data));
+  ASSERT_TRUE(ipc::decode_frame(frame, length, decoded));
+  ASSERT_EQ(decoded.counter, msg.counter);
+  ASSERT_FALSE(decoded.ready);
+  ASSERT_TRUE(decoded.finished);
+  ASSERT_EQ(memcmp(decoded.data, msg.data, sizeof(msg.data)), 0);
+  ASSERT_FALSE(ipc::decode_frame(frame, length - 1, decoded));
+
+  // A channel adds FRAME_CHANNEL_SIZE bytes to the header, none to the data
+  msg.channel = 0x01020304;
+  const size_t channel_length = ipc::encode_frame(msg, frame);
+  ASSERT_EQ(channel_length, length + ipc::FRAME_CHANNEL_SIZE);
+  ASSERT_TRUE(ipc::decode_frame(frame, channel_length, decoded));
+  ASSERT_EQ(decoded.channel, msg.channel);
+  ASSERT_EQ(memcmp(decoded.data, msg.data, sizeof(msg.data)), 0);
+
+  // A stream of frames split at arbitrary points is reassembled
+  std::string stream;
+  for (uint32_t i = 0; i < 100; ++i) {
+    msg.counter = i;
+    msg.channel = i % 3;
+    memset(msg.data, 0, sizeof(msg.data));
+    memset(msg.data, 'a' + i % 26, i % 40);
+    stream.append(frame, ipc::encode_frame(msg, frame));
+  }
+
+  size_t offset = 0;
+  ipc::FrameReader reader;
+  auto read_some = [&](char *buffer, size_t size) -> ssize_t {
+    const size_t chunk = std::min({size, stream.size() - offset, size_t{7}});
+    memcpy(buffer, stream.data() + offset, chunk);
+    offset += chunk;
+    return static_cast<ssize_t>(chunk);
+  };
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(reader.next(decoded, read_some));
+    ASSERT_EQ(decoded.counter, i);
+    ASSERT_EQ(decoded.channel, i % 3);
+    ASSERT_EQ(strlen(decoded.data), i % 40);
+  }
+  ASSERT_FALSE(reader.next(decoded, read_some));
+  ASSERT_FALSE(reader.is_broken());
+
+  // A length beyond MAX_FRAME_PAYLOAD breaks the stream
+  ipc::FrameHeader header;
+  header.type = static_cast<uint8_t>(ipc::FrameType::Message);
+  header.length = ipc::MAX_FRAME_PAYLOAD + 1;
+  ipc::encode_frame_header(header, frame);
+  stream.append(frame, ipc::FRAME_HEADER_SIZE);
+  ASSERT_FALSE(reader.next(decoded, read_some));
+  ASSERT_TRUE(reader.is_broken());
+}
+
+TEST(IPC_WireFormat, PayloadFrames) {
+  char prefix[ipc::PAYLOAD_PREFIX_SIZE];
+  uint64_t size = 0;
+  ipc::encode_payload_prefix(0x123456789aull, prefix);
+  ASSERT_TRUE(ipc::decode_payload_prefix(prefix, size));
+  ASSERT_EQ(size, 0x123456789aull);
+
+  // Payloads and message frames can share a stream
+  ipc::IPCMessage msg{};
+  char frame[ipc::MAX_FRAME_SIZE];
+  std::string payload(100000, '\0');
+  for (size_t i = 0; i < payload.size(); ++i)
+    payload[i] = static_cast<char>(i * 7);
+
+  std::string stream;
+  msg.counter = 1;
+  stream.append(frame, ipc::encode_frame(msg, frame));
+  ipc::encode_payload_prefix(payload.size(), prefix);
+  stream.append(prefix, sizeof(prefix));
+  stream.append(payload);
+  msg.counter = 2;
+  stream.append(frame, ipc::encode_frame(msg, frame));
+
+  size_t offset = 0;
+  ipc::FrameReader reader;
+  auto read_some = [&](char *buffer, size_t length) -> ssize_t {
+    const size_t chunk = std::min({length, stream.size() - offset,
+                                   size_t{3000}});
+    memcpy(buffer, stream.data() + offset, chunk);
+    offset += chunk;
+    return static_cast<ssize_t>(chunk);
+  };
+
+  ipc::IPCMessage decoded{};
+  ASSERT_TRUE(reader.next(decoded, read_some));
+  ASSERT_EQ(decoded.counter, 1u);
+  ASSERT_TRUE(reader.read(prefix, sizeof(prefix), read_some));
+  ASSERT_TRUE(ipc::decode_payload_prefix(prefix, size));
+  ASSERT_EQ(size, payload.size());
+  std::string received(size, '\0');
+  ASSERT_TRUE(reader.read(&received[0], size, read_some));
+  ASSERT_EQ(received, payload);
+  ASSERT_TRUE(reader.next(decoded, read_some));
+  ASSERT_EQ(decoded.counter, 2u);
+
+  // A message frame is not a payload prefix
+  ipc::encode_frame(msg, frame);
+  ASSERT_FALSE(ipc::decode_payload_prefix(frame, size));
+
+  // Reading a payload as a message breaks the stream instead of decoding
+  // its prefix as a message
+  offset = 0;
+  reader.reset();
+  ASSERT_TRUE(reader.next(decoded, read_some));
+  ASSERT_FALSE(reader.next(decoded, read_some));
+  ASSERT_TRUE(reader.is_broken());
+  ASSERT_FALSE(reader.next(decoded, read_some));
+  reader.reset();
+  ASSERT_FALSE(reader.is_broken());
+}
+
+TEST(IPC_WireFormat, ReferenceFrames) {
+  char frame[ipc::REFERENCE_FRAME_SIZE];
+  uint32_t segment = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  ipc::encode_reference_frame(3, 0x1122334455ull, 0x66778899aaull, frame);
+  ASSERT_TRUE(ipc::decode_reference_frame(frame, segment, offset, size));
+  ASSERT_EQ(segment, 3u);
+  ASSERT_EQ(offset, 0x1122334455ull);
+  ASSERT_EQ(size, 0x66778899aaull);
+
+  // References and payload prefixes are told apart by their frame type
+  ASSERT_FALSE(ipc::decode_payload_prefix(frame, size));
+  ipc::encode_payload_prefix(size, frame);
+  ASSERT_FALSE(ipc::decode_reference_frame(frame, segment, offset, size));
+}